@@ -0,0 +1,23 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include "bench_helper.hpp"
+#include "view/danmaku_core.hpp"
+
+/// 解析 xml 弹幕，与加载视频弹幕时的流程相同
+static void BM_DanmakuDecodeXML(benchmark::State& state) {
+    std::string content = loadFixture("danmaku.xml");
+    BENCH_REQUIRE(state, content, "danmaku.xml");
+
+    size_t count = 0;
+    for (auto _ : state) {
+        auto items = DanmakuCore::decodeXML(content);
+        count      = items.size();
+        benchmark::DoNotOptimize(items.data());
+    }
+    state.counters["items"] = (double)count;
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * content.size());
+}
+BENCHMARK(BM_DanmakuDecodeXML)->Unit(benchmark::kMillisecond);
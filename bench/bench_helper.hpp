@@ -0,0 +1,37 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <benchmark/benchmark.h>
+
+/// 读取 bench/fixtures 下的测试数据，文件不存在时返回空字符串
+inline std::string loadFixture(const std::string& name) {
+    std::ifstream file(std::string(BENCH_FIXTURE_DIR) + "/" + name,
+                       std::ios::binary);
+    if (!file) return "";
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+/// 读取 resources 下的文件
+inline std::string loadResource(const std::string& name) {
+    std::ifstream file(std::string(BENCH_RESOURCES_DIR) + "/" + name,
+                       std::ios::binary);
+    if (!file) return "";
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+/// 数据缺失时跳过当前测试
+#define BENCH_REQUIRE(state, data, name)                              \
+    if ((data).empty()) {                                             \
+        (state).SkipWithError((std::string("missing ") + name).c_str()); \
+        return;                                                       \
+    }
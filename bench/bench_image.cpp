@@ -0,0 +1,28 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include "bench_helper.hpp"
+#include "utils/image_helper.hpp"
+
+/// 解码图片为 RGBA，与图片下载后在工作线程中的流程相同
+static void BM_ImageDecode(benchmark::State& state, const char* name) {
+    std::string data = loadResource(name);
+    BENCH_REQUIRE(state, data, name);
+
+    for (auto _ : state) {
+        int width = 0, height = 0;
+        uint8_t* image = ImageHelper::decodeImage(data, false, &width, &height);
+        if (!image) {
+            state.SkipWithError("failed to decode image");
+            return;
+        }
+        benchmark::DoNotOptimize(image);
+        ImageHelper::freeImage(image, false);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK_CAPTURE(BM_ImageDecode, jpg, "icon/icon.jpg")
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ImageDecode, png, "pictures/hint_game_1.png")
+    ->Unit(benchmark::kMicrosecond);
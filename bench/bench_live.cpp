@@ -0,0 +1,65 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <zlib.h>
+#include <nlohmann/json.hpp>
+
+#include "bench_helper.hpp"
+#include "live/ws_utils.hpp"
+#include "live/extract_messages.hpp"
+
+/// 将测试数据编码为一个 zlib 压缩的通知包，与直播弹幕服务器下发的格式相同
+static std::vector<uint8_t> buildPacket(const std::string& fixture) {
+    std::vector<uint8_t> plain;
+    for (auto& i : nlohmann::json::parse(fixture)) {
+        auto packet = encode_packet(0, 5, i.dump());
+        plain.insert(plain.end(), packet.begin(), packet.end());
+    }
+
+    uLongf size = compressBound(plain.size());
+    std::string compressed(size, '\0');
+    compress2((Bytef*)compressed.data(), &size, plain.data(), plain.size(),
+              Z_DEFAULT_COMPRESSION);
+    compressed.resize(size);
+    return encode_packet(2, 5, compressed);
+}
+
+static void freeMessages(const std::vector<live_t>& messages) {
+    for (auto& i : messages) {
+        if (!i.ptr) continue;
+        if (i.type == danmaku) danmaku_t_free((danmaku_t*)i.ptr);
+        free(i.ptr);
+    }
+}
+
+/// 解压并拆分数据包
+static void BM_LiveParsePacket(benchmark::State& state) {
+    std::string fixture = loadFixture("live_messages.json");
+    BENCH_REQUIRE(state, fixture, "live_messages.json");
+    auto packet = buildPacket(fixture);
+
+    for (auto _ : state) {
+        auto messages = parse_packet(packet);
+        benchmark::DoNotOptimize(messages.data());
+    }
+    state.SetBytesProcessed(state.iterations() * packet.size());
+}
+BENCHMARK(BM_LiveParsePacket)->Unit(benchmark::kMicrosecond);
+
+/// 解析 JSON 消息
+static void BM_LiveExtractMessages(benchmark::State& state) {
+    std::string fixture = loadFixture("live_messages.json");
+    BENCH_REQUIRE(state, fixture, "live_messages.json");
+    auto messages = parse_packet(buildPacket(fixture));
+
+    for (auto _ : state) {
+        auto res = extract_messages(messages);
+        benchmark::DoNotOptimize(res.data());
+        state.PauseTiming();
+        freeMessages(res);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * messages.size());
+}
+BENCHMARK(BM_LiveExtractMessages)->Unit(benchmark::kMicrosecond);
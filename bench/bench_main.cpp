@@ -0,0 +1,8 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <benchmark/benchmark.h>
+
+// 输出 JSON: wiliwili_bench --benchmark_format=json --benchmark_out=bench.json
+BENCHMARK_MAIN();
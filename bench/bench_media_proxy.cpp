@@ -0,0 +1,166 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <map>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <filesystem>
+#include <mongoose.h>
+#include <cpr/cpr.h>
+
+#include "bench_helper.hpp"
+#include "utils/media_proxy.hpp"
+
+/// 模拟源站的文件大小
+#define ORIGIN_SIZE (8 * 1024 * 1024)
+/// 模拟源站单个连接的速度限制 (Bps)
+#define ORIGIN_RATE (8 * 1024 * 1024)
+#define ORIGIN_PORT 19860
+
+/**
+ * 本地限速的源站，支持范围请求
+ * 单个连接的速度有上限，用来对比单连接与多连接回源的耗时
+ */
+class ThrottledOrigin {
+public:
+    ThrottledOrigin() {
+        std::mt19937 rand(2233);
+        data.resize(ORIGIN_SIZE);
+        for (auto& i : data) i = (char)rand();
+
+        mg_mgr_init(&mgr);
+        std::string url = "http://127.0.0.1:" + std::to_string(ORIGIN_PORT);
+        ready = mg_http_listen(&mgr, url.c_str(), eventHandler, this) != nullptr;
+        thread = std::thread([this]() {
+            while (running) mg_mgr_poll(&mgr, 1);
+        });
+    }
+
+    ~ThrottledOrigin() {
+        running = false;
+        thread.join();
+        mg_mgr_free(&mgr);
+    }
+
+    std::string getUrl() const {
+        return "http://127.0.0.1:" + std::to_string(ORIGIN_PORT) +
+               "/upgcxcode/00/00/0/0-1-30080.m4s";
+    }
+
+    bool ready = false;
+
+private:
+    struct Transfer {
+        size_t pos, end;
+        std::chrono::steady_clock::time_point last;
+    };
+
+    std::string data;
+    mg_mgr mgr{};
+    std::thread thread;
+    std::atomic_bool running{true};
+    /// connection id -> 正在发送的范围
+    std::map<unsigned long, Transfer> transfers;
+
+    static void eventHandler(mg_connection* c, int ev, void* ev_data,
+                             void* fn_data) {
+        auto* self = (ThrottledOrigin*)fn_data;
+        if (ev == MG_EV_HTTP_MSG) {
+            self->onRequest(c, (mg_http_message*)ev_data);
+        } else if (ev == MG_EV_POLL) {
+            self->onPoll(c);
+        } else if (ev == MG_EV_CLOSE) {
+            self->transfers.erase(c->id);
+        }
+    }
+
+    void onRequest(mg_connection* c, mg_http_message* hm) {
+        size_t start = 0, end = data.size() - 1;
+        struct mg_str* range = mg_http_get_header(hm, "Range");
+        if (range) {
+            std::string value(range->ptr, range->len);
+            auto pos  = value.find('=');
+            auto dash = value.find('-', pos);
+            start     = std::strtoull(value.c_str() + pos + 1, nullptr, 10);
+            if (dash + 1 < value.size())
+                end = std::min(end, (size_t)std::strtoull(
+                                        value.c_str() + dash + 1, nullptr, 10));
+        }
+        if (start > end) {
+            mg_http_reply(c, 416, "", "");
+            return;
+        }
+        mg_printf(c,
+                  "HTTP/1.1 206 Partial Content\r\n"
+                  "Content-Range: bytes %llu-%llu/%llu\r\n"
+                  "Content-Length: %llu\r\n\r\n",
+                  (unsigned long long)start, (unsigned long long)end,
+                  (unsigned long long)data.size(),
+                  (unsigned long long)(end - start + 1));
+        transfers[c->id] = {start, end, std::chrono::steady_clock::now()};
+    }
+
+    void onPoll(mg_connection* c) {
+        auto it = transfers.find(c->id);
+        if (it == transfers.end()) return;
+        auto& t  = it->second;
+        auto now = std::chrono::steady_clock::now();
+        size_t quota =
+            (size_t)(std::chrono::duration<double>(now - t.last).count() *
+                     ORIGIN_RATE);
+        if (quota == 0 || c->send.len > 256 * 1024) return;
+        t.last     = now;
+        size_t len = std::min(quota, t.end - t.pos + 1);
+        mg_send(c, data.data() + t.pos, len);
+        t.pos += len;
+        if (t.pos > t.end) {
+            c->is_draining = 1;
+            transfers.erase(it);
+        }
+    }
+};
+
+/**
+ * 通过缓存代理读取整个文件，每次迭代前清空缓存，全部数据都需要回源获取
+ * 使用临时目录中的独立缓存，不改动配置目录下用户的媒体缓存
+ */
+static void BM_MediaProxyFetch(benchmark::State& state) {
+    static ThrottledOrigin origin;
+    if (!origin.ready) {
+        state.SkipWithError("failed to start origin server");
+        return;
+    }
+
+    auto dir = std::filesystem::temp_directory_path() / "wiliwili_bench_cache";
+    MediaProxy proxy(dir.string());
+    proxy.setCapacity(64);
+    MediaProxy::CONNECTIONS = (int)state.range(0);
+    std::string url         = proxy.getProxyUrl(origin.getUrl());
+    if (url == origin.getUrl()) {
+        state.SkipWithError("failed to start media proxy");
+        return;
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        proxy.clearCache();
+        state.ResumeTiming();
+
+        auto r = cpr::Get(cpr::Url{url});
+        if (r.status_code != 200 || r.text.size() != ORIGIN_SIZE) {
+            state.SkipWithError("unexpected response from media proxy");
+            break;
+        }
+    }
+    proxy.clearCache();
+    state.SetBytesProcessed(state.iterations() * ORIGIN_SIZE);
+}
+BENCHMARK(BM_MediaProxyFetch)
+    ->ArgName("connections")
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,58 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <borealis/views/label.hpp>
+
+#include "bench_helper.hpp"
+#include "view/danmaku_core.hpp"
+#include "utils/opencc_helper.hpp"
+
+/// 弹幕数量，重复使用 danmaku.xml 中的弹幕，与热门视频中大量重复的弹幕相近
+static constexpr size_t DANMAKU_COUNT = 20000;
+
+static std::vector<DanmakuItem> loadDanmaku() {
+    auto items = DanmakuCore::decodeXML(loadFixture("danmaku.xml"));
+    if (items.empty()) return items;
+    std::vector<DanmakuItem> res;
+    res.reserve(DANMAKU_COUNT);
+    while (res.size() < DANMAKU_COUNT)
+        res.push_back(items[res.size() % items.size()]);
+    return res;
+}
+
+/**
+ * 开启简繁转换时加载 2 万条弹幕，使用 OpenCC 实际转换
+ * 0: 逐条调用 STConverter (旧实现)
+ * 1: 通过 OpenCCHelper 的缓存转换，每次迭代前清空缓存
+ */
+static void BM_DanmakuOpenCC(benchmark::State& state) {
+#ifdef OPENCC
+    auto danmaku = loadDanmaku();
+    BENCH_REQUIRE(state, danmaku, "danmaku.xml");
+
+    auto& helper = OpenCCHelper::instance();
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto items = danmaku;
+        helper.clear();
+        state.ResumeTiming();
+
+        if (state.range(0) == 0) {
+            for (auto& i : items) i.msg = brls::Label::STConverter(i.msg);
+        } else {
+            for (auto& i : items) i.msg = helper.convertCached(i.msg);
+        }
+        benchmark::DoNotOptimize(items.data());
+    }
+    helper.clear();
+    state.SetItemsProcessed(state.iterations() * danmaku.size());
+#else
+    state.SkipWithError("built without OpenCC");
+#endif
+}
+BENCHMARK(BM_DanmakuOpenCC)
+    ->ArgName("cached")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
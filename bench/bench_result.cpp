@@ -0,0 +1,97 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+
+#include "bench_helper.hpp"
+#include "presenter/presenter.h"
+#include "bilibili/result/home_result.h"
+#include "bilibili/result/video_detail_result.h"
+
+/// 统计堆内存分配次数
+static std::atomic<size_t> ALLOC_COUNT{0};
+
+void* operator new(size_t size) {
+    ALLOC_COUNT.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+/// 解析接口返回的 JSON 并转换为对应的数据结构，与 HTTP::getResultAsync 中的流程相同
+template <typename T>
+static void deserialize(benchmark::State& state, const char* name) {
+    std::string content = loadFixture(name);
+    BENCH_REQUIRE(state, content, name);
+
+    size_t allocs = 0;
+    for (auto _ : state) {
+        size_t start = ALLOC_COUNT;
+        auto res     = nlohmann::json::parse(content).get<T>();
+        allocs       = ALLOC_COUNT - start;
+        benchmark::DoNotOptimize(&res);
+    }
+    state.counters["allocs"] = (double)allocs;
+    state.SetBytesProcessed(state.iterations() * content.size());
+}
+
+static void BM_DeserializeRecommend(benchmark::State& state) {
+    deserialize<bilibili::RecommendVideoListResultWrapper>(
+        state, "home_recommend.json");
+}
+BENCHMARK(BM_DeserializeRecommend)->Unit(benchmark::kMicrosecond);
+
+static void BM_DeserializeVideoDetail(benchmark::State& state) {
+    deserialize<bilibili::VideoDetailResult>(state, "video_detail.json");
+}
+BENCHMARK(BM_DeserializeVideoDetail)->Unit(benchmark::kMicrosecond);
+
+static void BM_DeserializeComment(benchmark::State& state) {
+    deserialize<bilibili::VideoCommentResultWrapper>(state,
+                                                     "video_comment.json");
+}
+BENCHMARK(BM_DeserializeComment)->Unit(benchmark::kMicrosecond);
+
+/**
+ * 将解析结果传递到主线程
+ * brls::sync 会复制一次回调函数，这里用复制 std::function 模拟
+ */
+template <bool SHARED>
+static void BM_ResultHandoff(benchmark::State& state) {
+    std::string content = loadFixture("video_comment.json");
+    BENCH_REQUIRE(state, content, "video_comment.json");
+    auto origin = nlohmann::json::parse(content)
+                      .get<bilibili::VideoCommentResultWrapper>();
+
+    size_t allocs = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto result = origin;
+        state.ResumeTiming();
+
+        size_t start = ALLOC_COUNT;
+        std::function<void()> callback;
+        if constexpr (SHARED) {
+            callback = [data = wiliwili::moveToShared(std::move(result))]() {
+                benchmark::DoNotOptimize(data->replies.size());
+            };
+        } else {
+            callback = [result]() {
+                benchmark::DoNotOptimize(result.replies.size());
+            };
+        }
+        std::function<void()> copy = callback;
+        copy();
+        allocs = ALLOC_COUNT - start;
+    }
+    state.counters["allocs"] = (double)allocs;
+}
+BENCHMARK_TEMPLATE(BM_ResultHandoff, false)->Name("BM_ResultHandoff/copy");
+BENCHMARK_TEMPLATE(BM_ResultHandoff, true)->Name("BM_ResultHandoff/shared");
@@ -0,0 +1,66 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include "bench_helper.hpp"
+#include "utils/number_helper.hpp"
+#include "utils/string_helper.hpp"
+#include "bilibili/util/http.hpp"
+
+static void BM_NumberFormat(benchmark::State& state) {
+    size_t i = 0;
+    for (auto _ : state) {
+        i = (i + 7919) % 100000000;
+        benchmark::DoNotOptimize(wiliwili::num2w(i));
+        benchmark::DoNotOptimize(wiliwili::sec2Time(i % 100000));
+        benchmark::DoNotOptimize(wiliwili::sec2MinSec(i % 10000));
+    }
+}
+BENCHMARK(BM_NumberFormat);
+
+static void BM_DateFormat(benchmark::State& state) {
+    time_t now = (time_t)wiliwili::getUnixTime();
+    time_t i   = 0;
+    for (auto _ : state) {
+        i = (i + 3607) % (86400 * 400);
+        benchmark::DoNotOptimize(wiliwili::sec2date(now - i));
+        benchmark::DoNotOptimize(wiliwili::sec2FullDate(now - i));
+    }
+}
+BENCHMARK(BM_DateFormat);
+
+static void BM_UrlEncode(benchmark::State& state) {
+    std::string text = "https://search.bilibili.com/all?keyword=前方高能 awsl&page=2";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(wiliwili::urlEncode(text));
+    }
+}
+BENCHMARK(BM_UrlEncode);
+
+static void BM_Base64(benchmark::State& state) {
+    std::string data = loadFixture("video_detail.json");
+    BENCH_REQUIRE(state, data, "video_detail.json");
+    std::string out;
+    for (auto _ : state) {
+        std::string encoded = wiliwili::base64Encode(data);
+        wiliwili::base64Decode(encoded, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_Base64);
+
+/// 需要签名的请求在发出前的参数处理
+static void BM_RequestSign(benchmark::State& state) {
+    for (auto _ : state) {
+        cpr::Parameters parameters{{"access_key", "0123456789abcdef"},
+                                   {"mobi_app", "android"},
+                                   {"platform", "android"},
+                                   {"keyword", "前方高能"},
+                                   {"pn", "1"},
+                                   {"ps", "20"}};
+        bilibili::HTTP::sign(parameters);
+        benchmark::DoNotOptimize(parameters);
+    }
+}
+BENCHMARK(BM_RequestSign);
@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+#
+# Generate the fixtures used by wiliwili_bench.
+# The payloads follow the fields read by the deserializers in
+# wiliwili/include/api/bilibili/result, the output is deterministic so that
+# benchmark results stay comparable between runs.
+#
+# usage: generate_fixtures.py [output dir]
+
+import os
+import sys
+import json
+import random
+
+rand = random.Random(2233)
+
+WORDS = [
+    "哈哈哈哈", "前方高能", "awsl", "2333", "泪目", "好耶", "来了来了", "名场面",
+    "下次一定", "这就是青春吗", "打卡", "爷青回", "太强了", "草", "？？？",
+    "经典永流传", "弹幕护体", "第一", "空降成功", "原来如此", "学到了",
+]
+
+NAMES = ["bilibili", "wiliwili", "xfangfang", "纸片人", "路人甲", "夜猫子",
+         "Switch玩家", "maye174", "三连了", "up主加油"]
+
+
+def text(n=1):
+    return "".join(rand.choice(WORDS) for _ in range(n))
+
+
+def face():
+    return "https://i0.hdslb.com/bfs/face/{:040x}.jpg".format(
+        rand.getrandbits(160))
+
+
+def cover():
+    return "https://i0.hdslb.com/bfs/archive/{:040x}.jpg".format(
+        rand.getrandbits(160))
+
+
+def bvid():
+    chars = "123456789abcdefghijkmnopqrstuvwxyzABCDEFGHJKLMNPQRSTUVWXYZ"
+    return "BV1" + "".join(rand.choice(chars) for _ in range(9))
+
+
+def danmaku_xml(count=3000):
+    lines = ['<?xml version="1.0" encoding="UTF-8"?>', "<i>",
+             "<chatserver>chat.bilibili.com</chatserver>",
+             "<chatid>1176840</chatid>", "<mission>0</mission>",
+             "<maxlimit>3000</maxlimit>", "<state>0</state>",
+             "<real_name>0</real_name>", "<source>k-v</source>"]
+    for i in range(count):
+        attrs = [
+            "{:.5f}".format(rand.uniform(0, 600)),
+            str(rand.choice([1, 1, 1, 1, 4, 5])),
+            str(rand.choice([25, 25, 25, 18, 36])),
+            str(rand.choice([16777215] * 6 + [16711680, 65280, 16776960])),
+            str(1600000000 + rand.randint(0, 80000000)),
+            "0",
+            "{:08x}".format(rand.getrandbits(32)),
+            str(rand.getrandbits(60)),
+            str(rand.randint(1, 11)),
+        ]
+        lines.append('<d p="{}">{}</d>'.format(",".join(attrs),
+                                                text(rand.randint(1, 3))))
+    lines.append("</i>")
+    return "\n".join(lines)
+
+
+def live_messages(count=500):
+    res = []
+    for i in range(count):
+        if i % 20 == 0:
+            num = rand.randint(1000, 100000)
+            res.append({"cmd": "WATCHED_CHANGE", "data": {
+                "num": num, "text_small": str(num),
+                "text_large": "{}人看过".format(num)}})
+            continue
+        uid = rand.randint(10000, 400000000)
+        info = [
+            [0, 1, 25, rand.choice([16777215, 16711680]),
+             1680000000000 + i, 1680000000, 0, "{:08x}".format(
+                 rand.getrandbits(32)), 0, 0, 0, "", 0, "{}", "{}"],
+            text(rand.randint(1, 2)),
+            [uid, rand.choice(NAMES), 0, 0, 0, 10000, 1, ""],
+            [rand.randint(1, 30), "粉丝牌", rand.choice(NAMES), 21452505,
+             6067854, "", 0, 6809855, 398668, 6850801, 0, 0, 686607],
+            [rand.randint(0, 60), 0, 6406234, ">50000", 0],
+            ["", ""], 0, rand.randint(0, 3), None,
+            {"ts": 1680000000, "ct": "{:08X}".format(rand.getrandbits(32))},
+            0, 0, None, None, 0, 105, [0],
+        ]
+        res.append({"cmd": "DANMU_MSG", "info": info})
+    return res
+
+
+def owner():
+    return {"mid": rand.randint(10000, 400000000), "name": rand.choice(NAMES),
+            "face": face()}
+
+
+def home_recommend(count=30):
+    items = []
+    for i in range(count):
+        items.append({
+            "id": rand.randint(10000000, 900000000), "bvid": bvid(),
+            "cid": rand.randint(10000000, 900000000), "goto": "av",
+            "uri": "http://www.bilibili.com/video/" + bvid(),
+            "pic": cover(), "title": text(4),
+            "duration": rand.randint(30, 7200),
+            "pubdate": 1600000000 + rand.randint(0, 80000000),
+            "owner": owner(),
+            "stat": {"view": rand.randint(0, 10000000),
+                     "like": rand.randint(0, 100000),
+                     "danmaku": rand.randint(0, 100000)},
+            "av_feature": None, "is_followed": 0,
+            "rcmd_reason": {"reason_type": rand.choice([0, 3]),
+                            "content": "百万播放"} if i % 3 else None,
+            "show_info": 1, "track_id": "", "pos": 0,
+        })
+    return {"item": items, "business_card": None, "floor_info": None,
+            "user_feature": None, "preload_expose_pct": 0.5,
+            "preload_floor_expose_pct": 0.5, "mid": 0}
+
+
+def video_detail(pages=60, episodes=80):
+    aid = rand.randint(10000000, 900000000)
+    episode_list = []
+    for i in range(episodes):
+        ep_aid = aid if i == episodes // 2 else rand.randint(10000000, 900000000)
+        episode_list.append({
+            "season_id": 1234, "section_id": 5678, "id": i + 1,
+            "aid": ep_aid, "cid": rand.randint(10000000, 900000000),
+            "title": text(3), "bvid": bvid(),
+            "page": {"cid": rand.randint(10000000, 900000000),
+                     "duration": rand.randint(60, 3600),
+                     "part": text(2), "page": 1},
+        })
+    return {
+        "bvid": bvid(), "aid": aid, "videos": pages, "tid": 17,
+        "tname": "单机游戏", "copyright": 1, "pic": cover(), "title": text(5),
+        "pubdate": 1680000000, "ctime": 1680000000, "desc": text(40),
+        "duration": rand.randint(600, 36000),
+        "rights": {"bp": 0, "elec": 0, "download": 1, "movie": 0, "pay": 0,
+                   "hd5": 1, "no_reprint": 1, "autoplay": 1, "ugc_pay": 0,
+                   "is_cooperation": 0, "ugc_pay_preview": 0},
+        "owner": owner(),
+        "stat": {"aid": aid, "view": rand.randint(0, 10000000),
+                 "danmaku": rand.randint(0, 100000),
+                 "reply": rand.randint(0, 100000),
+                 "favorite": rand.randint(0, 100000),
+                 "coin": rand.randint(0, 100000),
+                 "share": rand.randint(0, 100000), "now_rank": 0,
+                 "his_rank": 0, "like": rand.randint(0, 100000),
+                 "dislike": 0},
+        "pages": [{"cid": rand.randint(10000000, 900000000), "page": i + 1,
+                   "from": "vupload", "part": text(2),
+                   "duration": rand.randint(60, 3600), "vid": "",
+                   "weblink": "",
+                   "dimension": {"width": 1920, "height": 1080, "rotate": 0}}
+                  for i in range(pages)],
+        "ugc_season": {
+            "id": 1234, "title": text(2), "cover": cover(), "mid": 1,
+            "intro": text(6), "sign_state": 0, "attribute": 0,
+            "stat": {"season_id": 1234, "view": rand.randint(0, 1000000)},
+            "is_pay_season": False,
+            "sections": [{"season_id": 1234, "id": 5678, "title": "正片",
+                          "type": 1, "episodes": episode_list}],
+        },
+    }
+
+
+def comment(depth=0):
+    rpid = rand.getrandbits(40)
+    content = {"message": text(rand.randint(2, 12)), "members": [],
+               "max_line": 6}
+    if rand.random() < 0.3:
+        content["emote"] = {"[doge]": {
+            "id": 1, "text": "[doge]",
+            "url": "https://i0.hdslb.com/bfs/emote/doge.png",
+            "meta": {"size": 1}}}
+    if rand.random() < 0.1:
+        content["pictures"] = [{"img_src": cover(), "img_width": 1280,
+                                "img_height": 720, "img_size": 100.0}]
+    return {
+        "rpid": rpid, "oid": rand.randint(10000000, 900000000), "type": 1,
+        "mid": rand.randint(10000, 400000000),
+        "root": 0 if depth == 0 else rand.getrandbits(40),
+        "parent": 0 if depth == 0 else rand.getrandbits(40),
+        "dialog": 0, "count": 0, "rcount": rand.randint(0, 200), "state": 0,
+        "fansgrade": 0, "attr": 0, "ctime": 1680000000 + rand.randint(0, 10000000),
+        "like": rand.randint(0, 100000), "action": 0,
+        "member": {"mid": str(rand.randint(10000, 400000000)),
+                   "uname": rand.choice(NAMES), "sex": "保密", "sign": "",
+                   "avatar": face(), "rank": "10000",
+                   "is_senior_member": rand.randint(0, 1),
+                   "level_info": {"current_level": rand.randint(0, 6),
+                                  "current_min": 0, "current_exp": 0,
+                                  "next_exp": 0}},
+        "content": content,
+        "replies": None if depth else [comment(depth + 1)
+                                       for _ in range(rand.randint(0, 3))],
+        "reply_control": {"sub_reply_entry_text": "共3条回复",
+                          "time_desc": "1天前发布",
+                          "location": "IP属地：上海"},
+    }
+
+
+def video_comment(count=20):
+    return {
+        "cursor": {"all_count": 2000, "is_begin": True, "prev": 1, "next": 2,
+                   "is_end": False, "mode": 3, "show_type": 1,
+                   "name": "热门评论"},
+        "replies": [comment() for _ in range(count)],
+        "top_replies": [comment()],
+        "upper": {"mid": 1},
+    }
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(
+        os.path.abspath(__file__))
+    files = {
+        "danmaku.xml": danmaku_xml(),
+        "live_messages.json": live_messages(),
+        "home_recommend.json": home_recommend(),
+        "video_detail.json": video_detail(),
+        "video_comment.json": video_comment(),
+    }
+    for name, data in files.items():
+        with open(os.path.join(out, name), "w", encoding="utf-8") as f:
+            if isinstance(data, str):
+                f.write(data)
+            else:
+                json.dump(data, f, ensure_ascii=False, separators=(",", ":"))
+            f.write("\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+#
+# Compile resources/xml/**/*.xml into a compact binary description that is
+# linked into wiliwili, so that layouts can be built without reading and
+# parsing xml files at runtime. See wiliwili/source/utils/xml_layout.cpp.
+#
+# usage: compile_xml_layout.py <resources dir> <output cpp>
+#
+# Binary format (all integers are unsigned LEB128 varints):
+#   magic "WXL1"
+#   string count, then each string as (length, utf-8 bytes)
+#   file count, then each file as (path string id, root node)
+#   node: tag id, attribute count, (name id, value id) * count,
+#         text id + 1 (0 means no text), child count, child nodes
+#
+# Tag names, attribute names and values are interned in the string table,
+# so the loader resolves each of them only once.
+
+import os
+import sys
+import xml.parsers.expat
+
+
+class Node:
+    def __init__(self, tag, attrs):
+        self.tag = tag
+        self.attrs = attrs
+        self.text = ""
+        self.children = []
+
+
+def parse(path):
+    # expat without namespace processing keeps "brls:Box" as a plain name
+    parser = xml.parsers.expat.ParserCreate()
+    stack = []
+    root = []
+
+    def start(tag, attrs):
+        node = Node(tag, attrs)
+        if stack:
+            stack[-1].children.append(node)
+        else:
+            root.append(node)
+        stack.append(node)
+
+    def end(tag):
+        stack.pop()
+
+    def data(text):
+        if stack:
+            stack[-1].text += text
+
+    parser.ordered_attributes = True
+    parser.StartElementHandler = lambda tag, attrs: start(
+        tag, list(zip(attrs[0::2], attrs[1::2])))
+    parser.EndElementHandler = end
+    parser.CharacterDataHandler = data
+    with open(path, "rb") as f:
+        parser.ParseFile(f)
+    return root[0]
+
+
+class Writer:
+    def __init__(self):
+        self.strings = []
+        self.ids = {}
+        self.body = bytearray()
+
+    def intern(self, value):
+        if value not in self.ids:
+            self.ids[value] = len(self.strings)
+            self.strings.append(value)
+        return self.ids[value]
+
+    @staticmethod
+    def varint(out, value):
+        while True:
+            byte = value & 0x7F
+            value >>= 7
+            if value:
+                out.append(byte | 0x80)
+            else:
+                out.append(byte)
+                return
+
+    def node(self, node):
+        self.varint(self.body, self.intern(node.tag))
+        self.varint(self.body, len(node.attrs))
+        for name, value in node.attrs:
+            self.varint(self.body, self.intern(name))
+            self.varint(self.body, self.intern(value))
+        # tinyxml2 ignores whitespace-only text between elements
+        text = node.text if node.text.strip() else None
+        self.varint(self.body, 0 if text is None else self.intern(text) + 1)
+        self.varint(self.body, len(node.children))
+        for child in node.children:
+            self.node(child)
+
+    def build(self, files):
+        self.varint(self.body, len(files))
+        for name, root in files:
+            self.varint(self.body, self.intern(name))
+            self.node(root)
+
+        out = bytearray(b"WXL1")
+        self.varint(out, len(self.strings))
+        for s in self.strings:
+            data = s.encode("utf-8")
+            self.varint(out, len(data))
+            out += data
+        return bytes(out + self.body)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print("usage: compile_xml_layout.py <resources dir> <output cpp>")
+        return 1
+    resources, output = sys.argv[1], sys.argv[2]
+
+    files = []
+    for folder, _, names in os.walk(os.path.join(resources, "xml")):
+        for name in sorted(names):
+            if not name.endswith(".xml"):
+                continue
+            path = os.path.join(folder, name)
+            key = os.path.relpath(path, resources).replace(os.sep, "/")
+            try:
+                files.append((key, parse(path)))
+            except xml.parsers.expat.ExpatError as e:
+                print("compile_xml_layout: skip {}: {}".format(key, e))
+    files.sort(key=lambda i: i[0])
+    data = Writer().build(files)
+
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join(
+            "0x{:02x}".format(b) for b in data[i:i + 16]) + ",")
+    source = (
+        "// Generated by scripts/compile_xml_layout.py, do not edit.\n"
+        "// {} layouts, {} bytes\n\n"
+        "#include <cstddef>\n\n"
+        "extern const unsigned char XML_LAYOUT_DATA[];\n"
+        "extern const size_t XML_LAYOUT_SIZE;\n\n"
+        "const unsigned char XML_LAYOUT_DATA[] = {{\n{}\n}};\n"
+        "const size_t XML_LAYOUT_SIZE = sizeof(XML_LAYOUT_DATA);\n").format(
+            len(files), len(data), "\n".join(lines))
+
+    os.makedirs(os.path.dirname(os.path.abspath(output)), exist_ok=True)
+    with open(output, "w", encoding="utf-8") as f:
+        f.write(source)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -8,12 +8,13 @@
 #include <libpdr.h>
 
 #include "view/mpv_core.hpp"
+#include "utils/xml_layout.hpp"
 
 
 class VideoView;
 class DLNAActivity : public brls::Activity {
 public:
-    CONTENT_FROM_XML_RES("activity/video_activity.xml");
+    CONTENT_FROM_LAYOUT("activity/video_activity.xml");
 
     DLNAActivity();
 
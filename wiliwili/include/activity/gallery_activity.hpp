@@ -5,12 +5,13 @@
 #pragma once
 
 #include <borealis.hpp>
+#include "utils/xml_layout.hpp"
 
 class GalleryView;
 class GalleryActivity : public brls::Activity {
 public:
     // Declare that the content of this activity is the given XML file
-    CONTENT_FROM_XML_RES("activity/gallery_activity.xml");
+    CONTENT_FROM_LAYOUT("activity/gallery_activity.xml");
     explicit GalleryActivity(const std::vector<std::string>& data);
 
     bool isTranslucent() override;
@@ -5,13 +5,14 @@
 #pragma once
 
 #include "borealis.hpp"
+#include "utils/xml_layout.hpp"
 
 class GalleryView;
 
 class HintActivity : public brls::Activity {
 public:
     // Declare that the content of this activity is the given XML file
-    CONTENT_FROM_XML_RES("activity/hint_activity.xml");
+    CONTENT_FROM_LAYOUT("activity/hint_activity.xml");
 
     HintActivity();
 
@@ -5,6 +5,7 @@
 #pragma once
 #include "view/mpv_core.hpp"
 #include "presenter/live_data.hpp"
+#include "utils/xml_layout.hpp"
 
 #include <borealis.hpp>
 
@@ -13,7 +14,7 @@ class VideoView;
 class LiveActivity : public brls::Activity, public LiveDataRequest {
 public:
     // Declare that the content of this activity is the given XML file
-    CONTENT_FROM_XML_RES("activity/video_activity.xml");
+    CONTENT_FROM_LAYOUT("activity/video_activity.xml");
 
     explicit LiveActivity(const bilibili::LiveVideoResult& live);
     explicit LiveActivity(int roomid, const std::string& name = "",
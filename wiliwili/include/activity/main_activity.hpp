@@ -17,6 +17,7 @@
 #pragma once
 
 #include <borealis.hpp>
+#include "utils/xml_layout.hpp"
 
 class CustomButton;
 class AutoTabFrame;
@@ -24,7 +25,7 @@ class AutoTabFrame;
 class MainActivity : public brls::Activity {
 public:
     // Declare that the content of this activity is the given XML file
-    CONTENT_FROM_XML_RES("activity/main.xml");
+    CONTENT_FROM_LAYOUT("activity/main.xml");
 
     void onContentAvailable() override;
 
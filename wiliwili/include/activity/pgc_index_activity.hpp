@@ -7,6 +7,7 @@
 
 #include <borealis.hpp>
 #include "presenter/pgc_index.hpp"
+#include "utils/xml_layout.hpp"
 
 typedef brls::Event<UserRequestData> IndexChangeEvent;
 
@@ -15,7 +16,7 @@ class RecyclingGrid;
 class PGCIndexActivity : public brls::Activity, PGCIndexRequest {
 public:
     // Declare that the content of this activity is the given XML file
-    CONTENT_FROM_XML_RES("activity/pgc_index_activity.xml");
+    CONTENT_FROM_LAYOUT("activity/pgc_index_activity.xml");
 
     PGCIndexActivity(const std::string& url);
 
@@ -12,6 +12,7 @@
 #include "view/recycling_grid.hpp"
 #include "view/auto_tab_frame.hpp"
 #include "view/mpv_core.hpp"
+#include "utils/xml_layout.hpp"
 
 class VideoView;
 class UserInfoView;
@@ -24,7 +25,7 @@ using namespace brls::literals;
 
 class BasePlayerActivity : public brls::Activity, public VideoDetail {
 public:
-    CONTENT_FROM_XML_RES("activity/player_activity.xml");
+    CONTENT_FROM_LAYOUT("activity/player_activity.xml");
 
     BasePlayerActivity() = default;
 
@@ -59,6 +60,9 @@ public:
     // 切换评论模式
     void setCommentMode();
 
+    // 将当前视频加入离线缓存
+    void downloadVideo();
+
     // 设定当前的播放进度，获取视频链接后会自动跳转到该进度
     // 目前有两个使用场景：
     // 1. 从历史记录进入视频时
@@ -76,7 +80,8 @@ public:
     virtual void onIndexChangeToNext() = 0;
 
     // 上报播放进度
-    virtual void reportCurrentProgress(size_t progress, size_t duration) = 0;
+    virtual void reportCurrentProgress(size_t progress, size_t duration,
+                                       bool flush = true) = 0;
 
     // 获取当前视频的aid
     virtual size_t getAid() = 0;
@@ -126,6 +131,8 @@ protected:
 private:
     bool activityShown = false;
     std::chrono::system_clock::time_point videoDeadline{};
+    // 每次设置播放链接时递增，用于丢弃过期的镜像测速结果
+    size_t playUrlRequestId = 0;
 };
 
 class PlayerActivity : public BasePlayerActivity {
@@ -137,7 +144,8 @@ public:
     int getProgress() override;
     void onIndexChange(size_t index) override;
     void onIndexChangeToNext() override;
-    void reportCurrentProgress(size_t progress, size_t duration) override;
+    void reportCurrentProgress(size_t progress, size_t duration,
+                               bool flush = true) override;
     void requestCastUrl() override;
 
     void onVideoInfo(const bilibili::VideoDetailResult& result) override;
@@ -195,7 +203,8 @@ public:
 
     void onIndexChangeToNext() override;
 
-    void reportCurrentProgress(size_t progress, size_t duration) override;
+    void reportCurrentProgress(size_t progress, size_t duration,
+                               bool flush = true) override;
 
     void onCastPlayUrl(const bilibili::VideoUrlResult& result) override;
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <borealis.hpp>
+#include "utils/xml_layout.hpp"
 
 class SearchTab;
 
@@ -13,7 +14,7 @@ typedef brls::Event<std::string> UpdateSearchEvent;
 class SearchActivity : public brls::Activity {
 public:
     // Declare that the content of this activity is the given XML file
-    CONTENT_FROM_XML_RES("activity/search_activity.xml");
+    CONTENT_FROM_LAYOUT("activity/search_activity.xml");
 
     explicit SearchActivity(const std::string &key = "");
 
@@ -5,23 +5,30 @@
 #pragma once
 
 #include <borealis.hpp>
-#include "presenter/presenter.h"
+#include "presenter/search_suggest.hpp"
+#include "utils/xml_layout.hpp"
 
 class RecyclingGrid;
 class SearchHots;
 class SearchHistory;
 class SVGImage;
 
-class TVSearchActivity : public brls::Activity, public Presenter {
+class TVSearchActivity : public brls::Activity, public SearchSuggestRequest {
 public:
     // Declare that the content of this activity is the given XML file
-    CONTENT_FROM_XML_RES("activity/search_activity_tv.xml");
+    CONTENT_FROM_LAYOUT("activity/search_activity_tv.xml");
     TVSearchActivity();
 
     void onContentAvailable() override;
 
     void requestSearchSuggest();
 
+    void onSuggestList(const std::string& key,
+                       const std::vector<std::string>& list,
+                       bool remote) override;
+
+    void onSuggestError(const std::string& error) override;
+
     void updateInputLabel();
 
     void setCurrentSearch(const std::string& value);
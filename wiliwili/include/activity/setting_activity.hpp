@@ -5,6 +5,7 @@
 #pragma once
 
 #include <borealis.hpp>
+#include "utils/xml_layout.hpp"
 
 class TextBox;
 class SelectorCell;
@@ -12,7 +13,7 @@ class SelectorCell;
 class SettingActivity : public brls::Activity {
 public:
     // Declare that the content of this activity is the given XML file
-    CONTENT_FROM_XML_RES("activity/setting_activity.xml");
+    CONTENT_FROM_LAYOUT("activity/setting_activity.xml");
 
     SettingActivity();
 
@@ -32,6 +33,7 @@ private:
     BRLS_BIND(brls::RadioCell, btnQuit, "tools/quit");
     BRLS_BIND(brls::RadioCell, btnOpenConfig, "tools/config_dir");
     BRLS_BIND(brls::RadioCell, btnVibrationTest, "tools/vibration_test");
+    BRLS_BIND(brls::RadioCell, btnPerfTrace, "tools/perf_trace");
     BRLS_BIND(brls::RadioCell, btnDLNA, "tools/dlna");
     BRLS_BIND(SelectorCell, selectorLang, "setting/language");
     BRLS_BIND(SelectorCell, selectorTheme, "setting/ui/theme");
@@ -44,6 +46,9 @@ private:
     BRLS_BIND(brls::BooleanCell, btnQuality, "setting/video/quality");
     BRLS_BIND(brls::BooleanCell, btnHWDEC, "setting/video/hwdec");
     BRLS_BIND(SelectorCell, selectorInmemory, "setting/video/inmemory");
+    BRLS_BIND(SelectorCell, selectorMediaCache, "setting/video/media_cache");
+    BRLS_BIND(SelectorCell, selectorMediaConnections,
+              "setting/video/media_connections");
     BRLS_BIND(SelectorCell, selectorFormat, "setting/video/format");
     BRLS_BIND(SelectorCell, selectorCodec, "setting/video/codec");
     BRLS_BIND(SelectorCell, selectorQuality, "setting/audio/quality");
@@ -24,7 +24,8 @@ public:
 inline void to_json(nlohmann::json& nlohmann_json_j,
                     const DynamicVideoResult& nlohmann_json_t) {
     NLOHMANN_JSON_EXPAND(NLOHMANN_JSON_PASTE(NLOHMANN_JSON_TO, aid, bvid, pic,
-                                             title, duration, pubdate, stat));
+                                             title, duration, pubdate, owner,
+                                             stat));
 }
 inline void from_json(const nlohmann::json& nlohmann_json_j,
                       DynamicVideoResult& nlohmann_json_t) {
@@ -47,6 +47,11 @@ inline void from_json(const nlohmann::json& nlohmann_json_j,
         nlohmann_json_j.at("content").get_to(nlohmann_json_t.content);
     }
 }
+inline void to_json(nlohmann::json& nlohmann_json_j,
+                    const RecommendReasonResult& nlohmann_json_t) {
+    NLOHMANN_JSON_EXPAND(
+        NLOHMANN_JSON_PASTE(NLOHMANN_JSON_TO, content, reason_type));
+}
 
 class RecommendVideoResult {
 public:
@@ -72,6 +77,12 @@ inline void from_json(const nlohmann::json& nlohmann_json_j,
                                              pic, title, duration, pubdate,
                                              owner, stat, is_followed));
 }
+inline void to_json(nlohmann::json& nlohmann_json_j,
+                    const RecommendVideoResult& nlohmann_json_t) {
+    NLOHMANN_JSON_EXPAND(NLOHMANN_JSON_PASTE(
+        NLOHMANN_JSON_TO, id, bvid, cid, pic, title, duration, pubdate, owner,
+        stat, is_followed, rcmd_reason));
+}
 
 typedef std::vector<RecommendVideoResult> RecommendVideoListResult;
 
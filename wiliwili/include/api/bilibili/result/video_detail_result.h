@@ -581,14 +581,39 @@ inline void from_json(const nlohmann::json& nlohmann_json_j,
                                              accept_quality));
 }
 
+class SubtitleRow {
+public:
+    std::string content;
+    float length = -1;  // 在屏幕上渲染的宽度
+};
+
 class SubtitleLine {
 public:
     float from, to;
     int location;
     std::string content;
-    float length = -1;  // 字幕在屏幕上渲染的宽度
+    float length = -1;  // 字幕在屏幕上渲染的宽度，多行时为最宽一行的宽度
+    std::vector<SubtitleRow> rows;  // 按换行符拆分后的各行，在解析时生成
 };
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(SubtitleLine, from, to, location, content);
+inline void from_json(const nlohmann::json& nlohmann_json_j,
+                      SubtitleLine& nlohmann_json_t) {
+    NLOHMANN_JSON_EXPAND(NLOHMANN_JSON_PASTE(NLOHMANN_JSON_FROM, from, to,
+                                             location, content));
+    size_t start = 0;
+    while (start <= nlohmann_json_t.content.size()) {
+        size_t end = nlohmann_json_t.content.find('\n', start);
+        if (end == std::string::npos) end = nlohmann_json_t.content.size();
+        std::string row = nlohmann_json_t.content.substr(start, end - start);
+        if (!row.empty() && row.back() == '\r') row.pop_back();
+        if (!row.empty()) nlohmann_json_t.rows.push_back({row});
+        start = end + 1;
+    }
+}
+inline void to_json(nlohmann::json& nlohmann_json_j,
+                    const SubtitleLine& nlohmann_json_t) {
+    NLOHMANN_JSON_EXPAND(NLOHMANN_JSON_PASTE(NLOHMANN_JSON_TO, from, to,
+                                             location, content));
+}
 
 typedef std::vector<SubtitleLine> SubtitleBody;
 
@@ -611,6 +636,11 @@ inline void from_json(const nlohmann::json& nlohmann_json_j,
     }
     NLOHMANN_JSON_EXPAND(NLOHMANN_JSON_PASTE(NLOHMANN_JSON_FROM, body));
 }
+inline void to_json(nlohmann::json& nlohmann_json_j,
+                    const SubtitleData& nlohmann_json_t) {
+    NLOHMANN_JSON_EXPAND(
+        NLOHMANN_JSON_PASTE(NLOHMANN_JSON_TO, type, lang, body));
+}
 
 class VideoPageSubtitle {
 public:
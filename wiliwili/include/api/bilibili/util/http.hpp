@@ -9,6 +9,7 @@
 
 #include "bilibili/util/md5.hpp"
 #include "utils/number_helper.hpp"
+#include "utils/trace_helper.hpp"
 #include <pystring.h>
 
 namespace bilibili {
@@ -38,6 +39,20 @@ public:
     };
     static inline int TIMEOUT = 10000;
     static inline cpr::Proxies PROXIES;
+    /// 异步请求的回调执行完成后调用，可以在这里唤醒主循环
+    static inline std::function<void()> ON_RESPONSE;
+
+    /// 为请求参数添加 appkey 签名
+    static void sign(cpr::Parameters& parameters) {
+        parameters.Add({{"appkey", BILIBILI_APP_KEY},
+                        {"build", BILIBILI_BUILD},
+                        {"ts", std::to_string(wiliwili::getUnixTime() * 1000)}});
+        std::vector<std::string> kv;
+        pystring::split(parameters.GetContent(cpr::CurlHolder()), kv, "&");
+        std::sort(kv.begin(), kv.end());
+        parameters.Add({{"sign", websocketpp::md5::md5_hash_hex(
+                                     pystring::join("&", kv) + BILIBILI_APP_SECRET)}});
+    }
 
     static cpr::Response get(const std::string& url,
                              const cpr::Parameters& parameters = {},
@@ -54,9 +69,10 @@ public:
                     ERROR_MSG("Network error. [Status code: " +
                                   std::to_string(r.status_code) + " ]",
                               -404);
-                    return;
+                } else {
+                    callback(r);
                 }
-                callback(r);
+                if (ON_RESPONSE) ON_RESPONSE();
             },
             cpr::Url{url}, parameters, payload, HTTP::HEADERS, HTTP::COOKIES,
             HTTP::PROXIES,
@@ -77,9 +93,10 @@ public:
                     ERROR_MSG("Network error. [Status code: " +
                                   std::to_string(r.status_code) + " ]",
                               -404);
-                    return;
+                } else {
+                    callback(r);
                 }
-                callback(r);
+                if (ON_RESPONSE) ON_RESPONSE();
             },
             cpr::Url{url}, parameters, HTTP::HEADERS, HTTP::COOKIES,
             HTTP::PROXIES,
@@ -95,29 +112,27 @@ public:
         const std::string& url, cpr::Parameters parameters = {},
         const std::function<void(ReturnType)>& callback = nullptr,
         const ErrorCallback& error = nullptr, bool needSign = false) {
-        if (needSign) {
-            parameters.Add(
-                {{"appkey", BILIBILI_APP_KEY},
-                 {"build", BILIBILI_BUILD},
-                 {"ts", std::to_string(wiliwili::getUnixTime() * 1000)}});
-            std::vector<std::string> kv;
-            pystring::split(parameters.GetContent(cpr::CurlHolder()), kv, "&");
-            std::sort(kv.begin(), kv.end());
-            parameters.Add(
-                {{"sign", websocketpp::md5::md5_hash_hex(
-                              pystring::join("&", kv) + BILIBILI_APP_SECRET)}});
-        }
+        if (needSign) sign(parameters);
         __cpr_get(
             url, parameters,
             [callback, error](const cpr::Response& r) {
                 try {
-                    nlohmann::json res = nlohmann::json::parse(r.text);
-                    int code           = res.at("code").get<int>();
+                    nlohmann::json res;
+                    {
+                        TRACE_SCOPE("network", "HTTP::getResultAsync parse");
+                        res = nlohmann::json::parse(r.text);
+                    }
+                    auto deserialize = [&res](const char* key) {
+                        TRACE_SCOPE("network",
+                                    "HTTP::getResultAsync deserialize");
+                        return res.at(key).get<ReturnType>();
+                    };
+                    int code = res.at("code").get<int>();
                     if (code == 0) {
                         if (res.contains("data")) {
-                            CALLBACK(res.at("data").get<ReturnType>());
+                            CALLBACK(deserialize("data"));
                         } else if (res.contains("result")) {
-                            CALLBACK(res.at("result").get<ReturnType>());
+                            CALLBACK(deserialize("result"));
                         } else {
                             printf("data: %s\n", r.text.c_str());
                             ERROR_MSG("Cannot find data");
@@ -153,18 +168,7 @@ public:
         cpr::Payload payload                            = {},
         const std::function<void(ReturnType)>& callback = nullptr,
         const ErrorCallback& error = nullptr, bool needSign = false) {
-        if (needSign) {
-            parameters.Add(
-                {{"appkey", BILIBILI_APP_KEY},
-                 {"build", BILIBILI_BUILD},
-                 {"ts", std::to_string(wiliwili::getUnixTime() * 1000)}});
-            std::vector<std::string> kv;
-            pystring::split(parameters.GetContent(cpr::CurlHolder()), kv, "&");
-            std::sort(kv.begin(), kv.end());
-            parameters.Add(
-                {{"sign", websocketpp::md5::md5_hash_hex(
-                              pystring::join("&", kv) + BILIBILI_APP_SECRET)}});
-        }
+        if (needSign) sign(parameters);
         __cpr_post(
             url, parameters, payload,
             [callback, error](const cpr::Response& r) {
@@ -6,8 +6,13 @@
 
 #include <vector>
 #include <string>
-#include <set>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
 #include <tinyxml2.h>
+#include <nlohmann/json.hpp>
+#include <borealis/core/event.hpp>
 #include <borealis/core/singleton.hpp>
 
 using namespace std;
@@ -68,14 +73,93 @@ public:
     std::vector<DlnaRendererService> rendererServiceList;
 };
 
+/// 已发现的 renderer，保存在配置目录中，下次搜索时直接验证
+class DlnaDeviceCache {
+public:
+    std::string udn, location;
+    int64_t expire = 0;  // 过期时间 (unix time)
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(DlnaDeviceCache, udn, location, expire);
+
+/// renderer 上线或信息更新，参数为设备标识与 renderer
+typedef brls::Event<std::string, DlnaRenderer> DlnaRendererAddEvent;
+/// renderer 下线或过期，参数为设备标识
+typedef brls::Event<std::string> DlnaRendererRemoveEvent;
+
+/**
+ * 后台 SSDP 搜索
+ * 以递增的间隔重复发送 M-SEARCH，同时监听 NOTIFY 消息；
+ * 每个 renderer 的描述信息获取完成后立即在主线程中通知，不必等待搜索结束。
+ * 设备按 max-age 过期，收到 ssdp:byebye 时立即移除。
+ */
 class UpnpDlna : public brls::Singleton<UpnpDlna> {
 public:
+    ~UpnpDlna();
+
     /**
-     * 阻塞地查询 renderer 列表
-     * @param timeout 等待查询时间（毫秒），误差在200ms内
-     * @return renderer 列表
+     * 开始后台搜索 (主线程调用)
+     * 可以多次调用，需要与 stopDiscovery 成对使用
      */
-    std::vector<DlnaRenderer> searchRenderer(int timeout = 5000);
+    void startDiscovery();
+
+    void stopDiscovery();
+
+    /// 立即重新发送 M-SEARCH，并重置发送间隔
+    void refresh();
+
+    /// 当前可用的 renderer 列表，设备标识 -> renderer
+    std::vector<std::pair<std::string, DlnaRenderer>> getRenderers();
+
+    DlnaRendererAddEvent* getRendererAddEvent();
+
+    DlnaRendererRemoveEvent* getRendererRemoveEvent();
+
+    /// 以下函数在搜索线程中调用
+    void onAlive(const std::string& udn, const std::string& location,
+                 int maxAge);
+
+    void onByeBye(const std::string& udn);
+
+    /// M-SEARCH 的最小与最大发送间隔 (ms)
+    inline static int SEARCH_INTERVAL_MIN = 1000;
+    inline static int SEARCH_INTERVAL_MAX = 60000;
 
-    static inline std::set<std::string> rendererList;
-};
\ No newline at end of file
+    /// 获取 renderer 描述信息的超时时间 (ms)
+    inline static int DESCRIPTION_TIMEOUT = 3000;
+
+private:
+    class Device {
+    public:
+        std::string location;
+        int64_t expire = 0;
+        bool fetching  = false;  // 正在获取描述信息
+        bool fetched   = false;  // 已获取描述信息 (不一定是 renderer)
+        DlnaRenderer renderer;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Device> devices;
+    // 等待获取描述信息的设备：设备标识, location
+    std::vector<std::pair<std::string, std::string>> fetchQueue;
+    bool cacheDirty  = false;
+    bool cacheLoaded = false;
+
+    int discoveryUsers = 0;
+    std::thread discoveryThread;
+    std::atomic_bool discoveryRunning{false};
+    std::atomic_bool searchReset{false};
+
+    DlnaRendererAddEvent rendererAddEvent;
+    DlnaRendererRemoveEvent rendererRemoveEvent;
+
+    void discoveryLoop();
+
+    void onDescription(const std::string& udn, const std::string& url,
+                       long statusCode, const std::string& text);
+
+    void removeExpired();
+
+    void loadCache();
+
+    void saveCache();
+};
@@ -31,4 +31,7 @@ public:
 
 private:
     BRLS_BIND(RecyclingGrid, recyclingGrid, "home/hots/all/recyclingGrid");
+
+    /// 正在显示启动时的快照，收到第一页数据前不加载下一页
+    bool showingSnapshot = false;
 };
\ No newline at end of file
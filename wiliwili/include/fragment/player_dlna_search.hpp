@@ -10,6 +10,7 @@
 #pragma once
 
 #include <atomic>
+#include <unordered_map>
 #include <borealis.hpp>
 #include "dlna/dlna.h"
 #include "view/mpv_core.hpp"
@@ -44,19 +45,19 @@ public:
 
     ~PlayerDlnaSearch() override;
 
+    /// 立即重新搜索，已发现的设备保留在列表中
     void refreshRenderer();
 
-    void searchStart();
+    /// 添加或更新设备
+    void addRenderer(const std::string& udn, const DlnaRenderer& renderer);
 
-    void searchStop();
+    void removeRenderer(const std::string& udn);
 
     static bool isRunning();
 
+    // 刷新按钮上显示的倒计时 (秒)
     const int TIMEOUT = 3;
 
-    // 是否正在搜索中
-    inline static std::atomic<bool> running = false;
-
     // 是否正在等待返回播放链接
     inline static std::atomic<bool> waitingUrl = false;
 
@@ -74,6 +75,10 @@ private:
     DlnaRenderer currentRenderer;
     brls::RadioCell* currentCell = nullptr;
     MPVCustomEvent::Subscription customEventSubscribeID;
+    DlnaRendererAddEvent::Subscription rendererAddSubscribeID;
+    DlnaRendererRemoveEvent::Subscription rendererRemoveSubscribeID;
 
-    inline static std::thread dlnaSearchThread;
+    // 设备标识 -> 列表中的选项
+    std::unordered_map<std::string, brls::RadioCell*> deviceCells;
+    std::unordered_map<std::string, DlnaRenderer> renderers;
 };
\ No newline at end of file
@@ -44,6 +44,10 @@ public:
 private:
     bilibili::VideoCommentResult root;
     bilibili::VideoCommentCursor cursor;
+
+    /// 显示一页回复
+    void onCommentData(bilibili::VideoSingleCommentDetail& result);
+
     BRLS_BIND(RecyclingGrid, recyclingGrid,
               "player/single/comment/recyclingGrid");
     BRLS_BIND(ButtonClose, closeBtn, "button/close");
@@ -27,4 +27,6 @@ protected:
     int64_t currentUser       = 0;
     unsigned int currentPage  = 1;
     std::string currentOffset = "";
+    // 已经加载到最后一页，刷新前不再请求
+    bool noMore = false;
 };
\ No newline at end of file
@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include <memory>
+#include <type_traits>
+
 // 检查异步返回时组件是否已经被销毁
 #define ASYNC_RETAIN                               \
     if (!deletionToken && !deletionTokenCounter) { \
@@ -35,6 +38,19 @@
 
 #define ASYNC_TOKEN this, token, tokenCounter
 
+namespace wiliwili {
+/**
+ * 将异步返回的数据移入 shared_ptr
+ * brls::sync 会复制传入的回调函数，按值捕获的数据也会随之深拷贝；
+ * 捕获 shared_ptr 后复制的只是指针，数据本身只经过移动传递到主线程
+ */
+template <typename T>
+inline std::shared_ptr<T> moveToShared(T&& value) {
+    static_assert(!std::is_lvalue_reference_v<T>, "use std::move");
+    return std::make_shared<T>(std::move(value));
+}
+}  // namespace wiliwili
+
 // 避免多次请求API
 #define CHECK_REQUEST \
     if (requesting) return;
@@ -0,0 +1,63 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "presenter/presenter.h"
+#include "utils/suggest_trie.hpp"
+
+/**
+ * 搜索建议
+ * 输入时立即显示本地的搜索历史与近期获取过的建议中前缀相同的内容，
+ * 输入停止一段时间后再请求服务器。
+ * 每次输入都会使之前的请求失效，只有最新一次请求的结果会被显示
+ */
+class SearchSuggestRequest : public Presenter {
+public:
+    SearchSuggestRequest();
+
+    virtual ~SearchSuggestRequest();
+
+    /**
+     * 获取到搜索建议
+     * @param remote 为假时只包含本地的匹配结果，服务器的结果稍后返回
+     */
+    virtual void onSuggestList(const std::string& key,
+                               const std::vector<std::string>& list,
+                               bool remote) {}
+
+    virtual void onSuggestError(const std::string& error) {}
+
+    /// 请求搜索建议，key 为空时只取消之前的请求
+    void requestSuggest(const std::string& key);
+
+    /// 取消尚未返回的请求
+    void cancelSuggest();
+
+    /// 重新建立搜索历史的索引
+    void refreshHistoryIndex();
+
+    /// 停止输入后等待多久请求服务器 (ms)
+    inline static int DEBOUNCE = 300;
+
+    /// 本地匹配显示的数量
+    inline static size_t LOCAL_LIMIT = 5;
+
+    /// 保留的服务器建议数量，超出后清空重新记录
+    inline static size_t CACHE_SIZE = 2000;
+
+private:
+    SuggestTrie historyIndex;
+    /// 近期服务器返回的建议，所有页面共用
+    inline static SuggestTrie suggestIndex;
+    inline static size_t suggestWeight = 0;
+
+    size_t suggestGeneration = 0;
+    size_t suggestDelayIter  = 0;
+
+    std::vector<std::string> matchLocal(const std::string& key);
+};
@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <set>
+#include <atomic>
+#include <memory>
+
 #include "presenter.h"
 #include "bilibili.h"
 #include "bilibili/result/video_detail_result.h"
@@ -112,14 +116,21 @@ public:
     /// 获取视频弹幕
     void requestVideoDanmaku(int cid);
 
-    /// 获取视频分P详情
+    /// 播放已缓存到本地的视频，同时加载缓存的弹幕与字幕，未缓存时返回 false
+    bool requestOfflineVideo(int cid);
+
+    /**
+     * 获取视频分P详情
+     * @param requestSubtitle 为假时不设置字幕，用于播放已缓存的视频
+     */
     void requestVideoPageDetail(const std::string& bvid, int cid,
-                                bool requestHistoryInfo = true);
+                                bool requestHistoryInfo = true,
+                                bool requestSubtitle    = true);
 
-    /// 上报播放进度
+    /// 上报播放进度，flush 为假时合并到下一次定时发送
     void reportHistory(unsigned int aid, unsigned int cid,
                        unsigned int progress = 0, unsigned int duration = 0,
-                       int type = 3);
+                       int type = 3, bool flush = true);
     inline static bool REPORT_HISTORY = true;
 
     /// 视频可以投币的数量
@@ -168,4 +179,38 @@ protected:
 
     // 触发此事件，传入 SeasonEpisodeResult， 会播放对应epid的内容
     brls::Event<bilibili::SeasonEpisodeResult> changeEpisodeEvent;
+
+private:
+    // 正在预加载的评论页
+    bool commentPrefetching  = false;
+    int commentPrefetchAid   = 0;
+    int commentPrefetchIndex = 0;
+    int commentPrefetchMode  = 3;
+    // 请求的评论页正在预加载，加载结束后再显示
+    bool commentWaiting = false;
+    // 预加载评论回复的视频，切换视频后之前的请求结果会被丢弃
+    int commentReplyAid = 0;
+    std::shared_ptr<std::atomic<bool>> commentReplyValid;
+    // 正在预加载回复的评论
+    std::set<int64_t> commentReplyFetching;
+    // 当前视频已经预加载回复的评论数量
+    size_t commentReplyCount = 0;
+
+    /// 显示一页评论，并开始预加载下一页与评论回复
+    void onVideoCommentPage(int aid,
+                            bilibili::VideoCommentResultWrapper& result);
+
+    /// 在后台加载一页评论，保存在 CommentCache 中
+    void prefetchVideoComment(int aid, int mode, int next);
+
+    /// 预加载结束，error 为空时表示加载成功
+    void onCommentPrefetched(int aid, int mode, int next,
+                             const std::string& error);
+
+    /// 切换视频时丢弃正在预加载的评论回复
+    void resetCommentReplyPrefetch(int aid);
+
+    /// 在后台加载前几条评论的第一页回复，保存在 CommentCache 中
+    void prefetchCommentReplies(
+        int aid, const bilibili::VideoCommentResultWrapper& result);
 };
\ No newline at end of file
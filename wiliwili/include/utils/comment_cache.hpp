@@ -0,0 +1,120 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <map>
+#include <list>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <borealis/core/singleton.hpp>
+
+#include "bilibili/result/video_detail_result.h"
+
+/// 评论内容解析后的一个片段，不涉及图片与主题颜色，可以在任意线程中生成
+class CommentContentPart {
+public:
+    enum class Color { TEXT, LINK, BILIBILI };
+
+    bool image = false;
+    std::string value;  // 文字内容或图片地址
+    Color color = Color::TEXT;
+
+    // 图片尺寸
+    float width = 0, height = 0;
+
+    // 与 RichTextComponent 中的同名属性相同
+    float l_margin = 0, r_margin = 0, t_margin = 0, v_align = 0;
+};
+
+typedef std::vector<CommentContentPart> CommentContent;
+
+/**
+ * 评论预加载缓存
+ * 阅读当前页评论时在后台请求下一页，同时请求前几条评论的第一页回复，
+ * 翻页或打开评论详情时直接使用缓存，取出后即从缓存中移除，避免显示过期的数据。
+ * 评论内容在网络线程中预先解析为 CommentContent，主线程中只需要创建富文本组件。
+ * 按视频分别缓存，只保留最近的几个视频，每个视频的缓存数量也有上限
+ */
+class CommentCache : public brls::Singleton<CommentCache> {
+public:
+    /// 保存预加载的评论页，并解析其中的评论内容，在网络线程中调用
+    void putPage(size_t aid, int mode,
+                 bilibili::VideoCommentResultWrapper page);
+
+    /// 取出预加载的评论页，不存在时返回 false
+    bool takePage(size_t aid, int mode, size_t next,
+                  bilibili::VideoCommentResultWrapper& page);
+
+    /// 保存预加载的评论回复，并解析其中的评论内容，在网络线程中调用
+    void putThread(size_t aid, int64_t rpid,
+                   bilibili::VideoSingleCommentDetail thread);
+
+    /// 取出预加载的评论回复的第一页，不存在时返回 false
+    bool takeThread(size_t aid, int64_t rpid,
+                    bilibili::VideoSingleCommentDetail& thread);
+
+    /// 评论回复是否已经预加载
+    bool hasThread(size_t aid, int64_t rpid);
+
+    /// 预先解析评论内容，在网络线程中调用
+    void parse(size_t aid, const bilibili::VideoCommentListResult& list);
+
+    /// 获取预先解析的评论内容，不存在时返回 nullptr
+    std::shared_ptr<const CommentContent> getContent(
+        const bilibili::VideoCommentResult& data);
+
+    /// 评论内容的标识，区分置顶评论与普通评论中的同一条评论
+    static uint64_t getContentId(const bilibili::VideoCommentResult& data);
+
+    /// 每页评论中预加载回复的评论数量，为 0 时不预加载回复
+    inline static size_t PREFETCH_THREADS = 5;
+
+    /// 保留缓存的视频数量
+    static constexpr size_t MAX_VIDEOS = 3;
+
+    /// 单个视频最多缓存的评论页、评论回复与评论内容数量
+    static constexpr size_t MAX_PAGES    = 4;
+    static constexpr size_t MAX_THREADS  = 20;
+    static constexpr size_t MAX_CONTENTS = 600;
+
+private:
+    struct VideoCache {
+        size_t aid = 0;
+        std::map<std::pair<int, size_t>, bilibili::VideoCommentResultWrapper>
+            pages;
+        std::deque<std::pair<int, size_t>> pageOrder;
+        std::map<int64_t, bilibili::VideoSingleCommentDetail> threads;
+        std::deque<int64_t> threadOrder;
+        std::unordered_map<uint64_t, std::shared_ptr<const CommentContent>>
+            contents;
+        std::deque<uint64_t> contentOrder;
+    };
+
+    std::mutex mutex;
+    /// 最近使用的视频排在前面
+    std::list<VideoCache> videos;
+
+    /// 获取视频的缓存，不存在时创建，需要持有锁
+    VideoCache& getVideo(size_t aid);
+
+    /// 查找视频的缓存，不存在时返回 nullptr，不改变视频的顺序，需要持有锁
+    VideoCache* findVideo(size_t aid);
+
+    typedef std::vector<
+        std::pair<uint64_t, std::shared_ptr<const CommentContent>>>
+        ContentList;
+
+    /// 解析评论与其中包含的回复，不需要持有锁
+    static void parse(const bilibili::VideoCommentResult& data,
+                      ContentList& contents);
+
+    /// 保存解析结果，需要持有锁
+    static void insert(VideoCache& video, ContentList& contents);
+};
@@ -49,6 +49,11 @@ enum class SettingItem {
     PLAYER_BOTTOM_BAR,
     PLAYER_LOW_QUALITY,
     PLAYER_INMEMORY_CACHE,
+    PLAYER_MEDIA_CACHE,        // 磁盘媒体缓存
+    PLAYER_MEDIA_CONNECTIONS,  // 媒体并行下载连接数
+    PLAYER_QOE_PORT,           // 播放体验指标服务端口
+    DOWNLOAD_CONNECTIONS,      // 离线缓存同时下载的分段数
+    DOWNLOAD_SPEED_LIMIT,      // 离线缓存下载速度上限 (KB/s)
     PLAYER_HWDEC,
     PLAYER_HWDEC_CUSTOM,
     PLAYER_EXIT_FULLSCREEN_ON_END,
@@ -83,6 +88,12 @@ enum class SettingItem {
     DLNA_IP,
     DLNA_PORT,
     DLNA_NAME,
+    STARTUP_PARALLEL,  // 并行启动
+    STARTUP_TRACE,     // 导出启动耗时记录
+    SEARCH_HISTORY_LOG,  // 搜索历史单独保存在追加写入的日志中
+    ON_DEMAND_RENDER,    // 界面没有变化时暂停绘制
+    LIST_MEMORY_LIMIT,   // 单个列表保留完整数据的内存上限 (KB)
+    FEED_SNAPSHOT,       // 启动时先显示上次保存的列表快照
 };
 
 class APPVersion : public brls::Singleton<APPVersion> {
@@ -204,6 +215,7 @@ public:
 
     void load();
 
+    /// 在后台线程中合并写入配置文件
     void save();
 
     void init();
@@ -216,6 +228,9 @@ public:
 
     void loadCustomThemes();
 
+    /// 初始化自定义字体路径，keymap 为按键图标的样式
+    void initFontPath(const std::string& keymap);
+
     std::vector<CustomTheme> getCustomThemes();
 
     std::vector<CustomTheme> customThemes;
@@ -227,6 +242,17 @@ public:
     std::vector<std::string> searchHistory;
 
     static std::unordered_map<SettingItem, ProgramOption> SETTING_MAP;
+
+    /// 新增的搜索历史只追加到日志中，不重写整个配置文件
+    inline static bool SEARCH_HISTORY_LOG = true;
+
+private:
+    std::string getConfigPath();
+
+    std::string getSearchHistoryPath();
+
+    /// 将搜索词移动到历史记录的末尾
+    void pushHistory(const std::string& item);
 };
 
 inline void to_json(nlohmann::json& nlohmann_json_j,
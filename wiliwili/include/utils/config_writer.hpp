@@ -0,0 +1,72 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <condition_variable>
+#include <unordered_map>
+#include <borealis/core/singleton.hpp>
+
+/**
+ * 配置文件的异步写入
+ * 一段时间内对同一文件的多次写入合并为一次，在后台线程中完成。
+ * 写入时先写临时文件并同步到磁盘，再替换原文件，写入过程中崩溃不会损坏原文件。
+ */
+class ConfigWriter : public brls::Singleton<ConfigWriter> {
+public:
+    ConfigWriter();
+
+    ~ConfigWriter();
+
+    /**
+     * 替换文件的全部内容
+     * @param resetLogs 写入完成后清空的日志文件，这些日志的内容已经包含在 content 中
+     */
+    void write(const std::string& path, std::string content,
+               const std::vector<std::string>& resetLogs = {});
+
+    /// 在日志文件末尾追加一行
+    void append(const std::string& path, const std::string& line);
+
+    /// 立即写入全部等待中的数据，阻塞直到完成
+    void flush();
+
+    /// 写入临时文件并同步到磁盘后替换原文件
+    static bool writeAtomic(const std::string& path, const std::string& content);
+
+    /// 读取文件，原文件不存在时尝试读取上次未完成替换的临时文件
+    static bool read(const std::string& path, std::string& content);
+
+    /// 从第一次修改到写入磁盘的延迟 (ms)
+    inline static int DELAY = 2000;
+
+private:
+    struct FileTask {
+        std::string content;
+        std::vector<std::string> resetLogs;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::unordered_map<std::string, FileTask> files;
+    std::unordered_map<std::string, std::string> logs;
+    bool scheduled = false;
+    bool quit      = false;
+    std::chrono::steady_clock::time_point deadline;
+
+    /// 保证同一时刻只有一个线程在写文件
+    std::mutex ioMutex;
+    std::thread thread;
+
+    void schedule();
+
+    void run();
+
+    void process();
+};
@@ -0,0 +1,176 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <borealis/core/singleton.hpp>
+
+#include "bilibili/result/video_detail_result.h"
+
+/// 缓存任务中的一个媒体文件，按定长分段下载
+class DownloadFile {
+public:
+    std::string name;        // 文件名，保存在任务目录下，为空时表示没有该文件
+    size_t size = 0;         // 文件总大小，0 表示未知
+    std::vector<bool> done;  // 各分段是否已下载完成
+
+    std::set<size_t> running;  // 正在下载的分段 (不保存)
+
+    [[nodiscard]] bool isFinished() const;
+
+    [[nodiscard]] size_t getFinishedSize() const;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(DownloadFile, name, size, done);
+
+/// 保存在队列文件中，不要修改已有的值
+enum class DownloadState {
+    WAITING  = 0,
+    FINISHED = 1,
+    FAILED   = 2,
+};
+
+/// 一个缓存任务，对应视频的一个分P或番剧的一集
+class DownloadTask {
+public:
+    std::string bvid, title;
+    unsigned int cid = 0;
+    bool season      = false;  // 番剧使用 get_season_url 获取链接
+    int quality = 0, codecid = 0, audioId = 0;
+    std::string description;  // 清晰度名称
+    DownloadState state = DownloadState::WAITING;
+    DownloadFile video, audio;
+    bool extras  = false;  // 是否已经保存过弹幕与字幕
+    int64_t time = 0;      // 加入队列的时间 (ms)
+
+    // 以下内容不保存，每次启动后重新获取
+    std::vector<std::string> videoUrls, audioUrls;
+    bool resolving      = false;
+    bool fetchingExtras = false;  // 正在下载弹幕与字幕
+    int failures        = 0;
+    /// 文件重新开始下载时递增，用于丢弃之前发出的分段请求的结果
+    int generation = 0;
+
+    [[nodiscard]] float getProgress() const;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(DownloadTask, bvid, title, cid, season,
+                                   quality, codecid, audioId, description,
+                                   state, video, audio, extras, time);
+
+/**
+ * 离线缓存
+ * 复用播放时获取到的 DASH 链接，将选定的视频与音频分段下载到
+ * 配置目录下的 download/<cid>，弹幕与字幕保存在同一目录。
+ * 每个分段使用独立的范围请求，下载进度记录在队列文件中，
+ * 中断或重启后只下载缺失的分段。链接过期或下载失败时重新获取播放链接。
+ * 缓存完成的视频直接从磁盘播放，不再请求播放链接、弹幕与字幕。
+ * 除下载线程外只在主线程中调用
+ */
+class DownloadManager : public brls::Singleton<DownloadManager> {
+public:
+    DownloadManager();
+
+    /**
+     * 添加缓存任务，已失败的任务会重新开始
+     * 按照 result 中当前的清晰度与设定的编码、音质选择要下载的视频与音频
+     */
+    void add(const std::string& bvid, unsigned int cid,
+             const std::string& title, bool season,
+             const bilibili::VideoUrlResult& result);
+
+    /// 获取缓存任务，不存在时返回 nullptr
+    const DownloadTask* getTask(unsigned int cid);
+
+    /**
+     * 获取已缓存视频的播放信息，链接为本地文件路径
+     * @return 未缓存完成时返回 false
+     */
+    bool getLocalVideo(unsigned int cid, bilibili::VideoUrlResult& result);
+
+    /// 在后台读取已缓存的弹幕与字幕，完成后加载到播放器中
+    void loadExtras(unsigned int cid);
+
+    /// 链接是否为本地文件
+    static bool isLocalUrl(const std::string& url);
+
+    /// 同时下载的分段数
+    inline static int CONNECTIONS = 2;
+
+    /// 总下载速度上限 (KB/s)，为 0 时不限制
+    inline static int SPEED_LIMIT = 0;
+
+    /// 单个分段的大小
+    static constexpr size_t SEGMENT_SIZE = 4 * 1024 * 1024;
+
+    /// 连续失败超过该次数后停止任务
+    static constexpr int MAX_FAILURES = 5;
+
+private:
+    /// 按加入顺序排列，排在前面的任务优先下载
+    std::vector<DownloadTask> tasks;
+    int running = 0;
+    std::atomic_bool quit{false};
+
+    /// 下载线程共享的速度限制
+    std::mutex limitMutex;
+    double limitTokens = 0;
+    std::chrono::steady_clock::time_point limitTime;
+
+    DownloadTask* findTask(unsigned int cid);
+
+    static std::string getTaskDir(unsigned int cid);
+
+    /// 启动等待中的分段，直到达到连接数上限
+    void schedule();
+
+    /// 请求播放链接
+    void resolve(DownloadTask& task);
+
+    void onResolved(unsigned int cid, const bilibili::VideoUrlResult& result);
+
+    void onResolveError(unsigned int cid, const std::string& error);
+
+    /**
+     * 下载弹幕与字幕，全部保存成功后才标记为完成
+     * 失败时不影响视频的缓存，下次获取播放链接或重启后重试
+     */
+    void downloadExtras(DownloadTask& task);
+
+    void onExtras(unsigned int cid, bool success);
+
+    /// 文件是否已经完整下载到磁盘，没有该文件时返回 true
+    static bool isFileComplete(const std::string& dir,
+                               const DownloadFile& file);
+
+    void dispatch(DownloadTask& task, DownloadFile& file,
+                  const std::vector<std::string>& urls);
+
+    void onSegment(unsigned int cid, bool isAudio, size_t index,
+                   int generation, bool success, size_t total);
+
+    void onFailed(DownloadTask& task, const std::string& reason);
+
+    /// 清空文件的下载进度
+    static void resetFile(DownloadFile& file);
+
+    /**
+     * 在下载线程中下载 [from, to] 范围的数据并写入文件的对应位置
+     * @param total 服务器返回的文件总大小
+     * @return 完整下载了请求的范围，或者到达文件末尾
+     */
+    bool fetchSegment(const std::string& url, const std::string& path,
+                      size_t from, size_t to, size_t& total);
+
+    /// 按速度上限等待，在下载线程中调用
+    void limitSpeed(size_t size);
+
+    void save();
+};
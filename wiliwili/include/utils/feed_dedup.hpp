@@ -0,0 +1,49 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+
+/**
+ * 分页加载时过滤已经出现过的项目
+ * 推荐等接口的后续分页中经常包含之前返回过的内容
+ */
+template <typename Key>
+class FeedDedup {
+public:
+    /**
+     * 将 data 中没有出现过的项目追加到 list 末尾
+     * @param getKey 获取项目的唯一标识，如 aid、bvid 或直播间号
+     * @return 实际追加的数量
+     */
+    template <typename T, typename GetKey>
+    size_t append(std::vector<T>& list, const std::vector<T>& data,
+                  GetKey&& getKey) {
+        size_t count = 0;
+        list.reserve(list.size() + data.size());
+        for (const auto& i : data) {
+            if (!seen.insert(getKey(i)).second) continue;
+            list.emplace_back(i);
+            count++;
+        }
+        return count;
+    }
+
+    /// 记录已有的项目
+    template <typename T, typename GetKey>
+    void reset(const std::vector<T>& list, GetKey&& getKey) {
+        seen.clear();
+        for (const auto& i : list) seen.insert(getKey(i));
+    }
+
+    /// 记录单个项目，已经出现过时返回 false
+    bool insert(const Key& key) { return seen.insert(key).second; }
+
+    void clear() { seen.clear(); }
+
+private:
+    std::unordered_set<Key> seen;
+};
@@ -0,0 +1,58 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <string>
+#include <nlohmann/json.hpp>
+#include <borealis/core/singleton.hpp>
+#include <borealis/core/logger.hpp>
+
+/**
+ * 列表快照
+ * 退出或切换到后台时，将首页各个列表的第一页以 MessagePack 格式保存到配置目录下的
+ * feed_snapshot.bin。下次启动时先显示快照，同时请求新的数据替换快照。
+ * 快照与账号绑定，切换账号后不再使用。
+ */
+class FeedSnapshot : public brls::Singleton<FeedSnapshot> {
+public:
+    FeedSnapshot();
+
+    /// 读取快照，快照不存在或无法解析时返回 false
+    template <typename T>
+    bool get(const std::string& name, T& value) {
+        if (!ENABLE) return false;
+        auto it = data.find(name);
+        if (it == data.end()) return false;
+        try {
+            it->get_to(value);
+            return true;
+        } catch (const std::exception& e) {
+            brls::Logger::error("FeedSnapshot: failed to parse {}: {}", name,
+                                e.what());
+            data.erase(name);
+            return false;
+        }
+    }
+
+    /// 更新快照，退出或切换到后台时写入磁盘
+    template <typename T>
+    void set(const std::string& name, const T& value) {
+        if (!ENABLE) return;
+        data[name] = value;
+        dirty      = true;
+    }
+
+    /// 有改动时写入磁盘
+    void save();
+
+    /// 是否开启列表快照
+    inline static bool ENABLE = true;
+
+private:
+    nlohmann::json data = nlohmann::json::object();
+    bool dirty          = false;
+
+    static std::string getPath();
+};
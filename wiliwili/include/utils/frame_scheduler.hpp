@@ -0,0 +1,77 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <borealis/core/singleton.hpp>
+
+/**
+ * 按需绘制
+ * borealis 的主循环每次迭代都会重绘整个界面，空闲时也会持续占用 CPU。
+ * 在主循环的每次迭代之后调用 waitForNextFrame，界面一段时间内没有变化时
+ * 阻塞主循环，直到出现输入事件、网络请求完成、新的视频帧，
+ * 或者到达某个动画声明的下一帧时间点。
+ *
+ * 需要持续绘制的 view 不应再调用 brls::Application::setActiveEvent，
+ * 而是在 draw 中通过 requestFrame 声明下一帧的时间。
+ * brls::delay 等定时任务无法得知触发时间，空闲时最多延迟 MAX_WAIT。
+ * borealis 自身的动画不会请求绘制，只能依靠焦点变化等事件
+ * 保持 IDLE_DELAY 内的正常帧率，因此默认关闭
+ */
+class FrameScheduler : public brls::Singleton<FrameScheduler> {
+public:
+    FrameScheduler();
+
+    /**
+     * 请求在 delay (us) 之后绘制下一帧，只在主线程中调用
+     * 每一帧都需要重新请求
+     */
+    void requestFrame(int64_t delay = 0);
+
+    /// 唤醒主循环，可以在任意线程中调用
+    void wakeUp();
+
+    /// 在主循环每次迭代之后调用
+    void waitForNextFrame();
+
+    /// 是否开启按需绘制
+    inline static bool ENABLE = false;
+
+    /// 最后一次活动之后保持正常帧率的时间 (ms)，留给界面动画与布局更新
+    inline static int IDLE_DELAY = 1000;
+
+    /// 空闲时单次等待的最长时间 (ms)
+    inline static int MAX_WAIT = 100;
+
+    /// 手柄输入不产生窗口事件，等待期间检查手柄状态的间隔 (ms)
+    inline static int GAMEPAD_POLL = 8;
+
+    /// 统计信息的输出间隔 (s)，为 0 时不输出
+    inline static int STAT_INTERVAL = 0;
+
+private:
+    int64_t deadline   = INT64_MAX;
+    int64_t lastActive = 0;
+    std::atomic_bool woken{false};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    /// 统计空闲时间与实际绘制的帧数
+    int64_t statStart = 0;
+    int64_t idleTime  = 0;
+    size_t frames     = 0;
+
+    /// 阻塞当前线程，等待期间有事件发生时返回 true
+    bool wait(int64_t timeout);
+
+    /// 是否有手柄按键被按下或摇杆偏离中心
+    static bool gamepadActive();
+
+    void updateStat(int64_t now);
+};
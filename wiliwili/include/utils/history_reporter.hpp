@@ -0,0 +1,77 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <borealis/core/singleton.hpp>
+
+/// 一条播放进度记录
+class HistoryReport {
+public:
+    unsigned int aid = 0, cid = 0;
+    int type              = 3;  // 3: 视频 4: 番剧
+    unsigned int progress = 0, duration = 0;
+    unsigned int sid = 0, epid = 0;
+    int64_t time     = 0;  // 记录产生的时间 (ms)，用来判断新旧
+    int retries      = 0;  // 发送失败的次数
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(HistoryReport, aid, cid, type, progress,
+                                   duration, sid, epid, time, retries);
+
+/**
+ * 合并上报播放进度
+ * 同一视频 (aid, cid) 只保留最新的进度，
+ * 定时、退出播放、切换到后台或退出程序时统一发送。
+ * 发送成功前记录保存在配置目录下的队列文件中，发送失败后按指数退避重试，
+ * 重试次数达到上限后丢弃。只在主线程中调用
+ */
+class HistoryReporter : public brls::Singleton<HistoryReporter> {
+public:
+    HistoryReporter();
+
+    /**
+     * 记录播放进度
+     * @param flush 为真时立即发送，否则等待定时发送
+     */
+    void report(HistoryReport item, bool flush);
+
+    /// 发送全部未成功上报的记录
+    void flush();
+
+    /// 定时发送的间隔 (ms)
+    inline static int FLUSH_INTERVAL = 60000;
+
+    /// 连续发送失败时重试间隔的上限 (ms)
+    inline static int MAX_RETRY_INTERVAL = 960000;
+
+    /// 单条记录发送失败的次数上限，超出后丢弃
+    inline static int MAX_RETRIES = 8;
+
+    /// 保存的未发送记录数量上限
+    inline static size_t QUEUE_SIZE = 32;
+
+private:
+    /// 最新的进度，尚未进入发送队列
+    std::map<uint64_t, HistoryReport> pending;
+    /// 尚未确认发送成功的记录，与磁盘上的队列文件保持一致
+    std::map<uint64_t, HistoryReport> unsent;
+    /// 正在发送的记录
+    std::set<uint64_t> sending;
+    bool scheduled = false;
+
+    static uint64_t getKey(const HistoryReport& item);
+
+    void schedule();
+
+    void send(const HistoryReport& item);
+
+    void load();
+
+    void save();
+};
@@ -47,6 +47,15 @@ public:
 
     static void setRequestThreads(size_t num);
 
+    /**
+     * 将图片数据解码为 RGBA，可以在任意线程中调用
+     * @return 解码失败时返回 nullptr，否则需要使用 freeImage 释放
+     */
+    static uint8_t* decodeImage(const std::string& data, bool isWebp,
+                                int* width, int* height);
+
+    static void freeImage(uint8_t* data, bool isWebp);
+
     /// 图片请求后缀，用来控制图片大小
 #ifdef USE_WEBP
 #ifdef __PSV__
@@ -0,0 +1,214 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+#include <borealis/core/singleton.hpp>
+
+struct mg_mgr;
+struct mg_connection;
+
+/**
+ * 以块为单位保存在磁盘上的媒体缓存
+ * 每个媒体文件对应一个目录，目录内为定长的数据块与记录文件总大小的 size 文件
+ * 超出容量限制时，按最近最少使用的顺序删除数据块
+ * 锁只保护索引，文件读写在锁外进行；启动时在后台线程中扫描已有的数据块
+ */
+class MediaCache {
+public:
+    /// 数据块大小
+    static constexpr size_t BLOCK_SIZE = 512 * 1024;
+
+    ~MediaCache();
+
+    /// 设置缓存目录并在后台扫描已有的数据块，扫描完成前已有的数据块视为不存在
+    void init(const std::string& dir, size_t capacity);
+
+    void setCapacity(size_t capacity);
+
+    bool hasBlock(const std::string& key, size_t index);
+
+    bool readBlock(const std::string& key, size_t index, std::string& data);
+
+    void writeBlock(const std::string& key, size_t index,
+                    const std::string& data);
+
+    /// 获取媒体文件总大小，未知时返回 0
+    size_t getTotalSize(const std::string& key);
+
+    void setTotalSize(const std::string& key, size_t size);
+
+    void clear();
+
+private:
+    std::string dir;
+    size_t capacity = 0;
+    size_t usage    = 0;
+    std::mutex mutex;
+
+    struct Block {
+        std::string key;
+        size_t index;
+        size_t size;
+    };
+    /// 按访问顺序排列的数据块，队首最先被淘汰
+    std::list<Block> lru;
+    std::unordered_map<std::string, std::list<Block>::iterator> blocks;
+    std::unordered_map<std::string, size_t> totalSize;
+    /// 正在写入的数据块
+    std::unordered_set<std::string> writing;
+    /// 清空缓存或重新初始化后递增，用来丢弃之前开始的写入与扫描结果
+    size_t generation = 0;
+    std::thread scanThread;
+
+    std::string getBlockPath(const std::string& key, size_t index);
+
+    static std::string getBlockId(const std::string& key, size_t index);
+
+    /// 扫描缓存目录，不需要持有锁
+    void scan(const std::string& path, size_t gen);
+
+    /// 淘汰超出容量的数据块，返回需要删除的文件，需要持有锁
+    std::vector<std::string> trim();
+
+    /// 在锁外删除文件
+    static void removeFiles(const std::vector<std::string>& files);
+};
+
+/**
+ * 一次由 mpv 发起的范围请求
+ * 数据由工作线程写入，由代理线程发送给 mpv
+ */
+class MediaProxySession {
+public:
+    std::string key;
+    size_t start = 0;
+    size_t end    = 0;  // 包含 end，openEnd 为真时表示请求到文件末尾
+    bool openEnd  = true;
+    bool hasRange = false;
+    std::atomic<size_t> total{0};
+
+    std::atomic_bool cancel{false};
+    std::atomic_bool finished{false};
+    std::atomic_bool failed{false};
+    bool headerSent = false;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::string buffer;
+
+    /// 工作线程写入数据，缓冲区已满时阻塞，返回 false 表示请求已取消
+    bool push(const char* data, size_t size);
+
+    /// 代理线程取出至多 size 字节的数据
+    std::string pop(size_t size);
+};
+
+/**
+ * 本地媒体缓存代理
+ * 将 CDN 链接改写为 http://127.0.0.1:port/media/<key> 交给 mpv 播放，
+ * 代理根据 mpv 的 Range 请求优先从磁盘缓存读取，缺失的部分再回源获取并写入缓存。
+ * key 由链接的路径计算得到，不同镜像或不同签名的同一文件共享缓存。
+ */
+class MediaProxy : public brls::Singleton<MediaProxy> {
+public:
+    /// 使用配置目录下的 media_cache 作为缓存目录
+    MediaProxy();
+
+    /// 使用指定的缓存目录，用于性能测试等不应改动用户缓存的场景
+    explicit MediaProxy(const std::string& cacheDir);
+
+    ~MediaProxy();
+
+    /**
+     * 获取代理后的播放链接
+     * @param url 原始链接
+     * @param primary 为真时替换该文件已登记的全部镜像，否则作为备用镜像追加
+     * @return 代理链接，代理不可用时返回原始链接
+     */
+    std::string getProxyUrl(const std::string& url, bool primary = true);
+
+    bool isRunning() const;
+
+    void stop();
+
+    /// 清空磁盘缓存
+    void clearCache();
+
+    /// 设置磁盘缓存的容量，单位 MB，为 0 时关闭代理
+    void setCapacity(int mb);
+
+    /// 磁盘缓存容量 (MB)，为 0 时不使用代理
+    inline static int CACHE_SIZE = 0;
+
+    /// 回源时并行下载的连接数，为 1 时只使用单个连接
+    /// 只有开启磁盘缓存 (CACHE_SIZE > 0) 时才会经过代理，否则不生效
+    inline static int CONNECTIONS = 1;
+
+private:
+    mg_mgr* mgr = nullptr;
+    std::thread thread;
+    std::atomic_bool running{false};
+    std::atomic_bool quit{false};
+    int port = 0;
+
+    MediaCache cache;
+
+    std::mutex urlMutex;
+    /// key -> 镜像列表
+    std::unordered_map<std::string, std::vector<std::string>> mirrors;
+
+    /// connection id -> session (只在代理线程中访问)
+    std::unordered_map<unsigned long, std::shared_ptr<MediaProxySession>>
+        sessions;
+
+    bool start();
+
+    std::vector<std::string> getMirrors(const std::string& key);
+
+    static std::string getKey(const std::string& url);
+
+    void onRequest(mg_connection* c, void* hm);
+
+    void onPoll(mg_connection* c);
+
+    void onClose(mg_connection* c);
+
+    /// 在工作线程中为 session 准备数据
+    void produce(const std::shared_ptr<MediaProxySession>& session);
+
+    /**
+     * 回源获取 [from, to] 范围的数据，to 为 0 时表示到文件末尾
+     * 数据按块写入磁盘缓存，同时写入 session
+     */
+    bool fetch(const std::shared_ptr<MediaProxySession>& session,
+               const std::string& url, size_t from, size_t to, size_t& pos);
+
+    /// 下载 [from, to] 范围的数据，数据不完整时返回 false
+    static bool fetchChunk(const std::string& url, size_t from, size_t to,
+                           std::string& data,
+                           const std::function<bool()>& isCancel);
+
+    /**
+     * 使用多个连接并行下载 [from, to] 范围的数据，各连接轮流使用不同的镜像
+     * 数据按分片写入磁盘缓存，并按顺序写入 session
+     */
+    bool fetchParallel(const std::shared_ptr<MediaProxySession>& session,
+                       const std::vector<std::string>& urls, size_t from,
+                       size_t to, size_t& pos);
+
+    static void eventHandler(mg_connection* c, int ev, void* ev_data,
+                             void* fn_data);
+};
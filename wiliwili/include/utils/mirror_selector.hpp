@@ -0,0 +1,73 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include <borealis/core/singleton.hpp>
+
+/// 单个 CDN 域名的测速记录
+class MirrorScore {
+public:
+    double latency    = 0;  // ms
+    double throughput = 0;  // Bps
+    int failures      = 0;  // 连续失败次数
+    int64_t time      = 0;  // 上次测速的时间
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(MirrorScore, latency, throughput, failures,
+                                   time);
+
+/**
+ * 媒体镜像选择
+ * 并行向所有候选域名发送小范围请求测速，按延迟与吞吐量对链接排序。
+ * 测速结果保存在配置目录中，有效期内的域名在之后的播放中不再重复测速。
+ */
+class MirrorSelector : public brls::Singleton<MirrorSelector> {
+public:
+    using Callback = std::function<void(const std::vector<std::string>&,
+                                        const std::vector<std::string>&)>;
+
+    MirrorSelector();
+
+    /**
+     * 对视频与音频的候选链接排序，在主线程中回调
+     * 第一个链接为预计最快的镜像
+     */
+    void select(const std::vector<std::string>& videos,
+                const std::vector<std::string>& audios,
+                const Callback& callback);
+
+    /// 测速并排序，会阻塞当前线程
+    std::vector<std::string> rank(const std::vector<std::string>& urls);
+
+    /// 只使用已保存的测速记录排序
+    std::vector<std::string> sort(const std::vector<std::string>& urls);
+
+    static std::string getHost(const std::string& url);
+
+    /// 单次测速的超时时间 (ms)
+    inline static int PROBE_TIMEOUT = 1500;
+
+    /// 测速记录的有效期 (s)
+    inline static int PROBE_INTERVAL = 600;
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, MirrorScore> scores;
+
+    /// 并行测速，每个域名只测试一个链接
+    void probe(const std::vector<std::string>& urls);
+
+    /// 预计下载 1MB 数据所需的时间 (ms)，越小越好
+    double getCost(const std::string& host);
+
+    void load();
+
+    void save();
+};
@@ -0,0 +1,67 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <borealis/core/singleton.hpp>
+
+/**
+ * 简繁转换
+ * 转换结果保存在分片的 LRU 缓存中，重复出现的文本 (界面文字、重复的弹幕) 只转换一次。
+ * 可以在任意线程中调用，大量文本应在工作线程中通过 convertBatch 提前转换。
+ * 无法确认 OpenCC 可以被并发调用，实际的转换在锁内串行执行。
+ * 目前只有弹幕列表批量转换，接口返回的标题、简介等文字在 TextBox
+ * 显示时逐条转换，数量较少且依靠缓存避免重复转换。
+ */
+class OpenCCHelper : public brls::Singleton<OpenCCHelper> {
+public:
+    /// 当前语言与设置是否需要转换
+    static bool isEnabled();
+
+    /// 转换单条文本，不需要转换时原样返回
+    std::string convert(const std::string& text);
+
+    /// 不检查语言设置，转换单条文本并缓存结果
+    std::string convertCached(const std::string& text);
+
+    /**
+     * 在当前线程中批量转换，不要在主线程中调用
+     * @param getter 返回列表中每一项需要转换的字符串的引用
+     */
+    template <typename T, typename Getter>
+    void convertBatch(std::vector<T>& list, Getter getter) {
+        if (!isEnabled()) return;
+        for (auto& i : list) {
+            std::string& text = getter(i);
+            text              = this->convertCached(text);
+        }
+    }
+
+    void clear();
+
+    /// 缓存的文本数量上限
+    inline static size_t CACHE_SIZE = 8192;
+
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    class Shard {
+    public:
+        std::mutex mutex;
+        // 最近使用的在前
+        std::list<std::pair<std::string, std::string>> list;
+        std::unordered_map<std::string, decltype(list)::iterator> map;
+    };
+
+    Shard shards[SHARDS];
+
+    /// 串行调用 OpenCC
+    std::mutex converterMutex;
+};
@@ -0,0 +1,124 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <borealis/core/singleton.hpp>
+
+/// 单次播放的体验指标
+class QoeSession {
+public:
+    std::string content;        // 播放内容标识，如 bvid/cid
+    int64_t startTime      = 0;  // 开始加载的时间 (unix time)
+    int64_t startupLatency = -1; // 从设置链接到首帧的时间 (ms)，-1 表示没有播放成功
+    int stallCount         = 0;  // 播放过程中的缓冲次数
+    int64_t stallDuration  = 0;  // 缓冲总时长 (ms)
+    int64_t decoderDrops   = 0;  // 解码器丢帧数
+    int64_t outputDrops    = 0;  // 渲染丢帧数
+    double videoBitrate    = 0;  // 平均视频码率 (bps)
+    double audioBitrate    = 0;  // 平均音频码率 (bps)
+    int qualitySwitches    = 0;  // 清晰度切换次数
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(QoeSession, content, startTime,
+                                   startupLatency, stallCount, stallDuration,
+                                   decoderDrops, outputDrops, videoBitrate,
+                                   audioBitrate, qualitySwitches);
+
+/**
+ * 记录当前播放的体验指标，由 MPVCore 在主线程中调用
+ */
+class QoeMonitor {
+public:
+    /**
+     * 开始加载新的链接
+     * 与当前记录的内容相同时视为切换清晰度，否则结束当前记录并开始新的记录
+     */
+    void onLoad(const std::string& content);
+
+    void onFirstFrame();
+
+    void onPausedForCache(bool paused);
+
+    void onDecoderDrops(int64_t count);
+
+    void onOutputDrops(int64_t count);
+
+    void onVideoBitrate(double value);
+
+    void onAudioBitrate(double value);
+
+    /// 结束当前记录并保存到 QoeRecorder
+    void finish();
+
+    /// 获取当前正在进行的记录
+    QoeSession getSession() const;
+
+    bool isActive() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool active     = false;
+    bool firstFrame = false;
+    QoeSession session;
+    Clock::time_point loadTime;
+    Clock::time_point stallTime;
+    bool stalling = false;
+
+    // mpv 的丢帧计数在加载新文件时归零，切换清晰度时需要累加
+    int64_t decoderDropsBase = 0, decoderDropsCurrent = 0;
+    int64_t outputDropsBase = 0, outputDropsCurrent = 0;
+
+    double videoBitrateSum = 0, audioBitrateSum = 0;
+    int videoBitrateCount = 0, audioBitrateCount = 0;
+};
+
+/**
+ * 保存最近的播放体验记录
+ * 支持导出为 JSON，以及在本地端口提供 Prometheus 格式的指标
+ */
+class QoeRecorder : public brls::Singleton<QoeRecorder> {
+public:
+    QoeRecorder();
+
+    ~QoeRecorder();
+
+    void push(const QoeSession& session);
+
+    /// 按时间顺序获取全部记录
+    std::vector<QoeSession> getSessions();
+
+    std::string toJson();
+
+    std::string toPrometheus();
+
+    /// 导出到配置目录下的 qoe.json
+    bool exportJson();
+
+    /// 在 127.0.0.1:port 提供 /metrics 与 /qoe.json
+    void startServer(int port);
+
+    void stopServer();
+
+    /// 保存的记录数量
+    inline static size_t CAPACITY = 64;
+
+    /// 指标服务端口，为 0 时不启动
+    inline static int METRICS_PORT = 0;
+
+private:
+    std::mutex mutex;
+    std::vector<QoeSession> sessions;
+    size_t head = 0;  // 下一条记录写入的位置
+
+    std::thread serverThread;
+    std::atomic_bool serverRunning{false};
+};
@@ -0,0 +1,95 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <borealis/core/singleton.hpp>
+
+/// 单个启动阶段的记录，时间单位为 us，从进程启动时开始计算
+class StartupPhaseRecord {
+public:
+    std::string name;
+    int64_t start    = 0;
+    int64_t duration = 0;
+    size_t thread    = 0;
+};
+
+/**
+ * 冷启动耗时分析
+ * 记录启动过程中各阶段的耗时，首帧绘制完成后以 Chrome trace 格式写入
+ * 配置目录下的 startup_trace.json，可使用 chrome://tracing 或 Perfetto 查看
+ *
+ * 开启并行启动时，相互独立的阶段在后台线程中同时执行，
+ * 首帧不需要的工作通过 defer 推迟到首帧之后
+ */
+class StartupProfiler : public brls::Singleton<StartupProfiler> {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// 作用域内的启动阶段，析构时记录耗时
+    class Phase {
+    public:
+        explicit Phase(std::string name);
+
+        ~Phase();
+
+    private:
+        std::string name;
+        Clock::time_point start;
+    };
+
+    StartupProfiler();
+
+    void record(const std::string& name, Clock::time_point start,
+                Clock::time_point end);
+
+    /**
+     * 推迟到首帧之后在主线程执行
+     * 未开启并行启动或首帧已经完成时立即执行
+     */
+    void defer(const std::string& name, const std::function<void()>& task);
+
+    /// 主循环第一次返回后调用，执行推迟的任务并导出记录
+    void onFirstFrame();
+
+    /**
+     * 首页列表第一次显示内容时调用，只记录第一次
+     * @param source 内容来源，如 snapshot 或 network
+     */
+    void markFirstContent(const std::string& source);
+
+    /// 主循环每次返回后调用，内容出现后的第一帧记录为首次有效绘制
+    void onFrame();
+
+    std::string toJson();
+
+    /// 导出到配置目录下的 startup_trace.json
+    bool exportJson();
+
+    /// 导出启动耗时记录
+    inline static bool TRACE = false;
+
+    /// 并行启动模式
+    inline static bool PARALLEL = false;
+
+private:
+    std::mutex mutex;
+    Clock::time_point launchTime;
+    std::vector<StartupPhaseRecord> records;
+    std::unordered_map<std::thread::id, size_t> threads;
+    std::vector<std::pair<std::string, std::function<void()>>> deferredTasks;
+    bool firstFrame = false;
+    std::string contentSource;
+    bool contentPainted = false;
+
+    /// 将线程映射为从 1 开始的编号，主线程为 1
+    size_t getThreadIndex();
+};
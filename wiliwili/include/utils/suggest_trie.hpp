@@ -0,0 +1,41 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * 前缀树，用于在本地查找搜索建议
+ * 按字节建立索引，匹配时忽略 ASCII 字母的大小写
+ */
+class SuggestTrie {
+public:
+    SuggestTrie();
+
+    /// 插入一个词，weight 越大排序越靠前，重复插入时保留较大的权重
+    void insert(const std::string& word, size_t weight);
+
+    /// 查找以 prefix 开头的词，按权重从大到小返回最多 limit 个
+    std::vector<std::string> match(const std::string& prefix,
+                                   size_t limit) const;
+
+    void clear();
+
+    /// 已保存的词的数量
+    size_t size() const { return count; }
+
+private:
+    class Node {
+    public:
+        std::map<char, size_t> children;
+        std::string word;  // 为空时表示此处不是一个词的结尾
+        size_t weight = 0;
+    };
+
+    std::vector<Node> nodes;
+    size_t count = 0;
+};
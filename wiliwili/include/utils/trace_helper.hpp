@@ -0,0 +1,127 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * 热点路径耗时追踪
+ *
+ * 编译时开启 PERF_TRACE 后，TRACE_SCOPE 记录所在作用域的耗时，
+ * 每个线程写入自己的无锁环形缓冲区，只保留最近的记录；
+ * 关闭时这些宏为空，不产生任何开销。
+ * 记录可以在设置页面或通过 SIGUSR1 信号导出为 Chrome trace 格式，
+ * 使用 chrome://tracing 或 Perfetto 查看。
+ *
+ * category 与 name 必须是字符串常量，缓冲区中只保存指针
+ */
+#ifdef PERF_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(category, name) \
+    wiliwili::TraceScope TRACE_CONCAT(__trace_scope_, __LINE__)(category, name)
+#define TRACE_THREAD_NAME(name) wiliwili::PerfTrace::setThreadName(name)
+#define TRACE_POLL() wiliwili::PerfTrace::poll()
+#else
+#define TRACE_SCOPE(category, name)
+#define TRACE_THREAD_NAME(name)
+#define TRACE_POLL()
+#endif
+
+namespace wiliwili {
+
+/// 导出时使用的记录副本，时间单位为 us
+class TraceRecord {
+public:
+    const char* category = nullptr;
+    const char* name     = nullptr;
+    int64_t start        = 0;
+    int64_t duration     = 0;
+};
+
+/**
+ * 单个线程的环形缓冲区
+ * 只由所属线程写入，导出时在其它线程读取。
+ * 每个位置带有序号，读取前后序号不一致时说明记录正在被覆盖，直接丢弃
+ */
+class TraceBuffer {
+public:
+    TraceBuffer(size_t tid, size_t capacity);
+
+    void push(const char* category, const char* name, int64_t start,
+              int64_t duration);
+
+    /// 复制当前有效的记录
+    void collect(std::vector<TraceRecord>& out) const;
+
+    const size_t tid;
+    std::atomic<const char*> threadName{nullptr};
+    std::atomic_bool retired{false};  // 所属线程已经退出
+
+private:
+    class Slot {
+    public:
+        // 2 * index + 1 表示正在写入，2 * index + 2 表示写入完成
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char*> category{nullptr};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<int64_t> start{0};
+        std::atomic<int64_t> duration{0};
+    };
+
+    const size_t capacity;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> head{0};
+};
+
+class PerfTrace {
+public:
+    /// 从第一次调用开始计算的时间 (us)
+    static int64_t now();
+
+    static void record(const char* category, const char* name, int64_t start,
+                       int64_t duration);
+
+    static void setThreadName(const char* name);
+
+    /// 导出到配置目录，成功时返回文件路径，失败时返回空字符串
+    static std::string exportJson();
+
+    /// 收到 SIGUSR1 时导出记录，仅在桌面 unix 平台有效
+    static void installSignal();
+
+    /// 在主循环中调用，处理信号触发的导出请求
+    static void poll();
+
+    /// 每个线程保存的记录数量
+    inline static size_t CAPACITY = 16384;
+
+    /// 保留的缓冲区数量上限，超出时释放已退出线程的缓冲区
+    inline static size_t MAX_BUFFERS = 64;
+
+private:
+    static TraceBuffer* getBuffer();
+};
+
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name)
+        : category(category), name(name), start(PerfTrace::now()) {}
+
+    ~TraceScope() {
+        PerfTrace::record(category, name, start, PerfTrace::now() - start);
+    }
+
+private:
+    const char* category;
+    const char* name;
+    int64_t start;
+};
+
+}  // namespace wiliwili
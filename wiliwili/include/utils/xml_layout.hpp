@@ -0,0 +1,56 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <borealis/core/singleton.hpp>
+
+namespace tinyxml2 {
+class XMLDocument;
+class XMLElement;
+}  // namespace tinyxml2
+
+namespace brls {
+class View;
+}
+
+/**
+ * 编译时生成的界面布局
+ * 构建时由 scripts/compile_xml_layout.py 将 resources/xml 转换为二进制数据并链接到程序中，
+ * 运行时直接构建 XML 节点，不再读取和解析文件，同一布局只构建一次。
+ * 使用自定义界面布局 (APP_RESOURCES) 或找不到对应布局时，仍然读取 XML 文件。
+ */
+class XMLLayout : public brls::Singleton<XMLLayout> {
+public:
+    XMLLayout();
+
+    ~XMLLayout();
+
+    /// 代替 view->inflateFromXMLRes(res)，如: xml/fragment/home_tab.xml
+    static void inflate(brls::View* view, const std::string& res);
+
+    /// 代替 brls::View::createFromXMLResource(name)，如: fragment/home_tab.xml
+    static brls::View* create(const std::string& name);
+
+    /// 获取布局的根节点，没有对应布局时返回 nullptr，只能在主线程中调用
+    tinyxml2::XMLElement* getElement(const std::string& res);
+
+private:
+    // 字符串表，标签名与属性名只解码一次
+    std::vector<std::string> strings;
+    // 布局路径 -> 根节点在数据中的位置
+    std::unordered_map<std::string, size_t> offsets;
+    std::unordered_map<std::string, std::unique_ptr<tinyxml2::XMLDocument>>
+        documents;
+};
+
+/// 代替 CONTENT_FROM_XML_RES
+#define CONTENT_FROM_LAYOUT(name)            \
+    brls::View* createContentView() override { \
+        return XMLLayout::create(name);         \
+    }
@@ -86,7 +86,14 @@ public:
      * 加载弹幕数据
      * @param data 弹幕列表
      */
-    void loadDanmakuData(const std::vector<DanmakuItem> &data);
+    void loadDanmakuData(std::vector<DanmakuItem> data);
+
+    /**
+     * 解析 xml 格式的弹幕，可以在任意线程中调用
+     * @param content 弹幕接口返回的 xml
+     * @return 弹幕列表，解析失败时为空
+     */
+    static std::vector<DanmakuItem> decodeXML(const std::string &content);
 
     /**
      * 实时添加一条弹幕
@@ -9,6 +9,7 @@
 #include <mpv/client.h>
 #include <mpv/render.h>
 #include <fmt/format.h>
+#include "utils/qoe_helper.hpp"
 #if defined(MPV_SW_RENDER)
 #elif defined(BOREALIS_USE_DEKO3D)
 #include <mpv/render_dk3d.h>
@@ -114,6 +115,12 @@ public:
      */
     void setBackupUrl(const std::string &url, const std::string &extra = "");
 
+    /**
+     * 设置接下来播放的内容标识，用于统计播放体验
+     * 同一内容多次调用 setUrl 时视为切换清晰度，reset() 时清空
+     */
+    void setContentId(const std::string &id);
+
     void setVolume(int64_t value);
     void setVolume(const std::string &value);
 
@@ -236,6 +243,9 @@ public:
     int mpv_error_code     = 0;
     std::string hwCurrent;
 
+    // 当前播放的体验指标
+    QoeMonitor qoe;
+
     // 低画质解码，剔除解码过程中的部分步骤，可以用来节省cpu
     inline static bool LOW_QUALITY = false;
 
@@ -313,6 +323,9 @@ private:
     // 自定义的事件，传递内容为: string类型的事件名与一个任意类型的指针
     MPVCustomEvent mpvCoreCustomEvent;
 
+    // 下一次 setUrl 时使用的内容标识
+    std::string contentId;
+
     // 当前软件是否在前台的回调
     brls::Event<bool>::Subscription focusSubscription;
 
@@ -78,6 +78,22 @@ public:
      */
     virtual void onItemSelected(RecyclingGrid* recycler, size_t index) {}
 
+    /*
+     * 数据源是否为每一项提供了唯一标识
+     * 提供标识后，数据变化时 RecyclingGrid 只更新发生变化的列表项
+     */
+    virtual bool hasItemKey() { return false; }
+
+    /*
+     * 列表项的唯一标识，数据插入、删除、移动时保持不变
+     */
+    virtual int64_t getItemKey(size_t index) { return (int64_t)index; }
+
+    /*
+     * 列表项的内容摘要，标识相同但摘要变化时重新生成列表项
+     */
+    virtual size_t getItemHash(size_t index) { return 0; }
+
     virtual void clearData() = 0;
 };
 
@@ -110,8 +126,13 @@ public:
     // 重新加载数据
     void reloadData();
 
+    /// 数据变化后调用
+    /// 数据源提供标识时对比前后差异，只更新变化的列表项，并保持滚动位置与焦点
     void notifyDataChanged();
 
+    /// 使用数据源重新生成指定索引的列表项，列表项不在屏幕上时忽略
+    void reloadCell(size_t index);
+
     /// 获取当前指定索引数据所在的item指针
     ///（注意，因为是循环使用列表项的，所以此指针只能在获取时刻在主线程内使用）
     RecyclingGridItem* getGridItemByIndex(size_t index);
@@ -141,7 +162,7 @@ public:
     /// 当前数据总行数
     size_t getRowCount();
 
-    /// 导航到页面尾部时触发回调函数
+    /// 导航到距离页面尾部 nextPageLine 行时触发回调函数
     void onNextPage(const std::function<void()>& callback = nullptr);
 
     void setPadding(float padding) override;
@@ -174,6 +195,9 @@ public:
     /// 预取的行数
     int preFetchLine = 1;
 
+    /// 距离末尾还剩多少行时请求下一页，为 0 时滚动到最后一行才请求
+    int nextPageLine = 0;
+
     /// 瀑布流模式，每一项高度不固定（仅在spanCount为1时可用）
     bool isFlowMode = false;
 
@@ -186,6 +210,9 @@ private:
     // true表示正在请求下一页，此时不会再次触发下一页请求
     // 数据为空时不请求下一页，因为有些时候首页和下一页请求的内容或方式不同
     // 当列表元素有变动时（添加或修改数据源，会重置为false，这是将允许请求下一页）
+    // 请求下一页时的数据数量，数量变化后才允许再次请求
+    // 请求结束但没有新数据时（被过滤、内容被替换）需要调用 forceRequestNextPage
+    size_t nextPageItemCount = 0;
 
     uint32_t visibleMin, visibleMax;
     size_t defaultCellFocus = 0;
@@ -204,6 +231,9 @@ private:
     ButtonRefresh* refreshButton;
     brls::Rect renderedFrame;
     std::vector<float> cellHeightCache;
+    // 上次更新时每一项的标识与内容摘要
+    std::vector<int64_t> itemKeys;
+    std::vector<size_t> itemHashes;
     std::map<std::string, std::vector<RecyclingGridItem*>*> queueMap;
     std::map<std::string, std::function<RecyclingGridItem*(void)>>
         allocationMap;
@@ -216,7 +246,17 @@ private:
 
     void itemsRecyclingLoop();
 
-    void addCellAt(size_t index, int downSide);
+    void addCellAt(size_t index, int downSide,
+                   RecyclingGridItem* cell = nullptr);
+
+    // 获取焦点所在的列表项，焦点不在列表中时返回 nullptr
+    RecyclingGridItem* getFocusedCell();
+
+    // 记录数据源当前的标识与内容摘要
+    void updateItemKeys(std::vector<int64_t>& keys, std::vector<size_t>& hashes);
+
+    // 按标识对比前后的数据，复用仍然存在的列表项
+    void applyDiff(std::vector<int64_t> keys, std::vector<size_t> hashes);
 };
 
 class RecyclingGridContentBox : public brls::Box {
@@ -6,6 +6,7 @@
 
 #include "view/mpv_core.hpp"
 
+#include <set>
 #include <nanovg.h>
 #include <borealis/core/singleton.hpp>
 #include <borealis/core/application.hpp>
@@ -40,7 +41,7 @@ public:
     bilibili::VideoPageResult getSubtitleList();
 
     /**
-     * 设置字幕数据
+     * 设置字幕数据，并在后台预先下载全部字幕
      * @param data 字幕数据
      */
     void setSubtitleList(const bilibili::VideoPageResult& data);
@@ -68,14 +69,33 @@ public:
      */
     [[nodiscard]] std::string getCurrentSubtitleId() const;
 
+    /// 每帧最多预先测量的字幕条数
+    inline static size_t MEASURE_BATCH = 32;
+
+    /// 播放进度向前跳过超过该时间 (s) 时，使用二分查找定位字幕
+    inline static double SEEK_THRESHOLD = 5;
+
 private:
     void onLoadSubtitle(const bilibili::VideoPageSubtitle& page);
 
+    /// 下载字幕，完成后保存在 videoPageData 中
+    void requestSubtitle(const bilibili::VideoPageSubtitle& page);
+
+    /// 移动 subtitleIndex 到 time 时刻需要显示或即将显示的字幕
+    void seekSubtitle(double time);
+
+    /// 测量字幕在屏幕上的宽度，需要提前设置好字体
+    static void measureSubtitle(NVGcontext* vg, bilibili::SubtitleLine& line);
+
     bilibili::VideoPageResult videoPageData;
     int subtitleFont = brls::Application::getDefaultFont();
     bilibili::VideoPageSubtitle currentSubtitle;
     NVGcolor fontColor       = nvgRGB(255, 255, 255);
     NVGcolor backgroundColor = nvgRGBA(0, 0, 0, 127);
-    size_t subtitleIndex     = 0;
+    size_t subtitleIndex     = 0;  // 当前或下一条需要显示的字幕
+    size_t measuredIndex     = 0;  // 在此之前的字幕都已经测量过宽度
+    double lastPlaybackTime  = 0;
+    std::string pendingSubtitle;  // 等待下载完成后显示的字幕 ID
+    std::set<std::string> requestingSubtitles;
     MPVEvent::Subscription event_id;
 };
\ No newline at end of file
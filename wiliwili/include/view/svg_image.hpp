@@ -4,6 +4,8 @@
 
 #pragma once
 #include <cstring>
+#include <vector>
+#include <unordered_map>
 #include <borealis.hpp>
 #include <cpr/cpr.h>
 #include <lunasvg.h>
@@ -19,19 +21,42 @@ public:
 
     void setImageFromSVGRes(const std::string& value);
 
+    /**
+     * 在后台线程中渲染 SVG，渲染完成前保持显示之前的纹理
+     * 纹理按 路径 + 像素尺寸 + 颜色 缓存，同一图标的不同尺寸互不影响
+     */
     void setImageFromSVGFile(const std::string& value);
 
     void setImageFromSVGString(const std::string& value);
 
+    /// 将图标的颜色替换为指定颜色 (保留透明度)
+    void setSVGTint(NVGcolor value);
+
     void rotate(float value);
 
     void updateBitmap();
 
     static View* create();
 
+    /// 渲染 SVG 使用的最大线程数
+    inline static size_t RENDER_THREADS = 4;
+
 private:
     std::unique_ptr<lunasvg::Document> document = nullptr;
     brls::VoidEvent::Subscription subscription;
     std::string filePath;
-    float angle = 0;
-};
\ No newline at end of file
+    // 当前显示的纹理与等待渲染的纹理对应的缓存 key
+    std::string currentKey, requestKey;
+    // 当前显示的缓存纹理，更换纹理或销毁时减少其引用计数
+    int cacheTexture = 0;
+    uint32_t tint    = 0;
+    float angle      = 0;
+
+    void applyTexture(const std::string& key, int tex);
+
+    void releaseCache();
+
+    // 等待渲染完成的组件，同一 key 只渲染一次
+    inline static std::unordered_map<std::string, std::vector<SVGImage*>>
+        pendingViews;
+};
@@ -50,13 +50,44 @@ public:
 
     ~RichTextImage();
 
+    /// 开始加载图片，重复调用时不会重复加载
+    void load();
+
     std::string url;
     brls::Image* image;
     float width, height;
+    bool loaded = false;
 };
 
 typedef std::vector<std::shared_ptr<RichTextComponent>> RichTextData;
 
+/// 排版后的一个片段
+struct RichTextLayoutSpan {
+    RichTextType type;
+    uint32_t source;  // 对应富文本数据中的第几项，用来获取颜色与图片
+    uint32_t offset = 0, length = 0;  // 文字在 RichTextLayout::text 中的位置
+    float x = 0, y = 0;
+};
+
+/// 排版后的一行，包含 spans 中从 start 开始的 count 个片段
+struct RichTextLayoutLine {
+    uint32_t start = 0, count = 0;
+    float top      = 0;  // 这一行中最靠上的片段的 Y 值
+};
+
+/**
+ * 富文本的排版结果
+ * 所有片段与行保存在连续的数组中，文字拼接在同一个字符串里，
+ * 不引用具体的图片与颜色，内容相同的 TextBox 可以共用同一份排版结果
+ */
+class RichTextLayout {
+public:
+    std::string text;
+    std::vector<RichTextLayoutSpan> spans;
+    std::vector<RichTextLayoutLine> lines;
+    float height = 0;  // 不限制行数时的总高度
+};
+
 /**
  * 富文本
  * 支持不同颜色文字与图片绘制
@@ -83,8 +114,13 @@ public:
 
     /**
      * 设置富文本内容
+     * @param id 内容的唯一标识，不为 0 时相同内容在相同宽度与字号下的排版结果会被缓存，
+     *           列表项被回收复用时无需重新排版；内容与当前相同时直接返回
      */
-    void setRichText(const RichTextData& value);
+    void setRichText(const RichTextData& value, uint64_t id = 0);
+
+    /// 当前内容的标识，未设置时为 0
+    [[nodiscard]] uint64_t getContentId() const;
 
     RichTextData& getRichText();
 
@@ -119,6 +155,9 @@ public:
 
     ~TextBox() override;
 
+    /// 缓存的排版结果数量上限，为 0 时不缓存
+    inline static size_t LAYOUT_CACHE_SIZE = 256;
+
 protected:
     // 最大的行数
     size_t maxRows = SIZE_T_MAX;
@@ -126,8 +165,13 @@ protected:
     bool showMoreText = false;
     // 富文本数据
     RichTextData richContent;
-    // 按行分割的富文本数据。开发者设置富文本数据后，会按行重新分割。
-    std::vector<RichTextData> lineContent;
+    // 富文本内容的标识，用于查找缓存的排版结果
+    uint64_t contentId = 0;
+    // 按行分割后的排版结果。开发者设置富文本数据后，会按行重新分割。
+    std::shared_ptr<const RichTextLayout> layout;
 
     bool parsedDone = false;
+
+    /// 按行分割文本
+    std::shared_ptr<RichTextLayout> layoutRichText(float width);
 };
\ No newline at end of file
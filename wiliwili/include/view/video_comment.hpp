@@ -12,10 +12,11 @@
 #include <borealis.hpp>
 #include "view/recycling_grid.hpp"
 #include "view/user_info.hpp"
+#include "view/text_box.hpp"
+#include "utils/comment_cache.hpp"
 #include "bilibili/result/video_detail_result.h"
 
 class SVGImage;
-class TextBox;
 
 /// GridHintView
 
@@ -76,6 +77,16 @@ public:
 
     void cacheForReuse() override;
 
+    /**
+     * 解析评论内容，识别表情、@、跳转链接、话题与笔记图片
+     * 不创建图片也不读取主题，可以在网络线程中预先解析
+     */
+    static CommentContent parseContent(
+        const bilibili::VideoCommentResult& data);
+
+    /// 根据解析结果创建富文本，在主线程中调用
+    static RichTextData buildContent(const CommentContent& content);
+
 protected:
     BRLS_BIND(TextBox, commentContent, "comment/label/content");
     BRLS_BIND(brls::Label, labelLike, "comment/label/like");
@@ -45,6 +45,8 @@ private:
     brls::Event<float> progressSetEvent;
 
     float progress = 1;
+    /// 上一次更新布局时的进度
+    float lastLayoutProgress = -1;
 
     void updateUI();
 };
\ No newline at end of file
@@ -54,6 +54,10 @@ public:
     static std::string genExtraUrlParam(
         int progress, const std::vector<std::string>& audios = {});
 
+    /// 将音频链接转换为本地缓存代理链接
+    static std::vector<std::string> getProxyAudioUrl(
+        const std::vector<std::string>& audios);
+
     void resume();
 
     void pause();
@@ -221,6 +225,8 @@ private:
     bool showBottomLineSetting = true;
     // 是否为直播样式
     bool isLiveMode = false;
+    // 通过本地缓存代理播放时，当前视频的代理链接
+    std::string proxyUrl;
     MPVEvent::Subscription eventSubscribeID;
     MPVCustomEvent::Subscription customEventSubscribeID;
     std::function<void()> customToggleAction = nullptr;
@@ -0,0 +1,263 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <borealis/core/thread.hpp>
+#include <borealis/core/logger.hpp>
+
+#include "view/recycling_grid.hpp"
+
+class WindowedDataSourceBase : public RecyclingGridDataSource {
+public:
+    /// 每个数据源允许保留的完整数据的内存上限 (byte)，为 0 时不限制
+    inline static size_t MEMORY_LIMIT = 0;
+
+    /// 估算字符串在堆上占用的内存
+    static size_t heapSize(const std::string& str) {
+        return str.capacity() >= sizeof(std::string) ? str.capacity() + 1 : 0;
+    }
+};
+
+/**
+ * 限制内存占用的分页数据源
+ * 长时间浏览时列表会持续增长，超出内存上限后，距离当前位置最远的分页只保留每一项的 id，
+ * 释放标题、封面地址等数据。再次滚动到这些分页附近时重新请求，按 id 恢复到原来的位置。
+ * 恢复完成之前对应位置显示骨架屏。
+ *
+ * 子类需要实现：
+ *   getKey   项目的唯一标识
+ *   sizeOf   估算单个项目占用的内存
+ *   loadPage 重新请求指定的分页，完成后调用 callback，失败时传入空列表
+ * 可选实现：
+ *   markSeen 恢复时记录新出现的项目，已经在列表中出现过时返回 false
+ */
+template <typename T>
+class WindowedDataSource : public WindowedDataSourceBase {
+public:
+    using PageCallback = std::function<void(const std::vector<T>&)>;
+
+    WindowedDataSource() : alive(std::make_shared<bool>(true)) {}
+
+    size_t getItemCount() override { return keys.size(); }
+
+    bool hasItemKey() override { return true; }
+
+    int64_t getItemKey(size_t index) override { return keys[index]; }
+
+    void clearData() override {
+        pages.clear();
+        keys.clear();
+        memory = 0;
+        alive  = std::make_shared<bool>(true);
+    }
+
+    /**
+     * 追加一页数据
+     * @param request 重新请求这一页时传给 loadPage 的参数，如页码
+     */
+    void appendPage(std::vector<T> data, int request) {
+        if (data.empty()) return;
+        Page page;
+        page.request = request;
+        page.start   = keys.size();
+        for (auto& i : data) {
+            keys.emplace_back(getKey(i));
+            page.memory += sizeOf(i);
+        }
+        page.valid.resize(data.size(), true);
+        page.items = std::move(data);
+        memory += page.memory;
+        pages.emplace_back(std::move(page));
+        this->shrink();
+    }
+
+protected:
+    /**
+     * 获取指定位置的数据，所在的分页已被释放时返回 nullptr 并开始恢复
+     * 在 cellForRow 中调用，同时用来记录当前浏览的位置
+     */
+    const T* getItem(RecyclingGrid* recycler, size_t index) {
+        if (index >= keys.size()) return nullptr;
+        this->recycler = recycler;
+        current        = findPage(index);
+        // 当前分页与相邻的分页需要保持完整
+        for (size_t i = current > 0 ? current - 1 : 0;
+             i <= current + 1 && i < pages.size(); i++)
+            this->restore(i);
+        this->shrink();
+
+        auto& page    = pages[current];
+        size_t offset = index - page.start;
+        if (page.items.empty() || !page.valid[offset]) return nullptr;
+        return &page.items[offset];
+    }
+
+    /// 数据还没有恢复时使用的占位列表项
+    static RecyclingGridItem* placeholder(RecyclingGrid* recycler) {
+        auto* item = recycler->dequeueReusableCell("Skeleton");
+        item->setHeight(recycler->estimatedRowHeight);
+        return item;
+    }
+
+    virtual int64_t getKey(const T& item) = 0;
+
+    virtual size_t sizeOf(const T& item) { return sizeof(T); }
+
+    virtual void loadPage(int request, const PageCallback& callback) = 0;
+
+    virtual bool markSeen(const T& item) { return true; }
+
+private:
+    struct Page {
+        int request   = 0;
+        size_t start  = 0;
+        size_t memory = 0;
+        bool loading  = false;
+        std::vector<T> items;
+        std::vector<bool> valid;
+    };
+
+    std::vector<Page> pages;
+    std::vector<int64_t> keys;
+    size_t memory           = 0;
+    size_t current          = 0;
+    RecyclingGrid* recycler = nullptr;
+    std::shared_ptr<bool> alive;
+
+    size_t findPage(size_t index) {
+        auto it = std::upper_bound(
+            pages.begin(), pages.end(), index,
+            [](size_t i, const Page& page) { return i < page.start; });
+        return it - pages.begin() - 1;
+    }
+
+    /// 超出内存上限时释放距离当前位置最远的分页
+    void shrink() {
+        if (MEMORY_LIMIT == 0) return;
+        while (memory > MEMORY_LIMIT) {
+            size_t target = 0, distance = 0;
+            for (size_t i = 0; i < pages.size(); i++) {
+                if (pages[i].items.empty()) continue;
+                size_t d = i > current ? i - current : current - i;
+                if (d > distance) {
+                    distance = d;
+                    target   = i;
+                }
+            }
+            if (distance <= 1) break;
+            auto& page = pages[target];
+            memory -= page.memory;
+            page.memory = 0;
+            std::vector<T>().swap(page.items);
+            std::vector<bool>().swap(page.valid);
+            brls::Logger::debug("WindowedDataSource: release page {}", target);
+        }
+    }
+
+    void restore(size_t index) {
+        auto& page = pages[index];
+        // 分页中的项目全部被移除后不再需要恢复
+        if (!page.items.empty() || page.loading || pageSize(index) == 0)
+            return;
+        page.loading = true;
+        std::weak_ptr<bool> token = alive;
+        brls::Logger::debug("WindowedDataSource: restore page {}", index);
+        this->loadPage(page.request, [this, token, index](
+                                         const std::vector<T>& data) {
+            brls::sync([this, token, index, data]() {
+                // 数据源已被替换或清空
+                if (token.expired()) return;
+                this->onPageLoaded(index, data);
+            });
+        });
+    }
+
+    size_t pageSize(size_t index) {
+        return (index + 1 < pages.size() ? pages[index + 1].start
+                                         : keys.size()) -
+               pages[index].start;
+    }
+
+    /// 移除分页中没有数据的位置，返回移除的数量
+    size_t compact(size_t index) {
+        auto& page = pages[index];
+        size_t j   = 0;
+        for (size_t i = 0; i < page.items.size(); i++) {
+            if (!page.valid[i]) continue;
+            if (i != j) {
+                page.items[j]        = std::move(page.items[i]);
+                keys[page.start + j] = keys[page.start + i];
+            }
+            j++;
+        }
+        size_t removed = page.items.size() - j;
+        if (removed == 0) return 0;
+        page.items.resize(j);
+        page.valid.assign(j, true);
+        keys.erase(keys.begin() + page.start + j,
+                   keys.begin() + page.start + j + removed);
+        for (size_t i = index + 1; i < pages.size(); i++)
+            pages[i].start -= removed;
+        return removed;
+    }
+
+    void onPageLoaded(size_t index, const std::vector<T>& data) {
+        auto& page   = pages[index];
+        page.loading = false;
+        if (data.empty() || !page.items.empty()) return;
+
+        size_t count = this->pageSize(index);
+        page.items.resize(count);
+        page.valid.assign(count, false);
+
+        // 优先按 id 放回原来的位置，剩余的位置按顺序填充新数据
+        std::unordered_map<int64_t, size_t> slots;
+        for (size_t i = 0; i < count; i++) slots[keys[page.start + i]] = i;
+        std::vector<const T*> rest;
+        for (auto& i : data) {
+            auto it = slots.find(getKey(i));
+            if (it == slots.end() || page.valid[it->second]) {
+                rest.emplace_back(&i);
+                continue;
+            }
+            page.items[it->second] = i;
+            page.valid[it->second] = true;
+        }
+
+        // 刷新屏幕上按 id 放回原位的占位列表项
+        if (recycler)
+            for (size_t i = 0; i < count; i++)
+                if (page.valid[i]) recycler->reloadCell(page.start + i);
+
+        auto next    = rest.begin();
+        bool changed = false;
+        for (size_t i = 0; i < count && next != rest.end(); i++) {
+            if (page.valid[i]) continue;
+            // 跳过列表中其它位置已经出现过的项目
+            while (next != rest.end() && !markSeen(**next)) next++;
+            if (next == rest.end()) break;
+            page.items[i]        = **next++;
+            page.valid[i]        = true;
+            keys[page.start + i] = getKey(page.items[i]);
+            changed              = true;
+        }
+
+        for (size_t i = 0; i < count; i++)
+            if (page.valid[i]) page.memory += sizeOf(page.items[i]);
+        memory += page.memory;
+
+        // 返回的数据不足时移除剩余的占位，后面分页的位置随之前移
+        size_t removed = this->compact(index);
+        if (recycler && (changed || removed > 0)) recycler->notifyDataChanged();
+        this->shrink();
+    }
+};
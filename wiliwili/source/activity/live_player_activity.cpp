@@ -118,6 +118,7 @@ void LiveActivity::setCommonData() {
 
     // 重置播放器
     MPVCore::instance().reset();
+    MPVCore::instance().setContentId("live/" + std::to_string(liveData.roomid));
 
     // 清空自定义着色器
     ShaderHelper::instance().clearShader(false);
@@ -19,6 +19,7 @@
 #include "fragment/player_collection.hpp"
 #include "fragment/player_fragments.hpp"
 #include "fragment/player_evaluate.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -98,7 +99,7 @@ private:
 class UGCSeasonHeader : public RecyclingGridItem {
 public:
     UGCSeasonHeader() {
-        this->inflateFromXMLRes("xml/views/season_ugc_header_cell.xml");
+        XMLLayout::inflate(this, "xml/views/season_ugc_header_cell.xml");
     }
 
     static RecyclingGridItem* create() { return new UGCSeasonHeader(); }
@@ -527,9 +528,10 @@ void PlayerActivity::setProgress(int p) { videoDetailPage.progress = p; }
 
 int PlayerActivity::getProgress() { return videoDetailPage.progress; }
 
-void PlayerActivity::reportCurrentProgress(size_t progress, size_t duration) {
+void PlayerActivity::reportCurrentProgress(size_t progress, size_t duration,
+                                           bool flush) {
     this->reportHistory(videoDetailResult.aid, videoDetailPage.cid, progress,
-                        duration, 3);
+                        duration, 3, flush);
 }
 
 void PlayerActivity::onIndexChange(size_t index) {
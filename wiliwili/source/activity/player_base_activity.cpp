@@ -14,8 +14,13 @@
 #include "view/subtitle_core.hpp"
 #include "utils/config_helper.hpp"
 #include "utils/dialog_helper.hpp"
+#include "utils/download_manager.hpp"
+#include "utils/mirror_selector.hpp"
 #include "utils/number_helper.hpp"
+#include "utils/string_helper.hpp"
 #include "presenter/comment_related.hpp"
+#include "dlna/dlna.h"
+#include "utils/xml_layout.hpp"
 
 class DataSourceCommentList : public RecyclingGridDataSource,
                               public CommentRequest {
@@ -63,6 +68,14 @@ public:
 
     size_t getItemCount() override { return dataList.size() + 2; }
 
+    bool hasItemKey() override { return true; }
+
+    int64_t getItemKey(size_t index) override {
+        // 前两项为排序方式与回复按钮
+        if (index < 2) return -(int64_t)index - 1;
+        return dataList[index - 2].rpid;
+    }
+
     void onItemSelected(RecyclingGrid* recycler, size_t index) override {
         if (index == 0) {
             if (switchModeCallback) switchModeCallback();
@@ -79,7 +92,7 @@ public:
                             const bilibili::VideoCommentAddResult& result) {
                             this->dataList.insert(dataList.begin(),
                                                   result.reply);
-                            recycler->reloadData();
+                            recycler->notifyDataChanged();
                         });
                 },
                 "", "", 500, "", 0);
@@ -115,9 +128,11 @@ public:
         });
         view->deleteEvent.subscribe([this, recycler, index]() {
             dataList.erase(dataList.begin() + index - 2);
-            recycler->reloadData();
-            // 重新设置一下焦点到 recycler 的默认 cell （顶部）
-            brls::Application::giveFocus(recycler);
+            recycler->notifyDataChanged();
+            // 焦点交给占据原本位置的评论
+            auto* next = recycler->getGridItemByIndex(
+                std::min(index, recycler->getItemCount() - 1));
+            brls::Application::giveFocus(next ? (brls::View*)next : recycler);
         });
     }
 
@@ -147,7 +162,7 @@ private:
 class QualityCell : public RecyclingGridItem {
 public:
     QualityCell() {
-        this->inflateFromXMLRes("xml/views/player_quality_cell.xml");
+        XMLLayout::inflate(this, "xml/views/player_quality_cell.xml");
     }
 
     void setSelected(bool selected) {
@@ -220,6 +235,9 @@ private:
 void BasePlayerActivity::onContentAvailable() { this->setCommonData(); }
 
 void BasePlayerActivity::setCommonData() {
+    // 在后台搜索投屏设备，打开投屏页面时可以直接显示
+    UpnpDlna::instance().startDiscovery();
+
     // 视频评论
     recyclingGrid->registerCell("Cell",
                                 []() { return VideoComment::create(); });
@@ -300,11 +318,11 @@ void BasePlayerActivity::setCommonData() {
         static int64_t lastProgress = MPVCore::instance().video_progress;
         switch (event) {
             case MpvEventEnum::UPDATE_PROGRESS: {
-                // 每15秒同步一次进度
+                // 每15秒记录一次进度，合并到定时上报中
                 if (lastProgress + 15 < MPVCore::instance().video_progress) {
                     lastProgress = MPVCore::instance().video_progress;
-                    this->reportCurrentProgress(lastProgress,
-                                                MPVCore::instance().duration);
+                    this->reportCurrentProgress(
+                        lastProgress, MPVCore::instance().duration, false);
                 } else if (MPVCore::instance().video_progress < lastProgress) {
                     // 当前播放时间小于上一次上传历史记录的时间点
                     // 发生于向前拖拽进度的时候，此时重置lastProgress的值
@@ -336,6 +354,12 @@ void BasePlayerActivity::setCommonData() {
                 }
                 break;
             }
+            case MpvEventEnum::MPV_PAUSE:
+                // 暂停时记录进度，合并到定时上报中
+                this->reportCurrentProgress(MPVCore::instance().video_progress,
+                                            MPVCore::instance().duration,
+                                            false);
+                break;
             case MpvEventEnum::END_OF_FILE:
                 // 尝试自动加载下一分集
                 // 如果当前最顶层是Dialog就放弃自动播放，因为有可能是用户点开了收藏或者投币对话框
@@ -383,6 +407,9 @@ void BasePlayerActivity::showShareDialog(const std::string& link) {
     hint->setMargins(0, 10, 10, 10);
     container->addView(hint);
     auto dialog = new brls::Dialog(container);
+    // 离线缓存，与 B 站客户端一样放在分享菜单中
+    dialog->addButton("wiliwili/player/download/action"_i18n,
+                      [this]() { this->downloadVideo(); });
     dialog->addButton("hints/ok"_i18n, []() {});
     dialog->open();
 }
@@ -496,6 +523,40 @@ void BasePlayerActivity::setVideoQuality() {
     });
 }
 
+void BasePlayerActivity::downloadVideo() {
+    auto season      = dynamic_cast<PlayerSeasonActivity*>(this);
+    unsigned int cid = season ? episodeResult.cid : videoDetailPage.cid;
+    auto* task       = DownloadManager::instance().getTask(cid);
+    if (task && task->state == DownloadState::FINISHED) {
+        brls::Application::notify("wiliwili/player/download/finished"_i18n);
+        return;
+    }
+    if (task && task->state == DownloadState::WAITING) {
+        brls::Application::notify(
+            wiliwili::format("wiliwili/player/download/progress"_i18n,
+                             task->getProgress() * 100));
+        return;
+    }
+    // 只支持 dash 格式，正在播放离线缓存时无需再次缓存
+    auto& dash = this->videoUrlResult.dash;
+    if (dash.video.empty() ||
+        DownloadManager::isLocalUrl(dash.video[0].base_url)) {
+        brls::Application::notify("wiliwili/player/download/unsupported"_i18n);
+        return;
+    }
+
+    if (season) {
+        DownloadManager::instance().add(episodeResult.bvid, cid,
+                                        episodeResult.title, true,
+                                        this->videoUrlResult);
+    } else {
+        DownloadManager::instance().add(videoDetailResult.bvid, cid,
+                                        videoDetailResult.title, false,
+                                        this->videoUrlResult);
+    }
+    brls::Application::notify("wiliwili/player/download/queued"_i18n);
+}
+
 void BasePlayerActivity::setCommentMode() {
     this->recyclingGrid->estimatedRowHeight = 100;
     this->recyclingGrid->showSkeleton();
@@ -580,15 +641,38 @@ void BasePlayerActivity::onVideoPlayUrl(
                                 videoUrlResult.quality, v.codecid, a.id);
         }
 
-        // 给播放器设置链接
-        this->video->setUrl(v.base_url, progress, audios);
-
-        // 设置备份视频链接
-        for (const auto& backup_url : v.backup_url) {
-            this->video->setBackupUrl(backup_url, progress, audios);
+        // 播放离线缓存的文件
+        if (DownloadManager::isLocalUrl(v.base_url)) {
+            playUrlRequestId++;
+            this->video->setUrl(v.base_url, progress, audios);
+        } else {
+            // 对视频和音频的镜像测速，从最快的镜像开始播放
+            std::vector<std::string> videos{v.base_url};
+            videos.insert(videos.end(), v.backup_url.begin(),
+                          v.backup_url.end());
+            size_t id = ++playUrlRequestId;
+            ASYNC_RETAIN
+            MirrorSelector::instance().select(
+                videos, audios,
+                [ASYNC_TOKEN, id, progress](
+                    const std::vector<std::string>& videos,
+                    const std::vector<std::string>& audios) {
+                    ASYNC_RELEASE
+                    // 测速期间切换了视频
+                    if (id != this->playUrlRequestId) return;
+
+                    // 给播放器设置链接
+                    this->video->setUrl(videos[0], progress, audios);
+
+                    // 设置备份视频链接
+                    for (size_t i = 1; i < videos.size(); i++) {
+                        this->video->setBackupUrl(videos[i], progress, audios);
+                    }
+                });
         }
     } else {
         // flv
+        playUrlRequestId++;
         brls::Logger::debug("Video type: flv");
         if (result.durl.empty()) {
             brls::Logger::error("No media");
@@ -717,6 +801,7 @@ BasePlayerActivity::~BasePlayerActivity() {
     // 取消监控mpv
     MPV_E->unsubscribe(eventSubscribeID);
     MPV_CE->unsubscribe(customEventSubscribeID);
+    UpnpDlna::instance().stopDiscovery();
     // 停止视频播放
     this->video->stop();
 }
\ No newline at end of file
@@ -61,9 +61,9 @@ void PlayerSeasonActivity::setProgress(int p) { episodeResult.progress = p; }
 int PlayerSeasonActivity::getProgress() { return episodeResult.progress; }
 
 void PlayerSeasonActivity::reportCurrentProgress(size_t progress,
-                                                 size_t duration) {
+                                                 size_t duration, bool flush) {
     this->reportHistory(episodeResult.aid, episodeResult.cid, progress,
-                        duration, 4);
+                        duration, 4, flush);
 }
 
 void PlayerSeasonActivity::onIndexChange(size_t index) {
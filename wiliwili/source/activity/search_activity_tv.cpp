@@ -82,29 +82,29 @@ private:
 
 class DataSourceSuggest : public RecyclingGridDataSource {
 public:
-    DataSourceSuggest(bilibili::SearchSuggestList result, UpdateSearchEvent* u)
+    DataSourceSuggest(std::vector<std::string> result, UpdateSearchEvent* u)
         : list(std::move(result)), updateSearchEvent(u) {}
 
     RecyclingGridItem* cellForRow(RecyclingGrid* recycler,
                                   size_t index) override {
         auto* item =
             (RecyclingGridItemHotsCard*)recycler->dequeueReusableCell("Cell");
-        item->setCard(std::to_string(index + 1), list.tag[index].value, "");
+        item->setCard(std::to_string(index + 1), list[index], "");
         return item;
     }
 
     void onItemSelected(RecyclingGrid* recycler, size_t index) override {
         if (this->updateSearchEvent) {
-            this->updateSearchEvent->fire(list.tag[index].value);
+            this->updateSearchEvent->fire(list[index]);
         }
     }
 
-    size_t getItemCount() override { return list.tag.size(); }
+    size_t getItemCount() override { return list.size(); }
 
-    void clearData() override { this->list.tag.clear(); }
+    void clearData() override { this->list.clear(); }
 
 private:
-    bilibili::SearchSuggestList list;
+    std::vector<std::string> list;
     UpdateSearchEvent* updateSearchEvent = nullptr;
 };
 
@@ -114,29 +114,27 @@ TVSearchActivity::TVSearchActivity() {
 }
 
 void TVSearchActivity::requestSearchSuggest() {
-    ASYNC_RETAIN
-    BILI::get_search_suggest_tv(
-        getCurrentSearch(),
-        [ASYNC_TOKEN](const bilibili::SearchSuggestList& result) {
-            brls::Threading::sync([ASYNC_TOKEN, result]() {
-                ASYNC_RELEASE
-                this->hotsHeaderLabel->setText("wiliwili/search/tv/suggest"_i18n);
-                this->searchHots->getRecyclingGrid()->setDataSource(
-                    new DataSourceSuggest(result, &updateSearchEvent));
-            });
-        },
-        [ASYNC_TOKEN](BILI_ERR) {
-            brls::Logger::error("requestSearchSuggest: {}", error);
-            brls::sync([ASYNC_TOKEN, error]() {
-                ASYNC_RELEASE
-                this->searchHots->getRecyclingGrid()->setError(error);
-            });
-        });
+    this->requestSuggest(getCurrentSearch());
+}
+
+void TVSearchActivity::onSuggestList(const std::string& key,
+                                     const std::vector<std::string>& list,
+                                     bool remote) {
+    // 本地没有匹配时保留当前内容，等待服务器返回
+    if (!remote && list.empty()) return;
+    this->hotsHeaderLabel->setText("wiliwili/search/tv/suggest"_i18n);
+    this->searchHots->getRecyclingGrid()->setDataSource(
+        new DataSourceSuggest(list, &updateSearchEvent));
+}
+
+void TVSearchActivity::onSuggestError(const std::string& error) {
+    this->searchHots->getRecyclingGrid()->setError(error);
 }
 
 void TVSearchActivity::updateInputLabel() {
     std::string value = getCurrentSearch();
     if (value.empty()) {
+        this->cancelSuggest();
         this->inputLabel->setText("wiliwili/search/tv/hint"_i18n);
         this->inputLabel->setTextColor(
             brls::Application::getTheme().getColor("font/grey"));
@@ -250,7 +248,11 @@ void TVSearchActivity::setCurrentSearch(const std::string& value) {
 
 void TVSearchActivity::search(const std::string& key) {
     if (key.empty()) return ;
+    this->cancelSuggest();
     Intent::openSearch(key);
 }
 
-void TVSearchActivity::onResume() { this->searchHistory->requestHistory(); }
+void TVSearchActivity::onResume() {
+    this->searchHistory->requestHistory();
+    this->refreshHistoryIndex();
+}
@@ -11,9 +11,12 @@
 #include "view/mpv_core.hpp"
 #include "view/selector_cell.hpp"
 #include "utils/config_helper.hpp"
+#include "utils/media_proxy.hpp"
 #include "utils/vibration_helper.hpp"
 #include "utils/dialog_helper.hpp"
 #include "utils/activity_helper.hpp"
+#include "utils/trace_helper.hpp"
+#include "utils/xml_layout.hpp"
 #include "borealis/core/cache_helper.hpp"
 #include "borealis/views/applet_frame.hpp"
 #include "bilibili.h"
@@ -159,7 +162,7 @@ void SettingActivity::onContentAvailable() {
 #ifdef __SWITCH__
     btnTutorialError->registerClickAction([](...) -> bool {
         auto dialog =
-            new brls::Dialog((brls::Box*)brls::View::createFromXMLResource(
+            new brls::Dialog((brls::Box*)XMLLayout::create(
                 "fragment/settings_tutorial_error.xml"));
         dialog->addButton("hints/ok"_i18n, []() {});
         dialog->open();
@@ -185,7 +188,7 @@ void SettingActivity::onContentAvailable() {
 #endif
     btnTutorialFont->registerClickAction([](...) -> bool {
         auto dialog =
-            new brls::Dialog((brls::Box*)brls::View::createFromXMLResource(
+            new brls::Dialog((brls::Box*)XMLLayout::create(
                 "fragment/settings_tutorial_font.xml"));
         dialog->addButton("hints/ok"_i18n, []() {});
         dialog->open();
@@ -194,7 +197,7 @@ void SettingActivity::onContentAvailable() {
 
     btnHotKey->registerClickAction([](...) -> bool {
         auto dialog =
-            new brls::Dialog((brls::Box*)brls::View::createFromXMLResource(
+            new brls::Dialog((brls::Box*)XMLLayout::create(
                 "fragment/settings_hot_keys.xml"));
         dialog->addButton("hints/ok"_i18n, []() {});
         dialog->open();
@@ -219,6 +222,22 @@ void SettingActivity::onContentAvailable() {
     btnVibrationTest->setVisibility(brls::Visibility::GONE);
 #endif
 
+#ifdef PERF_TRACE
+    btnPerfTrace->registerClickAction([](...) -> bool {
+        std::string path = wiliwili::PerfTrace::exportJson();
+        if (path.empty()) {
+            DialogHelper::showDialog(
+                "wiliwili/setting/tools/test/trace_failed"_i18n);
+        } else {
+            DialogHelper::showDialog(
+                "wiliwili/setting/tools/test/trace_done"_i18n + "\n" + path);
+        }
+        return true;
+    });
+#else
+    btnPerfTrace->setVisibility(brls::Visibility::GONE);
+#endif
+
     std::string version = APPVersion::instance().git_tag.empty()
                               ? "v" + APPVersion::instance().getVersionStr()
                               : APPVersion::instance().git_tag;
@@ -597,6 +616,46 @@ void SettingActivity::onContentAvailable() {
             MPVCore::instance().restart();
         });
 
+    selectorMediaCache->init(
+        "wiliwili/setting/app/playback/media_cache"_i18n,
+#ifdef __PSV__
+        {"0MB (" + "hints/off"_i18n + ")", "128MB", "256MB"},
+#else
+        {"0MB (" + "hints/off"_i18n + ")", "256MB", "512MB", "1GB", "2GB",
+         "4GB"},
+#endif
+        conf.getIntOptionIndex(SettingItem::PLAYER_MEDIA_CACHE),
+        [this](int data) {
+            auto cacheOption = ProgramConfig::instance().getOptionData(
+                SettingItem::PLAYER_MEDIA_CACHE);
+            ProgramConfig::instance().setSettingItem(
+                SettingItem::PLAYER_MEDIA_CACHE,
+                cacheOption.rawOptionList[data]);
+            MediaProxy::instance().setCapacity(cacheOption.rawOptionList[data]);
+            // 并行下载由媒体代理完成，关闭磁盘缓存时不使用代理
+            selectorMediaConnections->setVisibility(
+                cacheOption.rawOptionList[data] > 0
+                    ? brls::Visibility::VISIBLE
+                    : brls::Visibility::GONE);
+        });
+
+    auto connectionOption =
+        conf.getOptionData(SettingItem::PLAYER_MEDIA_CONNECTIONS);
+    selectorMediaConnections->init(
+        "wiliwili/setting/app/playback/media_connections"_i18n,
+        connectionOption.optionList,
+        conf.getIntOptionIndex(SettingItem::PLAYER_MEDIA_CONNECTIONS),
+        [connectionOption](int data) {
+            ProgramConfig::instance().setSettingItem(
+                SettingItem::PLAYER_MEDIA_CONNECTIONS,
+                connectionOption.rawOptionList[data]);
+            MediaProxy::CONNECTIONS = connectionOption.rawOptionList[data];
+        });
+
+    // 并行下载由媒体代理完成，关闭磁盘缓存时不使用代理
+    if (conf.getIntOption(SettingItem::PLAYER_MEDIA_CACHE) <= 0)
+        selectorMediaConnections->setVisibility(brls::Visibility::GONE);
+
 /// Hardware decode
 #ifdef PS4
     btnHWDEC->setVisibility(brls::Visibility::GONE);
@@ -2,14 +2,17 @@
 // Created by fang on 2023/5/17.
 //
 
-#include <set>
 #include <future>
+#include <fstream>
+#include <algorithm>
 #include <mongoose.h>
 #include <cpr/cpr.h>
 #include <pystring.h>
 #include <borealis/core/logger.hpp>
+#include <borealis/core/thread.hpp>
 #include "utils/string_helper.hpp"
 #include "utils/config_helper.hpp"
+#include "utils/number_helper.hpp"
 #include "dlna/dlna.h"
 
 static std::string AVTransport =
@@ -48,43 +51,64 @@ static std::string Stop =
     "</s:Body>"
     "</s:Envelope>";
 
-static const char* s_ssdp_url = "udp://239.255.255.250:1900";
+static const char* s_ssdp_url        = "udp://239.255.255.250:1900";
+static const char* s_ssdp_listen_url = "udp://0.0.0.0:1900";
+static const char* s_renderer_type =
+    "urn:schemas-upnp-org:device:MediaRenderer:1";
+
+/// 设备没有提供 max-age 时使用的有效期 (s)
+#define DEFAULT_MAX_AGE 1800
+
+static std::string getHeader(struct mg_http_message* hm, const char* name) {
+    struct mg_str* v = mg_http_get_header(hm, name);
+    if (v == nullptr) return "";
+    return std::string{v->ptr, v->len};
+}
+
+static int getMaxAge(const std::string& cacheControl) {
+    auto pos = cacheControl.find("max-age");
+    if (pos == std::string::npos) return DEFAULT_MAX_AGE;
+    pos = cacheControl.find('=', pos);
+    if (pos == std::string::npos) return DEFAULT_MAX_AGE;
+    int age = atoi(cacheControl.c_str() + pos + 1);
+    return age > 0 ? age : DEFAULT_MAX_AGE;
+}
 
 static void fn(struct mg_connection* c, int ev, void* ev_data, void* fn_data) {
-    MG_DEBUG(("%p got event: %d %p %p", c, ev, ev_data, fn_data));
-    if (ev == MG_EV_OPEN) {
-        //    c->is_hexdumping = 1;
-    } else if (ev == MG_EV_RESOLVE) {
+    auto* dlna = (UpnpDlna*)fn_data;
+    if (ev == MG_EV_RESOLVE) {
         // c->rem gets populated with multicast address. Store it in c->data
         memcpy(c->data, &c->rem, sizeof(c->rem));
     } else if (ev == MG_EV_READ) {
-        MG_INFO(("Got a response"));
         struct mg_http_message hm {};
         if (mg_http_parse((const char*)c->recv.buf, c->recv.len, &hm) > 0) {
-            size_t i, max = sizeof(hm.headers) / sizeof(hm.headers[0]);
-            // Iterate over request headers
-            for (i = 0; i < max && hm.headers[i].name.len > 0; i++) {
-                struct mg_str *k = &hm.headers[i].name,
-                              *v = &hm.headers[i].value;
-                if (mg_vcasecmp(k, "LOCATION") == 0) {
-                    UpnpDlna::rendererList.insert(
-                        std::string{v->ptr}.substr(0, v->len));
+            bool notify     = mg_vcasecmp(&hm.method, "NOTIFY") == 0;
+            std::string usn  = getHeader(&hm, "USN");
+            std::string udn  = usn.substr(0, usn.find("::"));
+            // M-SEARCH 的回复只包含搜索的设备类型，NOTIFY 需要过滤
+            if (!notify) {
+                dlna->onAlive(udn, getHeader(&hm, "LOCATION"),
+                              getMaxAge(getHeader(&hm, "CACHE-CONTROL")));
+            } else if (getHeader(&hm, "NT") == s_renderer_type) {
+                if (getHeader(&hm, "NTS") == "ssdp:byebye") {
+                    dlna->onByeBye(udn);
+                } else {
+                    dlna->onAlive(udn, getHeader(&hm, "LOCATION"),
+                                  getMaxAge(getHeader(&hm, "CACHE-CONTROL")));
                 }
             }
         }
         // Each response to the SSDP socket will change c->rem.
-        // We can now do mg_printf(c, "haha"); to respond back to the remote side.
-        // But in our case, we should restore the multicast address in order
-        // to have next search to go to the multicast address
-        memcpy(&c->rem, c->data, sizeof(c->rem));
+        // Restore the multicast address in order to have next search to go to
+        // the multicast address
+        if (!c->is_listening) memcpy(&c->rem, c->data, sizeof(c->rem));
         // Discard the content of this response as we expect each SSDP response
         // to generate at most one MG_EV_READ event.
         c->recv.len = 0UL;
     }
 }
 
-static void sendSearch(void* param) {
-    auto* c = (struct mg_connection*)param;
+static void sendSearch(struct mg_connection* c) {
     if (c == nullptr) return;
     MG_INFO(("Sending M-SEARCH"));
     mg_printf(c, "%s",
@@ -96,51 +120,247 @@ static void sendSearch(void* param) {
               "\r\n");
 }
 
-std::vector<DlnaRenderer> UpnpDlna::searchRenderer(int timeout) {
+/// 加入 SSDP 多播组以接收 NOTIFY 消息
+static bool joinMulticast(struct mg_connection* c) {
+#ifdef IP_ADD_MEMBERSHIP
+#ifdef _WIN32
+    auto fd = (SOCKET)(size_t)c->fd;
+#else
+    auto fd = (int)(size_t)c->fd;
+#endif
+    struct ip_mreq mreq {};
+    mreq.imr_multiaddr.s_addr = inet_addr("239.255.255.250");
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    return setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char*)&mreq,
+                      sizeof(mreq)) == 0;
+#else
+    return false;
+#endif
+}
+
+UpnpDlna::~UpnpDlna() {
+    discoveryRunning = false;
+    if (discoveryThread.joinable()) discoveryThread.join();
+}
+
+void UpnpDlna::startDiscovery() {
+    if (discoveryUsers++ > 0) return;
+    if (!cacheLoaded) {
+        cacheLoaded = true;
+        this->loadCache();
+    }
+    if (discoveryThread.joinable()) discoveryThread.join();
+    searchReset      = true;
+    discoveryRunning = true;
+    discoveryThread  = std::thread([this]() { this->discoveryLoop(); });
+}
+
+void UpnpDlna::stopDiscovery() {
+    if (discoveryUsers <= 0 || --discoveryUsers > 0) return;
+    discoveryRunning = false;
+    if (discoveryThread.joinable()) discoveryThread.join();
+}
+
+void UpnpDlna::refresh() { searchReset = true; }
+
+std::vector<std::pair<std::string, DlnaRenderer>> UpnpDlna::getRenderers() {
+    std::vector<std::pair<std::string, DlnaRenderer>> list;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& i : devices) {
+        if (i.second.renderer.isValid())
+            list.emplace_back(i.first, i.second.renderer);
+    }
+    return list;
+}
+
+DlnaRendererAddEvent* UpnpDlna::getRendererAddEvent() {
+    return &rendererAddEvent;
+}
+
+DlnaRendererRemoveEvent* UpnpDlna::getRendererRemoveEvent() {
+    return &rendererRemoveEvent;
+}
+
+void UpnpDlna::discoveryLoop() {
     MG_INFO(("开始SSDP搜索"));
+    using Clock = std::chrono::steady_clock;
     struct mg_mgr mgr {};
-    static struct mg_connection* c;
     mg_mgr_init(&mgr);
-    c = mg_connect(&mgr, s_ssdp_url, fn, nullptr);
-    sendSearch(c);
-    rendererList.clear();
-    auto startTime = std::chrono::system_clock::now();
-    while (true) {
-        auto nowTime = std::chrono::system_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            nowTime - startTime);
-        if (elapsed.count() >= timeout) {
-            break;
+    auto* search   = mg_connect(&mgr, s_ssdp_url, fn, this);
+    auto* listener = mg_listen(&mgr, s_ssdp_listen_url, fn, this);
+    if (!listener || !joinMulticast(listener)) {
+        brls::Logger::warning("DLNA: cannot receive NOTIFY, use M-SEARCH only");
+    }
+
+    std::vector<std::pair<std::string, cpr::AsyncResponse>> pending;
+    int interval    = SEARCH_INTERVAL_MIN;
+    auto nextSearch = Clock::now();
+    auto nextSweep  = Clock::now();
+    while (discoveryRunning) {
+        auto now = Clock::now();
+        if (searchReset.exchange(false)) {
+            interval   = SEARCH_INTERVAL_MIN;
+            nextSearch = now;
+        }
+        // 重复发送 M-SEARCH，避免 UDP 丢包，间隔逐渐增加
+        if (now >= nextSearch) {
+            sendSearch(search);
+            nextSearch = now + std::chrono::milliseconds(interval);
+            interval   = std::min(interval * 2, SEARCH_INTERVAL_MAX);
+        }
+        if (now >= nextSweep) {
+            this->removeExpired();
+            this->saveCache();
+            nextSweep = now + std::chrono::seconds(1);
+        }
+
+        // 并行获取 renderer 描述信息，每个设备完成后立即处理
+        std::vector<std::pair<std::string, std::string>> queue;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.swap(fetchQueue);
+        }
+        for (auto& i : queue) {
+            brls::Logger::debug("Got renderer: {}", i.second);
+            pending.emplace_back(
+                i.first, cpr::GetAsync(cpr::Url{i.second},
+                                       cpr::Timeout{DESCRIPTION_TIMEOUT}));
         }
-        mg_mgr_poll(&mgr, 200);
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (it->second.wait_for(std::chrono::seconds(0)) !=
+                std::future_status::ready) {
+                ++it;
+                continue;
+            }
+            cpr::Response r = it->second.get();
+            this->onDescription(it->first, r.url.str(), r.status_code, r.text);
+            it = pending.erase(it);
+        }
+
+        mg_mgr_poll(&mgr, 50);
     }
     mg_mgr_free(&mgr);
-    MG_INFO(("SSDP搜索结束，开始获取renderer信息"));
-    std::vector<DlnaRenderer> list;
-
-    cpr::MultiPerform multiperform;
-    std::vector<std::shared_ptr<cpr::Session>> sessionList;
-    for (auto& i : rendererList) {
-        brls::Logger::debug("Got renderer: {}", i);
-        auto s = std::make_shared<cpr::Session>();
-        sessionList.emplace_back(s);
-        s->SetUrl(i);
-        s->SetTimeout(5000);
-        multiperform.AddSession(s);
+
+    // 放弃未完成的请求，下次收到 NOTIFY 或搜索回复时重新获取
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& i : pending) {
+            auto it = devices.find(i.first);
+            if (it != devices.end()) it->second.fetching = false;
+        }
+    }
+    this->saveCache();
+    MG_INFO(("SSDP搜索结束"));
+}
+
+void UpnpDlna::onAlive(const std::string& udn, const std::string& location,
+                       int maxAge) {
+    if (location.empty()) return;
+    std::string key = udn.empty() ? location : udn;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& device  = devices[key];
+    device.expire = (int64_t)wiliwili::getUnixTime() + maxAge;
+    if (device.location == location && (device.fetching || device.fetched))
+        return;
+    device.location = location;
+    device.fetching = true;
+    device.fetched  = false;
+    fetchQueue.emplace_back(key, location);
+}
+
+void UpnpDlna::onByeBye(const std::string& udn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = devices.find(udn);
+    if (it == devices.end()) return;
+    if (it->second.renderer.isValid()) {
+        brls::sync([this, udn]() { rendererRemoveEvent.fire(udn); });
+    }
+    devices.erase(it);
+    cacheDirty = true;
+}
+
+void UpnpDlna::onDescription(const std::string& udn, const std::string& url,
+                             long statusCode, const std::string& text) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = devices.find(udn);
+    if (it == devices.end()) return;
+    auto& device    = it->second;
+    device.fetching = false;
+    if (statusCode != 200) {
+        // 无法连接的设备 (通常来自缓存) 等待下一次 NOTIFY 或搜索回复
+        if (!device.renderer.isValid()) devices.erase(it);
+        return;
     }
-    std::vector<cpr::Response> responses = multiperform.Get();
-    for (auto& r : responses) {
-        if (r.status_code != 200) {
+    device.fetched = true;
+
+    auto renderer = DlnaRenderer::parse(text);
+    if (!renderer.isValid()) return;
+    renderer.setBaseUrl(url);
+    device.renderer = renderer;
+    cacheDirty      = true;
+    brls::sync([this, udn, renderer]() {
+        rendererAddEvent.fire(udn, renderer);
+    });
+}
+
+void UpnpDlna::removeExpired() {
+    auto now = (int64_t)wiliwili::getUnixTime();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = devices.begin(); it != devices.end();) {
+        if (it->second.expire > now || it->second.fetching) {
+            ++it;
             continue;
         }
-        auto renderer = DlnaRenderer::parse(r.text);
-        if (!renderer.isValid()) continue;
-        renderer.setBaseUrl(r.url.str());
-        list.emplace_back(renderer);
+        if (it->second.renderer.isValid()) {
+            std::string udn = it->first;
+            brls::sync([this, udn]() { rendererRemoveEvent.fire(udn); });
+        }
+        it         = devices.erase(it);
+        cacheDirty = true;
     }
+}
 
-    MG_INFO(("renderer信息获取结束"));
-    return list;
+void UpnpDlna::loadCache() {
+    const std::string path =
+        ProgramConfig::instance().getConfigDir() + "/dlna_renderer.json";
+    std::ifstream readFile(path);
+    if (!readFile) return;
+    std::vector<DlnaDeviceCache> list;
+    try {
+        nlohmann::json content;
+        readFile >> content;
+        content.get_to(list);
+    } catch (const std::exception& e) {
+        brls::Logger::error("DLNA: failed to load {}: {}", path, e.what());
+        return;
+    }
+    // 未过期的设备在搜索开始时直接获取描述信息
+    auto now = (int64_t)wiliwili::getUnixTime();
+    for (auto& i : list) {
+        if (i.expire <= now) continue;
+        this->onAlive(i.udn, i.location, (int)(i.expire - now));
+    }
+}
+
+void UpnpDlna::saveCache() {
+    std::vector<DlnaDeviceCache> list;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!cacheDirty) return;
+        cacheDirty = false;
+        for (auto& i : devices) {
+            if (!i.second.renderer.isValid()) continue;
+            list.push_back({i.first, i.second.location, i.second.expire});
+        }
+    }
+    const std::string path =
+        ProgramConfig::instance().getConfigDir() + "/dlna_renderer.json";
+    std::ofstream writeFile(path);
+    if (!writeFile) {
+        brls::Logger::error("DLNA: failed to write {}", path);
+        return;
+    }
+    writeFile << nlohmann::json(list).dump();
 }
 
 void DlnaRenderer::play(const std::string& url, const std::string& title,
@@ -30,8 +30,8 @@ void BilibiliClient::dynamic_up_list(
     const ErrorCallback& error) {
     HTTP::getResultAsync<DynamicUpListResultWrapper>(
         Api::DynamicUpList, {{"teenagers_mode", "0"}},
-        [callback](const DynamicUpListResultWrapper& wrapper) {
-            callback(wrapper);
+        [callback](DynamicUpListResultWrapper wrapper) {
+            callback(std::move(wrapper));
         },
         error);
 }
@@ -49,8 +49,8 @@ void BilibiliClient::get_hots_all(
     HTTP::getResultAsync<HotsAllVideoListResultWrapper>(
         Api::HotsAll,
         {{"pn", std::to_string(index)}, {"ps", std::to_string(num)}},
-        [callback](const HotsAllVideoListResultWrapper& wrapper) {
-            callback(wrapper.list, wrapper.no_more);
+        [callback](HotsAllVideoListResultWrapper wrapper) {
+            callback(std::move(wrapper.list), wrapper.no_more);
         },
         error);
 }
@@ -61,8 +61,8 @@ void BilibiliClient::get_hots_weekly_list(
     const ErrorCallback& error) {
     HTTP::getResultAsync<HotsWeeklyResultWrapper>(
         Api::HotsWeeklyList, {},
-        [callback](const HotsWeeklyResultWrapper& wrapper) {
-            callback(wrapper.list);
+        [callback](HotsWeeklyResultWrapper wrapper) {
+            callback(std::move(wrapper.list));
         },
         error);
 }
@@ -75,8 +75,9 @@ void BilibiliClient::get_hots_weekly(
     const ErrorCallback& error) {
     HTTP::getResultAsync<HotsWeeklyVideoListResultWrapper>(
         Api::HotsWeekly, {{"number", std::to_string(number)}},
-        [callback](const HotsWeeklyVideoListResultWrapper& wrapper) {
-            callback(wrapper.list, wrapper.config.label, wrapper.reminder);
+        [callback](HotsWeeklyVideoListResultWrapper wrapper) {
+            callback(std::move(wrapper.list), std::move(wrapper.config.label),
+                     std::move(wrapper.reminder));
         },
         error);
 }
@@ -88,8 +89,8 @@ void BilibiliClient::get_hots_history(
     const ErrorCallback& error) {
     HTTP::getResultAsync<HotsHistoryVideoListResultWrapper>(
         Api::HotsHistory, {},
-        [callback](const HotsHistoryVideoListResultWrapper& wrapper) {
-            callback(wrapper.list, wrapper.explain);
+        [callback](HotsHistoryVideoListResultWrapper wrapper) {
+            callback(std::move(wrapper.list), std::move(wrapper.explain));
         },
         error);
 }
@@ -101,7 +102,9 @@ void BilibiliClient::get_hots_rank(
     const ErrorCallback& error) {
     HTTP::getResultAsync<HotsRankVideoListResultWrapper>(
         Api::HotsRank, {{"rid", std::to_string(rid)}, {"type", type}},
-        [callback](auto wrapper) { callback(wrapper.list, wrapper.note); },
+        [callback](auto wrapper) {
+            callback(std::move(wrapper.list), std::move(wrapper.note));
+        },
         error);
 }
 
@@ -115,7 +118,9 @@ void BilibiliClient::get_hots_rank_pgc(
         Api::HotsRankPGC,
         {{"season_type", std::to_string(season_type)},
          {"day", std::to_string(day)}},
-        [callback](auto wrapper) { callback(wrapper.list, wrapper.note); },
+        [callback](auto wrapper) {
+            callback(std::move(wrapper.list), std::move(wrapper.note));
+        },
         error);
 }
 
@@ -136,7 +141,7 @@ void BilibiliClient::get_live_recommend(
             {"source_name", source},
             {"mobi_app", "pc_electron"},
         },
-        [callback](auto wrapper) { callback(wrapper); }, error, true);
+        [callback](auto wrapper) { callback(std::move(wrapper)); }, error, true);
 }
 
 /// 主页 二级分区直播推荐，不包含关注
@@ -154,7 +159,7 @@ void BilibiliClient::get_live_recommend_second(
             {"platform", "web"},
             {"device", "switch"},
         },
-        [callback](auto wrapper) { callback(wrapper); }, error, true);
+        [callback](auto wrapper) { callback(std::move(wrapper)); }, error, true);
 }
 
 /// 主页 直播分区列表
@@ -166,7 +171,7 @@ void BilibiliClient::get_live_area_list(
         {
             {"platform", "web"},
         },
-        [callback](auto wrapper) { callback(wrapper); }, error, true);
+        [callback](auto wrapper) { callback(std::move(wrapper)); }, error, true);
 }
 
 /// 主页 追番列表
@@ -180,7 +185,7 @@ void BilibiliClient::get_bangumi(
             {"is_refresh", std::to_string(is_refresh)},
             {"cursor", cursor},
         },
-        [callback](auto wrapper) { callback(wrapper); }, error);
+        [callback](auto wrapper) { callback(std::move(wrapper)); }, error);
 }
 
 /// 主页 影视列表
@@ -194,7 +199,7 @@ void BilibiliClient::get_cinema(
             {"is_refresh", std::to_string(is_refresh)},
             {"cursor", cursor},
         },
-        [callback](auto wrapper) { callback(wrapper); }, error);
+        [callback](auto wrapper) { callback(std::move(wrapper)); }, error);
 }
 
 /// 主页 追番/影视 分类检索
@@ -204,7 +209,7 @@ void BilibiliClient::get_pgc_index(
     const ErrorCallback& error) {
     HTTP::getResultAsync<PGCIndexResultWrapper>(
         Api::PGCIndex + "?" + param + "&page=" + std::to_string(page), {},
-        [callback](auto wrapper) { callback(wrapper); }, error);
+        [callback](auto wrapper) { callback(std::move(wrapper)); }, error);
 }
 
 /// 主页 追番/影视 获取分类
@@ -218,7 +223,7 @@ void BilibiliClient::get_pgc_filter(
             {"type", "2"},
             {"index_type", index_type},
         },
-        [callback](auto wrapper) { callback(wrapper); }, error);
+        [callback](auto wrapper) { callback(std::move(wrapper)); }, error);
 }
 
 /// 主页 追番/影视 获取全部分类
@@ -232,7 +232,7 @@ void BilibiliClient::get_live_pay_info(
                             nlohmann::json res = nlohmann::json::parse(r.text);
                             auto ret = res.at("data").get<LivePayInfo>();
                             ret.message = res.at("message").get<std::string>();
-                            CALLBACK(ret);
+                            CALLBACK(std::move(ret));
                         } catch (const std::exception& e) {
                             ERROR_MSG("cannot get live pay info");
                         }
@@ -292,9 +292,9 @@ void BilibiliClient::get_danmaku(
     unsigned int cid, const std::function<void(std::string)>& callback,
     const ErrorCallback& error) {
     cpr::GetCallback<>(
-        [callback, error](const cpr::Response& r) {
+        [callback, error](cpr::Response r) {
             try {
-                callback(r.text);
+                callback(std::move(r.text));
             } catch (const std::exception& e) {
                 ERROR_MSG("Network error. [Status code: " +
                               std::to_string(r.status_code) + " ]",
@@ -11,13 +11,17 @@
 #include "view/video_card.hpp"
 #include "utils/image_helper.hpp"
 #include "utils/activity_helper.hpp"
+#include "utils/xml_layout.hpp"
+#include "utils/feed_dedup.hpp"
+#include "utils/feed_snapshot.hpp"
+#include "utils/startup_profiler.hpp"
 
 using namespace brls::literals;
 
 class DynamicUserInfoView : public RecyclingGridItem {
 public:
     explicit DynamicUserInfoView(const std::string& xml) {
-        this->inflateFromXMLRes(xml);
+        XMLLayout::inflate(this, xml);
     }
 
     void setUserInfo(const std::string& avatar, const std::string& username,
@@ -95,7 +99,9 @@ private:
 class DataSourceDynamicVideoList : public RecyclingGridDataSource {
 public:
     explicit DataSourceDynamicVideoList(bilibili::DynamicVideoListResult result)
-        : list(std::move(result)) {}
+        : list(std::move(result)) {
+        dedup.reset(list, getKey);
+    }
     RecyclingGridItem* cellForRow(RecyclingGrid* recycler,
                                   size_t index) override {
         //从缓存列表中取出 或者 新生成一个表单项
@@ -114,30 +120,35 @@ public:
         Intent::openBV(list[index].bvid);
     }
 
-    void appendData(const bilibili::DynamicVideoListResult& data) {
-        bool skip = false;
-        for (const auto& i : data) {
-            skip = false;
-            for (const auto& j : this->list) {
-                if (j.aid == i.aid) {
-                    skip = true;
-                    break;
-                }
-            }
-            if (!skip) {
-                this->list.push_back(i);
-            }
-        }
+    /// 返回去重后实际追加的数量
+    size_t appendData(const bilibili::DynamicVideoListResult& data) {
+        return dedup.append(this->list, data, getKey);
     }
 
-    void clearData() override { this->list.clear(); }
+    bool hasItemKey() override { return true; }
+
+    int64_t getItemKey(size_t index) override { return list[index].aid; }
+
+    /// 使用第一页的数据替换全部内容
+    void resetData(const bilibili::DynamicVideoListResult& data) {
+        this->clearData();
+        this->appendData(data);
+    }
+
+    void clearData() override {
+        this->list.clear();
+        this->dedup.clear();
+    }
 
 private:
     bilibili::DynamicVideoListResult list;
+    FeedDedup<int> dedup;
+
+    static int getKey(const bilibili::DynamicVideoResult& i) { return i.aid; }
 };
 
 DynamicTab::DynamicTab() {
-    this->inflateFromXMLRes("xml/fragment/dynamic_tab.xml");
+    XMLLayout::inflate(this, "xml/fragment/dynamic_tab.xml");
     brls::Logger::debug("Fragment DynamicTab: create");
 
     // 初始化左侧Up主列表
@@ -155,6 +166,8 @@ DynamicTab::DynamicTab() {
     videoRecyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemVideoCard::create(); });
     videoRecyclingGrid->onNextPage([this]() {
+        // 快照之后的内容需要从第一页开始请求
+        if (this->showingSnapshot) return;
         //自动加载下一页
         this->DynamicVideoRequest::requestData();
     });
@@ -174,6 +187,16 @@ DynamicTab::DynamicTab() {
             this->DynamicVideoRequest::requestData(true);
         }
     });
+
+    // 先显示上次保存的快照，请求完成后替换
+    bilibili::DynamicVideoListResult snapshot;
+    if (FeedSnapshot::instance().get("dynamic", snapshot) &&
+        !snapshot.empty()) {
+        videoRecyclingGrid->setDataSource(
+            new DataSourceDynamicVideoList(snapshot));
+        this->showingSnapshot = true;
+        StartupProfiler::instance().markFirstContent("snapshot");
+    }
     this->DynamicVideoRequest::requestData();
 }
 
@@ -230,11 +253,24 @@ void DynamicTab::onDynamicVideoList(
         auto* datasource = dynamic_cast<DataSourceDynamicVideoList*>(
             videoRecyclingGrid->getDataSource());
         if (datasource && index != 1) {
-            datasource->appendData(result);
+            size_t count = datasource->appendData(result);
+            videoRecyclingGrid->notifyDataChanged();
+            // 整页内容都已经显示过时继续加载下一页
+            if (count == 0 && !result.empty())
+                videoRecyclingGrid->forceRequestNextPage();
+        } else if (datasource) {
+            // 替换启动时显示的快照
+            datasource->resetData(result);
             videoRecyclingGrid->notifyDataChanged();
+            videoRecyclingGrid->forceRequestNextPage();
         } else {
             videoRecyclingGrid->setDataSource(
                 new DataSourceDynamicVideoList(result));
         }
+        if (index != 1) return;
+        this->showingSnapshot = false;
+        StartupProfiler::instance().markFirstContent("network");
+        // 只保存全部动态
+        if (currentUser == 0) FeedSnapshot::instance().set("dynamic", result);
     });
 }
\ No newline at end of file
@@ -6,11 +6,12 @@
 #include "view/auto_tab_frame.hpp"
 #include "view/recycling_grid.hpp"
 #include "view/video_card.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
 HomeBangumi::HomeBangumi() {
-    this->inflateFromXMLRes("xml/fragment/home_bangumi.xml");
+    XMLLayout::inflate(this, "xml/fragment/home_bangumi.xml");
     brls::Logger::debug("Fragment HomeBangumi: create");
     this->tabFrame->setRefreshAction([this]() {
         AutoTabFrame::focus2Sidebar(this);
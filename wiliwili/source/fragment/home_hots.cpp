@@ -3,9 +3,10 @@
 //
 
 #include "fragment/home_hots.hpp"
+#include "utils/xml_layout.hpp"
 
 HomeHots::HomeHots() {
-    this->inflateFromXMLRes("xml/fragment/home_hots.xml");
+    XMLLayout::inflate(this, "xml/fragment/home_hots.xml");
     brls::Logger::debug("Fragment HomeHots: create");
 }
 
@@ -3,61 +3,125 @@
 //
 
 #include "fragment/home_hots_all.hpp"
+#include "bilibili.h"
 
 #include <utility>
 #include "view/video_card.hpp"
 #include "view/recycling_grid.hpp"
+#include "view/windowed_data_source.hpp"
 #include "utils/activity_helper.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
+#include "utils/feed_dedup.hpp"
+#include "utils/feed_snapshot.hpp"
+#include "utils/startup_profiler.hpp"
 
 using namespace brls::literals;
 
-class DataSourceHotsAllVideoList : public RecyclingGridDataSource {
+class DataSourceHotsAllVideoList
+    : public WindowedDataSource<bilibili::HotsAllVideoResult> {
 public:
-    explicit DataSourceHotsAllVideoList(bilibili::HotsAllVideoListResult result)
-        : videoList(std::move(result)) {}
+    explicit DataSourceHotsAllVideoList(
+        const bilibili::HotsAllVideoListResult& result) {
+        this->appendData(result, 1);
+    }
     RecyclingGridItem* cellForRow(RecyclingGrid* recycler,
                                   size_t index) override {
+        auto* r = this->getItem(recycler, index);
+        if (!r) return placeholder(recycler);
+
         //从缓存列表中取出 或者 新生成一个表单项
         RecyclingGridItemVideoCard* item =
             (RecyclingGridItemVideoCard*)recycler->dequeueReusableCell("Cell");
 
-        bilibili::HotsAllVideoResult& r = this->videoList[index];
-        brls::Logger::debug("title: {}", r.title);
-        item->setCard(r.pic + ImageHelper::h_ext, r.title, r.owner.name,
-                      r.pubdate, r.stat.view, r.stat.danmaku, r.duration);
+        item->setCard(r->pic + ImageHelper::h_ext, r->title, r->owner.name,
+                      r->pubdate, r->stat.view, r->stat.danmaku, r->duration);
         return item;
     }
 
-    size_t getItemCount() override { return videoList.size(); }
-
     void onItemSelected(RecyclingGrid* recycler, size_t index) override {
-        Intent::openBV(videoList[index].bvid);
+        auto* r = this->getItem(recycler, index);
+        if (r) Intent::openBV(r->bvid);
+    }
+
+    /// 返回去重后实际追加的数量
+    size_t appendData(const bilibili::HotsAllVideoListResult& data,
+                      int index) {
+        bilibili::HotsAllVideoListResult list;
+        size_t count = dedup.append(
+            list, data,
+            [](const bilibili::HotsAllVideoResult& i) { return i.aid; });
+        this->appendPage(std::move(list), index);
+        return count;
+    }
+
+    void clearData() override {
+        WindowedDataSource::clearData();
+        this->dedup.clear();
+    }
+
+    /// 使用第一页的数据替换全部内容
+    void resetData(const bilibili::HotsAllVideoListResult& data) {
+        this->clearData();
+        this->appendData(data, 1);
     }
 
-    void appendData(const bilibili::HotsAllVideoListResult& data) {
-        this->videoList.insert(this->videoList.end(), data.begin(), data.end());
+protected:
+    int64_t getKey(const bilibili::HotsAllVideoResult& item) override {
+        return item.aid;
     }
 
-    void clearData() override { this->videoList.clear(); }
+    size_t sizeOf(const bilibili::HotsAllVideoResult& item) override {
+        return sizeof(item) + heapSize(item.bvid) + heapSize(item.pic) +
+               heapSize(item.title) + heapSize(item.owner.name) +
+               heapSize(item.owner.face);
+    }
+
+    bool markSeen(const bilibili::HotsAllVideoResult& item) override {
+        return dedup.insert(item.aid);
+    }
+
+    void loadPage(int request, const PageCallback& callback) override {
+        BILI::get_hots_all(
+            request, 40,
+            [callback](const bilibili::HotsAllVideoListResult& result, bool) {
+                callback(result);
+            },
+            [callback](BILI_ERR) {
+                brls::Logger::error("DataSourceHotsAllVideoList: {}", error);
+                callback({});
+            });
+    }
 
 private:
-    bilibili::HotsAllVideoListResult videoList;
+    FeedDedup<int> dedup;
 };
 
 HomeHotsAll::HomeHotsAll() {
-    this->inflateFromXMLRes("xml/fragment/home_hots_all.xml");
+    XMLLayout::inflate(this, "xml/fragment/home_hots_all.xml");
     brls::Logger::debug("Fragment HomeHotsAll: create");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemVideoCard::create(); });
 
-    recyclingGrid->onNextPage([this]() { this->requestData(); });
+    recyclingGrid->onNextPage([this]() {
+        // 快照之后的内容需要从第一页开始请求
+        if (this->showingSnapshot) return;
+        this->requestData();
+    });
     recyclingGrid->setRefreshAction([this]() {
         AutoTabFrame::focus2Sidebar(this);
         this->recyclingGrid->showSkeleton();
         this->requestData(true);
     });
 
+    // 先显示上次保存的快照，请求完成后替换
+    bilibili::HotsAllVideoListResult snapshot;
+    if (FeedSnapshot::instance().get("hots_all", snapshot) &&
+        !snapshot.empty()) {
+        recyclingGrid->setDataSource(new DataSourceHotsAllVideoList(snapshot));
+        this->showingSnapshot = true;
+        StartupProfiler::instance().markFirstContent("snapshot");
+    }
     this->requestData();
 }
 
@@ -67,12 +131,25 @@ void HomeHotsAll::onHotsAllVideoList(
         auto* datasource = dynamic_cast<DataSourceHotsAllVideoList*>(
             recyclingGrid->getDataSource());
         if (datasource && index != 1) {
-            datasource->appendData(result);
+            size_t count = datasource->appendData(result, index);
             recyclingGrid->notifyDataChanged();
+            // 整页内容都已经显示过时继续加载下一页
+            if (count == 0 && !result.empty())
+                recyclingGrid->forceRequestNextPage();
+        } else if (datasource) {
+            // 替换启动时显示的快照
+            datasource->resetData(result);
+            recyclingGrid->notifyDataChanged();
+            recyclingGrid->forceRequestNextPage();
         } else {
             recyclingGrid->setDataSource(
                 new DataSourceHotsAllVideoList(result));
         }
+        if (index == 1) {
+            this->showingSnapshot = false;
+            FeedSnapshot::instance().set("hots_all", result);
+            StartupProfiler::instance().markFirstContent("network");
+        }
     });
 }
 
@@ -9,6 +9,7 @@
 #include "view/recycling_grid.hpp"
 #include "utils/image_helper.hpp"
 #include "utils/activity_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -48,7 +49,7 @@ private:
 };
 
 HomeHotsHistory::HomeHotsHistory() {
-    this->inflateFromXMLRes("xml/fragment/home_hots_history.xml");
+    XMLLayout::inflate(this, "xml/fragment/home_hots_history.xml");
     brls::Logger::debug("Fragment HomeHotsHistory: create");
     this->recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemVideoCard::create(); });
@@ -11,6 +11,7 @@
 #include "view/svg_image.hpp"
 #include "utils/activity_helper.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 class DataSourceHotsRankVideoList : public RecyclingGridDataSource {
 public:
@@ -85,7 +86,7 @@ private:
 };
 
 HomeHotsRank::HomeHotsRank() {
-    this->inflateFromXMLRes("xml/fragment/home_hots_rank.xml");
+    XMLLayout::inflate(this, "xml/fragment/home_hots_rank.xml");
     brls::Logger::debug("Fragment HomeHotsRank: create");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemRankVideoCard::create(); });
@@ -10,6 +10,7 @@
 #include "view/grid_dropdown.hpp"
 #include "utils/activity_helper.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -48,7 +49,7 @@ private:
 };
 
 HomeHotsWeekly::HomeHotsWeekly() {
-    this->inflateFromXMLRes("xml/fragment/home_hots_weekly.xml");
+    XMLLayout::inflate(this, "xml/fragment/home_hots_weekly.xml");
     brls::Logger::debug("Fragment HomeHotsWeekly: create");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemVideoCard::create(); });
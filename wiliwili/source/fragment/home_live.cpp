@@ -5,11 +5,15 @@
 #include <borealis.hpp>
 #include <utility>
 #include "fragment/home_live.hpp"
+#include "bilibili.h"
 #include "view/recycling_grid.hpp"
+#include "view/windowed_data_source.hpp"
 #include "view/video_card.hpp"
 #include "view/grid_dropdown.hpp"
 #include "utils/image_helper.hpp"
 #include "utils/activity_helper.hpp"
+#include "utils/xml_layout.hpp"
+#include "utils/feed_dedup.hpp"
 
 using namespace brls::literals;
 
@@ -138,38 +142,94 @@ protected:
     NVGcolor fontColor = brls::Application::getTheme().getColor("brls/text");
 };
 
-class DataSourceLiveVideoList : public RecyclingGridDataSource {
+class DataSourceLiveVideoList
+    : public WindowedDataSource<bilibili::LiveVideoResult> {
 public:
-    explicit DataSourceLiveVideoList(bilibili::LiveVideoListResult result)
-        : videoList(std::move(result)) {}
+    DataSourceLiveVideoList(const bilibili::LiveVideoListResult& result,
+                            int main, int sub)
+        : mainArea(main), subArea(sub) {
+        this->appendData(result, 1);
+    }
     RecyclingGridItem* cellForRow(RecyclingGrid* recycler,
                                   size_t index) override {
+        auto* r = this->getItem(recycler, index);
+        if (!r) return placeholder(recycler);
+
         //从缓存列表中取出 或者 新生成一个表单项
         RecyclingGridItemLiveVideoCard* item =
             (RecyclingGridItemLiveVideoCard*)recycler->dequeueReusableCell(
                 "Cell");
 
-        bilibili::LiveVideoResult& r = this->videoList[index];
-        item->setCard(r.cover + ImageHelper::h_ext, r.title, r.uname,
-                      r.area_name, r.online, r.following);
+        item->setCard(r->cover + ImageHelper::h_ext, r->title, r->uname,
+                      r->area_name, r->online, r->following);
         return item;
     }
 
-    size_t getItemCount() override { return videoList.size(); }
-
     void onItemSelected(RecyclingGrid* recycler, size_t index) override {
-        Intent::openLive(videoList[index].roomid, videoList[index].title,
-                         videoList[index].watched_show.text_large);
+        auto* r = this->getItem(recycler, index);
+        if (r)
+            Intent::openLive(r->roomid, r->title, r->watched_show.text_large);
+    }
+
+    void appendData(const bilibili::LiveVideoListResult& data, int page) {
+        bilibili::LiveVideoListResult list;
+        dedup.append(
+            list, data,
+            [](const bilibili::LiveVideoResult& i) { return i.roomid; });
+        this->appendPage(std::move(list), page);
+    }
+
+    void clearData() override {
+        WindowedDataSource::clearData();
+        this->dedup.clear();
     }
 
-    void appendData(const bilibili::LiveVideoListResult& data) {
-        this->videoList.insert(this->videoList.end(), data.begin(), data.end());
+protected:
+    int64_t getKey(const bilibili::LiveVideoResult& item) override {
+        return item.roomid;
     }
 
-    void clearData() override { this->videoList.clear(); }
+    size_t sizeOf(const bilibili::LiveVideoResult& item) override {
+        size_t size = sizeof(item) + heapSize(item.title) +
+                      heapSize(item.uname) + heapSize(item.play_url) +
+                      heapSize(item.cover) + heapSize(item.area_name) +
+                      heapSize(item.watched_show.text_small) +
+                      heapSize(item.watched_show.text_large);
+        return size + item.quality_description.capacity() *
+                          sizeof(item.quality_description[0]);
+    }
+
+    bool markSeen(const bilibili::LiveVideoResult& item) override {
+        return dedup.insert(item.roomid);
+    }
+
+    /// 与 HomeLiveRequest::requestData 使用相同的接口
+    void loadPage(int request, const PageCallback& callback) override {
+        auto error = [callback](BILI_ERR) {
+            brls::Logger::error("DataSourceLiveVideoList: {}", error);
+            callback({});
+        };
+        if (mainArea == 0 && subArea == 0) {
+            BILI::get_live_recommend(
+                mainArea, subArea, request, "pc",
+                [callback](const auto& result) {
+                    bilibili::LiveVideoListResult res = result.my_list;
+                    res.insert(res.end(), result.card_list.begin(),
+                               result.card_list.end());
+                    callback(res);
+                },
+                error);
+        } else {
+            BILI::get_live_recommend_second(
+                mainArea, subArea, request,
+                [callback](const auto& result) { callback(result.list); },
+                error);
+        }
+    }
 
 private:
-    bilibili::LiveVideoListResult videoList;
+    int mainArea, subArea;
+    FeedDedup<int> dedup;
 };
 
 typedef brls::Event<const bilibili::LiveFullAreaResult> AreaSelectedEvent;
@@ -261,7 +321,7 @@ public:
     HomeLiveArea(const bilibili::LiveFullAreaListResult& result, int mainID,
                  int subID)
         : areaList(result) {
-        this->inflateFromXMLRes("xml/fragment/home_live_area.xml");
+        XMLLayout::inflate(this, "xml/fragment/home_live_area.xml");
 
         mainGrid->registerCell("Cell",
                                []() { return GridMainAreaCell::create(); });
@@ -344,7 +404,7 @@ private:
 };
 
 HomeLive::HomeLive() {
-    this->inflateFromXMLRes("xml/fragment/home_live.xml");
+    XMLLayout::inflate(this, "xml/fragment/home_live.xml");
     brls::Logger::debug("Fragment HomeLive: create");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemLiveVideoCard::create(); });
@@ -367,14 +427,14 @@ void HomeLive::onLiveList(const bilibili::LiveVideoListResult& result,
             recyclingGrid->getDataSource());
         if (datasource && index != 1) {
             if (result.empty()) return;
-            datasource->appendData(result);
+            datasource->appendData(result, index);
             recyclingGrid->notifyDataChanged();
         } else {
             if (result.empty())
                 recyclingGrid->setEmpty();
             else
-                recyclingGrid->setDataSource(
-                    new DataSourceLiveVideoList(result));
+                recyclingGrid->setDataSource(new DataSourceLiveVideoList(
+                    result, staticMain, staticSub));
         }
     });
 }
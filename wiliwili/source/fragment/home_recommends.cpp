@@ -3,80 +3,136 @@
 //
 
 #include "fragment/home_recommends.hpp"
+#include "bilibili.h"
 
 #include <utility>
 #include "view/recycling_grid.hpp"
+#include "view/windowed_data_source.hpp"
 #include "view/video_card.hpp"
 #include "utils/number_helper.hpp"
 #include "utils/activity_helper.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
+#include "utils/feed_dedup.hpp"
+#include "utils/feed_snapshot.hpp"
+#include "utils/startup_profiler.hpp"
 
 using namespace brls::literals;
 
 /// DataSourceRecommendVideoList
 
-class DataSourceRecommendVideoList : public RecyclingGridDataSource {
+class DataSourceRecommendVideoList
+    : public WindowedDataSource<bilibili::RecommendVideoResult> {
 public:
     explicit DataSourceRecommendVideoList(
-        bilibili::RecommendVideoListResult result)
-        : recommendList(std::move(result)) {}
+        const bilibili::RecommendVideoListResult& result) {
+        this->appendData(result, 1);
+    }
     RecyclingGridItem* cellForRow(RecyclingGrid* recycler,
                                   size_t index) override {
+        auto* r = this->getItem(recycler, index);
+        if (!r) return placeholder(recycler);
+
         //从缓存列表中取出 或者 新生成一个表单项
         RecyclingGridItemVideoCard* item =
             (RecyclingGridItemVideoCard*)recycler->dequeueReusableCell("Cell");
 
-        bilibili::RecommendVideoResult& r = this->recommendList[index];
-        item->setCard(r.pic + ImageHelper::h_ext, r.title, r.owner.name,
-                      r.pubdate, r.stat.view, r.stat.danmaku, r.duration,
-                      r.rcmd_reason.content);
+        item->setCard(r->pic + ImageHelper::h_ext, r->title, r->owner.name,
+                      r->pubdate, r->stat.view, r->stat.danmaku, r->duration,
+                      r->rcmd_reason.content);
         return item;
     }
 
-    size_t getItemCount() override { return recommendList.size(); }
-
     void onItemSelected(RecyclingGrid* recycler, size_t index) override {
-        Intent::openBV(recommendList[index].bvid);
+        auto* r = this->getItem(recycler, index);
+        if (r) Intent::openBV(r->bvid);
     }
 
-    void appendData(const bilibili::RecommendVideoListResult& data) {
-        //todo: 研究一下多线程条件下的问题
-        //todo: 性能更强地去重
+    /// 追加数据并去除重复的视频，返回实际追加的数量
+    size_t appendData(const bilibili::RecommendVideoListResult& data,
+                      int requestIndex) {
         brls::Logger::debug("DataSourceRecommendVideoList: append data");
-        bool skip = false;
-        for (const auto& i : data) {
-            skip = false;
-            for (const auto& j : this->recommendList) {
-                if (j.cid == i.cid) {
-                    skip = true;
-                    break;
-                }
-            }
-            if (!skip) {
-                this->recommendList.push_back(i);
-            }
-        }
+        bilibili::RecommendVideoListResult list;
+        size_t count = dedup.append(
+            list, data,
+            [](const bilibili::RecommendVideoResult& i) { return i.id; });
+        this->appendPage(std::move(list), requestIndex);
+        return count;
+    }
+
+    void clearData() override {
+        WindowedDataSource::clearData();
+        this->dedup.clear();
+    }
+
+    /// 使用第一页的数据替换全部内容
+    void resetData(const bilibili::RecommendVideoListResult& data) {
+        this->clearData();
+        this->appendData(data, 1);
+    }
+
+protected:
+    int64_t getKey(const bilibili::RecommendVideoResult& item) override {
+        return item.id;
     }
 
-    void clearData() override { this->recommendList.clear(); }
+    size_t sizeOf(const bilibili::RecommendVideoResult& item) override {
+        return sizeof(item) + heapSize(item.bvid) + heapSize(item.pic) +
+               heapSize(item.title) + heapSize(item.owner.name) +
+               heapSize(item.owner.face) + heapSize(item.rcmd_reason.content);
+    }
+
+    bool markSeen(const bilibili::RecommendVideoResult& item) override {
+        return dedup.insert(item.id);
+    }
+
+    /// 推荐内容每次请求都不相同，恢复时使用新的推荐填充原来的位置
+    void loadPage(int request, const PageCallback& callback) override {
+        static int y_num =
+            (int)brls::getStyle().getMetric("wiliwili/grid/span/4");
+        BILI::get_recommend(
+            request, 30, 4, "V1", 3, y_num,
+            [callback](
+                const bilibili::RecommendVideoListResultWrapper& result) {
+                callback(result.item);
+            },
+            [callback](BILI_ERR) {
+                brls::Logger::error("DataSourceRecommendVideoList: {}", error);
+                callback({});
+            });
+    }
 
 private:
-    bilibili::RecommendVideoListResult recommendList;
+    FeedDedup<int> dedup;
 };
 
 /// HomeRecommends
 
 HomeRecommends::HomeRecommends() {
-    this->inflateFromXMLRes("xml/fragment/home_recommends.xml");
+    XMLLayout::inflate(this, "xml/fragment/home_recommends.xml");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemVideoCard::create(); });
-    recyclingGrid->onNextPage([this]() { this->requestData(); });
+    recyclingGrid->onNextPage([this]() {
+        // 快照之后的内容需要从第一页开始请求
+        if (this->showingSnapshot) return;
+        this->requestData();
+    });
     recyclingGrid->setRefreshAction([this]() {
         brls::Logger::debug("refresh home recommends");
         AutoTabFrame::focus2Sidebar(this);
         this->recyclingGrid->showSkeleton();
         this->requestData(true);
     });
+
+    // 先显示上次保存的快照，请求完成后替换
+    bilibili::RecommendVideoListResult snapshot;
+    if (FeedSnapshot::instance().get("recommend", snapshot) &&
+        !snapshot.empty()) {
+        recyclingGrid->setDataSource(
+            new DataSourceRecommendVideoList(snapshot));
+        this->showingSnapshot = true;
+        StartupProfiler::instance().markFirstContent("snapshot");
+    }
     this->requestData();
 }
 
@@ -97,13 +153,27 @@ void HomeRecommends::onRecommendVideoList(
         if (datasource && result.requestIndex != 1) {
             brls::Logger::debug("refresh home recommends: auto load {}",
                                 result.requestIndex);
-            datasource->appendData(result.item);
+            size_t count =
+                datasource->appendData(result.item, result.requestIndex);
             recyclingGrid->notifyDataChanged();
+            // 整页内容都已经显示过时继续加载下一页
+            if (count == 0 && !result.item.empty())
+                recyclingGrid->forceRequestNextPage();
+        } else if (datasource) {
+            brls::Logger::verbose("refresh home recommends: replace snapshot");
+            datasource->resetData(result.item);
+            recyclingGrid->notifyDataChanged();
+            recyclingGrid->forceRequestNextPage();
         } else {
             brls::Logger::verbose("refresh home recommends: first page");
             recyclingGrid->setDataSource(
                 new DataSourceRecommendVideoList(result.item));
         }
+        if (result.requestIndex == 1) {
+            this->showingSnapshot = false;
+            FeedSnapshot::instance().set("recommend", result.item);
+            StartupProfiler::instance().markFirstContent("network");
+        }
     });
 }
 
@@ -7,11 +7,12 @@
 #include "fragment/home_tab.hpp"
 #include "view/custom_button.hpp"
 #include "utils/activity_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
 HomeTab::HomeTab() {
-    this->inflateFromXMLRes("xml/fragment/home_tab.xml");
+    XMLLayout::inflate(this, "xml/fragment/home_tab.xml");
     brls::Logger::debug("Fragment HomeTab: create");
 }
 
@@ -10,6 +10,7 @@
 #include "utils/config_helper.hpp"
 #include "utils/image_helper.hpp"
 #include "view/text_box.hpp"
+#include "utils/xml_layout.hpp"
 
 static inline bool isSeparator(const std::string& text) {
     return std::all_of(text.begin(), text.end(),
@@ -75,7 +76,7 @@ static inline std::string getImageUrl(const std::string& test, int& maxHeight,
     }
 
 LatestUpdate::LatestUpdate(const ReleaseNote& info) {
-    this->inflateFromXMLRes("xml/fragment/latest_update.xml");
+    XMLLayout::inflate(this, "xml/fragment/latest_update.xml");
     brls::Logger::debug("Fragment LatestUpdate: create");
 
     header->setText(info.name);
@@ -9,6 +9,7 @@
 #include "view/video_card.hpp"
 #include "utils/image_helper.hpp"
 #include "utils/activity_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -49,7 +50,7 @@ private:
 };
 
 MineBangumi::MineBangumi() {
-    this->inflateFromXMLRes("xml/fragment/mine_bangumi.xml");
+    XMLLayout::inflate(this, "xml/fragment/mine_bangumi.xml");
     brls::Logger::debug("Fragment MineBangumi: create");
 
     this->registerFloatXMLAttribute("type", [this](float value) {
@@ -9,6 +9,7 @@
 #include "view/video_card.hpp"
 #include "utils/number_helper.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -99,7 +100,7 @@ private:
 };
 
 MineCollection::MineCollection() {
-    this->inflateFromXMLRes("xml/fragment/mine_collection.xml");
+    XMLLayout::inflate(this, "xml/fragment/mine_collection.xml");
     brls::Logger::debug("Fragment MineCollection: create");
 
     this->registerFloatXMLAttribute("type", [this](float value) {
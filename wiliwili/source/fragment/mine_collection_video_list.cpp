@@ -10,6 +10,7 @@
 #include "utils/image_helper.hpp"
 #include "utils/activity_helper.hpp"
 #include "bilibili.h"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -63,7 +64,7 @@ private:
 
 MineCollectionVideoList::MineCollectionVideoList() {
     brls::Logger::debug("Fragment MineCollectionVideoList: create");
-    this->inflateFromXMLRes("xml/fragment/mine_collection_video_list.xml");
+    XMLLayout::inflate(this, "xml/fragment/mine_collection_video_list.xml");
     registerFloatXMLAttribute("type", [this](float value) {
         if (this->collectionData.id != 0)
             brls::fatal("You must set type before collection id.");
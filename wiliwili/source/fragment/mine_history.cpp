@@ -9,6 +9,7 @@
 #include "utils/number_helper.hpp"
 #include "utils/activity_helper.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -58,6 +59,20 @@ public:
 
     size_t getItemCount() override { return list.size(); }
 
+    bool hasItemKey() override { return true; }
+
+    int64_t getItemKey(size_t index) override {
+        auto& data = list[index].history;
+        return (int64_t)std::hash<std::string>{}(data.business) * 31 +
+               data.oid;
+    }
+
+    /// 重新观看后进度与观看时间会变化
+    size_t getItemHash(size_t index) override {
+        auto& r = list[index];
+        return ((size_t)r.view_at * 31 + r.progress) * 31 + r.live_status;
+    }
+
     void onItemSelected(RecyclingGrid* recycler, size_t index) override {
         auto& data = list[index].history;
 
@@ -106,6 +121,10 @@ public:
         this->list.insert(this->list.end(), data.begin(), data.end());
     }
 
+    void resetData(const bilibili::HistoryVideoListResult& data) {
+        this->list = data;
+    }
+
     void clearData() override { this->list.clear(); }
 
 private:
@@ -113,7 +132,7 @@ private:
 };
 
 MineHistory::MineHistory() {
-    this->inflateFromXMLRes("xml/fragment/mine_history.xml");
+    XMLLayout::inflate(this, "xml/fragment/mine_history.xml");
     brls::Logger::debug("Fragment MineHistory: create");
 
     recyclingGrid->registerCell(
@@ -121,7 +140,10 @@ MineHistory::MineHistory() {
     recyclingGrid->onNextPage([this]() { this->requestData(); });
     recyclingGrid->setRefreshAction([this]() {
         AutoTabFrame::focus2Sidebar(this);
-        this->recyclingGrid->showSkeleton();
+        // 已有数据时在原列表上更新，只刷新变化的部分
+        if (!dynamic_cast<DataSourceMineHistoryVideoList*>(
+                recyclingGrid->getDataSource()))
+            this->recyclingGrid->showSkeleton();
         this->requestData(true);
     });
     this->requestData();
@@ -155,6 +177,9 @@ void MineHistory::onHistoryList(
         if (datasource && view_at != 0) {
             datasource->appendData(result.list);
             recyclingGrid->notifyDataChanged();
+        } else if (datasource && !result.list.empty()) {
+            datasource->resetData(result.list);
+            recyclingGrid->notifyDataChanged();
         } else {
             recyclingGrid->setDataSource(
                 new DataSourceMineHistoryVideoList(result.list));
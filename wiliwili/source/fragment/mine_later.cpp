@@ -9,6 +9,7 @@
 #include "utils/number_helper.hpp"
 #include "utils/activity_helper.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -40,7 +41,7 @@ private:
 };
 
 MineLater::MineLater() {
-    this->inflateFromXMLRes("xml/fragment/mine_later.xml");
+    XMLLayout::inflate(this, "xml/fragment/mine_later.xml");
     brls::Logger::debug("frag mine later created");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemVideoCard::create(); });
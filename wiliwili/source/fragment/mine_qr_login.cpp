@@ -6,9 +6,10 @@
 #include "fragment/mine_qr_login.hpp"
 #include "utils/config_helper.hpp"
 #include "bilibili/result/mine_result.h"
+#include "utils/xml_layout.hpp"
 
 MineQrLogin::MineQrLogin(loginStatusEvent cb) : loginCb(std::move(cb)) {
-    this->inflateFromXMLRes("xml/fragment/mine_qr_login.xml");
+    XMLLayout::inflate(this, "xml/fragment/mine_qr_login.xml");
     brls::Logger::debug("Fragment MineQrLogin: create");
     this->getLoginUrl();
 }
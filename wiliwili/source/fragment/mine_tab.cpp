@@ -15,12 +15,13 @@
 #include "fragment/mine_later.hpp"
 
 #include "bilibili/result/mine_result.h"
+#include "utils/xml_layout.hpp"
 
 using namespace brls;
 using namespace brls::literals;
 
 MineTab::MineTab() {
-    this->inflateFromXMLRes("xml/fragment/mine_tab.xml");
+    XMLLayout::inflate(this, "xml/fragment/mine_tab.xml");
     brls::Logger::debug("Fragment MineTab: create");
 
     this->loginCb.subscribe([this](bilibili::LoginInfo status) {
@@ -8,14 +8,15 @@
 #include "utils/vibration_helper.hpp"
 #include "utils/string_helper.hpp"
 #include "bilibili.h"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
 PlayerCoin::PlayerCoin() {
 #if defined(__PSV__) || defined(PS4)
-    this->inflateFromXMLRes("xml/fragment/player_coin_psv.xml");
+    XMLLayout::inflate(this, "xml/fragment/player_coin_psv.xml");
 #else
-    this->inflateFromXMLRes("xml/fragment/player_coin.xml");
+    XMLLayout::inflate(this, "xml/fragment/player_coin.xml");
 #endif
     brls::Logger::debug("Fragment PlayerCoin: create");
 
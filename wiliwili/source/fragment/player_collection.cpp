@@ -8,6 +8,7 @@
 #include "utils/config_helper.hpp"
 #include "view/recycling_grid.hpp"
 #include "view/check_box.hpp"
+#include "utils/xml_layout.hpp"
 #include <pystring.h>
 
 using namespace brls::literals;
@@ -20,7 +21,7 @@ typedef struct CollectionListRequest {
 class CollectionListCell : public RecyclingGridItem {
 public:
     CollectionListCell() {
-        this->inflateFromXMLRes("xml/views/collection_list_cell.xml");
+        XMLLayout::inflate(this, "xml/views/collection_list_cell.xml");
     }
 
     void setSelected(bool selected) { this->checkbox->setChecked(selected); }
@@ -120,7 +121,7 @@ private:
 };
 
 PlayerCollection::PlayerCollection(int rid, int type) {
-    this->inflateFromXMLRes("xml/fragment/player_collection.xml");
+    XMLLayout::inflate(this, "xml/fragment/player_collection.xml");
     brls::Logger::debug("Fragment PlayerCollection: create");
     this->recyclingGrid->showSkeleton();
     this->recyclingGrid->registerCell(
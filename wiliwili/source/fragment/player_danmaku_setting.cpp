@@ -8,11 +8,12 @@
 #include "view/selector_cell.hpp"
 #include "utils/config_helper.hpp"
 #include "utils/string_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
 PlayerDanmakuSetting::PlayerDanmakuSetting() {
-    this->inflateFromXMLRes("xml/fragment/player_danmaku_setting.xml");
+    XMLLayout::inflate(this, "xml/fragment/player_danmaku_setting.xml");
     brls::Logger::debug("Fragment PlayerDanmakuSetting: create");
 
     this->registerAction("hints/cancel"_i18n, brls::BUTTON_B, [](...) {
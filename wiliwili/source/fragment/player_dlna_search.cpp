@@ -7,6 +7,7 @@
 #include "view/button_close.hpp"
 #include "utils/dialog_helper.hpp"
 #include "bilibili/result/video_detail_result.h"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -47,52 +48,49 @@ bool RepeatDuratoinTimer::onUpdate(brls::Time delta)
     return true;
 }
 
-void PlayerDlnaSearch::searchStop() {
-    running.store(false);
-    if (dlnaSearchThread.joinable()) dlnaSearchThread.join();
-    brls::Logger::debug("PlayerDlnaSearch::searchStop()");
-}
-
-void PlayerDlnaSearch::searchStart() {
-    if (PlayerDlnaSearch::isRunning()) {
-        brls::Logger::error("DLNA searching is already running");
+void PlayerDlnaSearch::addRenderer(const std::string& udn,
+                                   const DlnaRenderer& renderer) {
+    renderers[udn] = renderer;
+    auto it        = deviceCells.find(udn);
+    if (it != deviceCells.end()) {
+        if (it->second != currentCell)
+            it->second->title->setText(renderer.friendlyName);
         return;
     }
-    running.store(true);
-    if (dlnaSearchThread.joinable()) dlnaSearchThread.join();
-    ASYNC_RETAIN
-    dlnaSearchThread = std::thread([ASYNC_TOKEN](){
-        auto list = UpnpDlna::instance().searchRenderer(TIMEOUT * 1000);
-        brls::sync([ASYNC_TOKEN, list](){
-            ASYNC_RELEASE
-            brls::Logger::debug("got renderer: {}", list.size());
-            for(auto i : list) {
-                i.print();
-                auto* l = new brls::RadioCell();
-                l->title->setText(i.friendlyName);
-                deviceBox->addView(l);
-                l->registerClickAction([this, i, l](...) {
-                    if (PlayerDlnaSearch::isRunning()) return true;
-                    waitingUrl.store(true);
-                    currentCell     = l;
-                    currentRenderer = i;
-                    l->title->setText(i.friendlyName + " " +
-                                      "wiliwili/player/cast/request_url"_i18n);
-                    MPV_CE->fire("REQUEST_CAST_URL", nullptr);
-                    return true;
-                });
-            }
-            btnRefresh->title->setText("wiliwili/home/common/refresh"_i18n);
-            btnRefresh->title->setTextColor(
-                brls::Application::getTheme().getColor("brls/text"));
-            running.store(false);
-        });
+
+    auto* l = new brls::RadioCell();
+    l->title->setText(renderer.friendlyName);
+    deviceBox->addView(l);
+    deviceCells[udn] = l;
+    l->registerClickAction([this, udn, l](...) {
+        if (PlayerDlnaSearch::isRunning()) return true;
+        auto it = renderers.find(udn);
+        if (it == renderers.end()) return true;
+        it->second.print();
+        waitingUrl.store(true);
+        currentCell     = l;
+        currentRenderer = it->second;
+        l->title->setText(currentRenderer.friendlyName + " " +
+                          "wiliwili/player/cast/request_url"_i18n);
+        MPV_CE->fire("REQUEST_CAST_URL", nullptr);
+        return true;
     });
 }
 
+void PlayerDlnaSearch::removeRenderer(const std::string& udn) {
+    renderers.erase(udn);
+    auto it = deviceCells.find(udn);
+    if (it == deviceCells.end()) return;
+    auto* cell = it->second;
+    deviceCells.erase(it);
+    if (cell == currentCell) currentCell = nullptr;
+    if (brls::Application::getCurrentFocus() == cell)
+        brls::Application::giveFocus(btnRefresh);
+    deviceBox->removeView(cell);
+}
 
 PlayerDlnaSearch::PlayerDlnaSearch() {
-    this->inflateFromXMLRes("xml/fragment/player_dlna_search.xml");
+    XMLLayout::inflate(this, "xml/fragment/player_dlna_search.xml");
     brls::Logger::debug("Fragment PlayerDlnaSearch: create");
 
     this->registerAction("hints/cancel"_i18n, brls::BUTTON_B, [](...) {
@@ -186,11 +184,20 @@ PlayerDlnaSearch::PlayerDlnaSearch() {
         }
     });
 
+    auto& dlna             = UpnpDlna::instance();
+    rendererAddSubscribeID = dlna.getRendererAddEvent()->subscribe(
+        [this](const std::string& udn, const DlnaRenderer& renderer) {
+            this->addRenderer(udn, renderer);
+        });
+    rendererRemoveSubscribeID = dlna.getRendererRemoveEvent()->subscribe(
+        [this](const std::string& udn) { this->removeRenderer(udn); });
+    for (auto& i : dlna.getRenderers()) this->addRenderer(i.first, i.second);
+    dlna.startDiscovery();
+
     this->refreshRenderer();
 }
 
 void PlayerDlnaSearch::refreshRenderer() {
-    if (PlayerDlnaSearch::isRunning()) return;
     btnRefresh->title->setTextColor(brls::Application::getTheme().getColor("brls/text_disabled"));
     searchCounter.setDuration(TIMEOUT * 1000);
     searchCounter.setCallback([this](int cycleTimes){
@@ -202,20 +209,20 @@ void PlayerDlnaSearch::refreshRenderer() {
     });
     searchCounter.setPeriod(100);
     searchCounter.start();
-    deviceBox->clearViews();
-    currentRenderer.setValid(false);
-    currentCell = nullptr;
-    PlayerDlnaSearch::searchStart();
+    UpnpDlna::instance().refresh();
 }
 
 PlayerDlnaSearch::~PlayerDlnaSearch() {
     brls::Logger::debug("Fragment PlayerDlnaSearch: delete");
     MPV_CE->unsubscribe(customEventSubscribeID);
-    searchStop();
+    auto& dlna = UpnpDlna::instance();
+    dlna.getRendererAddEvent()->unsubscribe(rendererAddSubscribeID);
+    dlna.getRendererRemoveEvent()->unsubscribe(rendererRemoveSubscribeID);
+    dlna.stopDiscovery();
 }
 
 bool PlayerDlnaSearch::isTranslucent() { return true; }
 
 bool PlayerDlnaSearch::isRunning() {
-    return running.load() || waitingUrl.load() || waitingRenderer.load();
+    return waitingUrl.load() || waitingRenderer.load();
 }
@@ -3,9 +3,10 @@
 //
 
 #include "fragment/player_evaluate.hpp"
+#include "utils/xml_layout.hpp"
 
 PlayerEvaluate::PlayerEvaluate() {
-    this->inflateFromXMLRes("xml/fragment/player_evaluate.xml");
+    XMLLayout::inflate(this, "xml/fragment/player_evaluate.xml");
 }
 
 void PlayerEvaluate::setContent(const std::string& value) {
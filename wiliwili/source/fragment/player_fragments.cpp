@@ -3,11 +3,13 @@
 //
 
 #include "fragment/player_fragments.hpp"
+#include "utils/xml_layout.hpp"
+#include "utils/frame_scheduler.hpp"
 
 /// PlayerTabCell
 
 PlayerTabCell::PlayerTabCell() {
-    this->inflateFromXMLRes("xml/views/season_item_cell.xml");
+    XMLLayout::inflate(this, "xml/views/season_item_cell.xml");
     this->setHideHighlightBackground(true);
 }
 
@@ -76,13 +78,14 @@ void PlayerTabCell::draw(NVGcontext* vg, float x, float y, float width,
         nvgRect(vg, x + 25, base_y - h2, 2, h2 + h2 + 4);
         nvgRect(vg, x + 30, base_y - h3, 2, h3 + h3 + 4);
         nvgFill(vg);
+        FrameScheduler::instance().requestFrame();
     }
 }
 
 /// PlayerTabHeader
 
 PlayerTabHeader::PlayerTabHeader() {
-    this->inflateFromXMLRes("xml/views/season_header_cell.xml");
+    XMLLayout::inflate(this, "xml/views/season_header_cell.xml");
     this->setFocusable(false);
 }
 
@@ -13,11 +13,12 @@
 #include "utils/shader_helper.hpp"
 #include "utils/number_helper.hpp"
 #include "activity/player_activity.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
 PlayerSetting::PlayerSetting() {
-    this->inflateFromXMLRes("xml/fragment/player_setting.xml");
+    XMLLayout::inflate(this, "xml/fragment/player_setting.xml");
     brls::Logger::debug("Fragment PlayerSetting: create");
 
     setupCustomShaders();
@@ -15,8 +15,10 @@
 #include "utils/number_helper.hpp"
 #include "utils/string_helper.hpp"
 #include "utils/activity_helper.hpp"
+#include "utils/comment_cache.hpp"
 #include "presenter/comment_related.hpp"
 #include "bilibili.h"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -100,6 +102,10 @@ public:
 
     size_t getItemCount() override { return dataList.size(); }
 
+    bool hasItemKey() override { return true; }
+
+    int64_t getItemKey(size_t index) override { return dataList[index].rpid; }
+
     void onItemSelected(RecyclingGrid* recycler, size_t index) override {
         if (dataList[index].rpid == 0 || dataList[index].rpid == 1) {
             return;
@@ -156,9 +162,7 @@ public:
                             const bilibili::VideoCommentAddResult& result) {
                             this->dataList.insert(dataList.begin() + 2,
                                                   result.reply);
-                            recycler->reloadData();
-                            // 重新设置一下焦点到 recycler 的默认 cell （顶部）
-                            brls::Application::giveFocus(recycler);
+                            recycler->notifyDataChanged();
                         });
                 },
                 "", "", 500, "", 0);
@@ -177,9 +181,12 @@ public:
                     } else {
                         // 删除单条回复
                         dataList.erase(dataList.begin() + index);
-                        recycler->reloadData();
-                        // 重新设置一下焦点到 recycler 的默认 cell （顶部）
-                        brls::Application::giveFocus(recycler);
+                        recycler->notifyDataChanged();
+                        // 焦点交给占据原本位置的回复
+                        auto* next = recycler->getGridItemByIndex(
+                            std::min(index, dataList.size() - 1));
+                        brls::Application::giveFocus(
+                            next ? (brls::View*)next : recycler);
                         // 更新评论数量
                         this->updateCommentLabelNum(recycler,
                                                     dataList[0].rcount - 1);
@@ -236,7 +243,7 @@ private:
 /// PlayerSingleComment
 
 PlayerSingleComment::PlayerSingleComment() {
-    this->inflateFromXMLRes("xml/fragment/player_single_comment.xml");
+    XMLLayout::inflate(this, "xml/fragment/player_single_comment.xml");
     brls::Logger::debug("Fragment PlayerSingleComment: create");
 
     this->recyclingGrid->registerCell("Cell",
@@ -352,55 +359,34 @@ void PlayerSingleComment::dismiss(std::function<void(void)> cb) {
 
 void PlayerSingleComment::requestData() {
     if (cursor.is_end) return;
+
+    // 使用预加载的第一页回复
+    if (cursor.next == 0) {
+        auto data = std::make_shared<bilibili::VideoSingleCommentDetail>();
+        if (CommentCache::instance().takeThread(root.oid, root.rpid, *data)) {
+            brls::Logger::debug("使用预加载的评论: root:{}", root.rpid);
+            ASYNC_RETAIN
+            brls::sync([ASYNC_TOKEN, data]() {
+                ASYNC_RELEASE
+                this->onCommentData(*data);
+            });
+            return;
+        }
+    }
+
     brls::Logger::debug("请求评论: root:{} page:{}", root.rpid, cursor.next);
     // request comments
     ASYNC_RETAIN
     BILI::get_comment_detail(
         ProgramConfig::instance().getCSRF(), root.oid, root.rpid, cursor.next,
-        [ASYNC_TOKEN](bilibili::VideoSingleCommentDetail result) {
-            brls::sync([ASYNC_TOKEN, result]() mutable {
+        [ASYNC_TOKEN,
+         oid = root.oid](bilibili::VideoSingleCommentDetail result) {
+            // 在网络线程中预先解析评论内容
+            CommentCache::instance().parse(oid, result.root.replies);
+            brls::sync([ASYNC_TOKEN,
+                        data = wiliwili::moveToShared(std::move(result))]() {
                 ASYNC_RELEASE
-
-                brls::Logger::debug("请求评论结束: root:{} page:{} is_end:{}",
-                                    root.rpid, result.cursor.next,
-                                    result.cursor.is_end);
-                cursor.next   = result.cursor.next;
-                cursor.is_end = result.cursor.is_end;
-
-                std::string uploader_mid = std::to_string(result.upper);
-
-                auto* ds = dynamic_cast<DataSourceSingleCommentList*>(
-                    recyclingGrid->getDataSource());
-                if (!ds) return;
-
-                // 更新层主评论状态
-                if (result.cursor.is_begin) {
-                    ds->updateCommentLabelNum(recyclingGrid,
-                                              result.root.rcount);
-                    this->root = result.root;
-                    likeNumEvent.fire(result.root.like);
-                    likeStateEvent.fire(result.root.action);
-                    replyNumEvent.fire(result.root.rcount);
-                }
-
-                // 设置是否为up主
-                for (auto& i : result.root.replies)
-                    i.member.is_uploader = i.member.mid == uploader_mid;
-
-                // 根据元素的数量来检查是否加载结束，2为楼主与回复数提示
-                if (ds->getItemCount() - 2 + result.root.replies.size() >=
-                    result.root.rcount)
-                    cursor.is_end = true;
-
-                if (cursor.is_end) {
-                    bilibili::VideoCommentResult bottom;
-                    bottom.rpid = 1;
-                    result.root.replies.emplace_back(bottom);
-                }
-
-                // 非首页评论
-                ds->appendData(result.root.replies);
-                recyclingGrid->notifyDataChanged();
+                this->onCommentData(*data);
             });
         },
         [ASYNC_TOKEN](BILI_ERR) {
@@ -412,6 +398,48 @@ void PlayerSingleComment::requestData() {
         });
 }
 
+void PlayerSingleComment::onCommentData(
+    bilibili::VideoSingleCommentDetail& result) {
+    brls::Logger::debug("请求评论结束: root:{} page:{} is_end:{}", root.rpid,
+                        result.cursor.next, result.cursor.is_end);
+    cursor.next   = result.cursor.next;
+    cursor.is_end = result.cursor.is_end;
+
+    std::string uploader_mid = std::to_string(result.upper);
+
+    auto* ds = dynamic_cast<DataSourceSingleCommentList*>(
+        recyclingGrid->getDataSource());
+    if (!ds) return;
+
+    // 更新层主评论状态
+    if (result.cursor.is_begin) {
+        ds->updateCommentLabelNum(recyclingGrid, result.root.rcount);
+        this->root = result.root;
+        likeNumEvent.fire(result.root.like);
+        likeStateEvent.fire(result.root.action);
+        replyNumEvent.fire(result.root.rcount);
+    }
+
+    // 设置是否为up主
+    for (auto& i : result.root.replies)
+        i.member.is_uploader = i.member.mid == uploader_mid;
+
+    // 根据元素的数量来检查是否加载结束，2为楼主与回复数提示
+    if (ds->getItemCount() - 2 + result.root.replies.size() >=
+        result.root.rcount)
+        cursor.is_end = true;
+
+    if (cursor.is_end) {
+        bilibili::VideoCommentResult bottom;
+        bottom.rpid = 1;
+        result.root.replies.emplace_back(bottom);
+    }
+
+    // 非首页评论
+    ds->appendData(result.root.replies);
+    recyclingGrid->notifyDataChanged();
+}
+
 PlayerSingleComment::~PlayerSingleComment() {
     brls::Logger::debug("Fragment PlayerSingleComment: delete");
 }
@@ -423,7 +451,7 @@ brls::View* PlayerSingleComment::getDefaultFocus() {
 /// PlayerCommentAction
 
 PlayerCommentAction::PlayerCommentAction() {
-    this->inflateFromXMLRes("xml/fragment/player_comment_action.xml");
+    XMLLayout::inflate(this, "xml/fragment/player_comment_action.xml");
 
     this->comment->setMaxRows(SIZE_T_MAX);
 
@@ -8,9 +8,10 @@
 #include "view/video_card.hpp"
 #include "activity/search_activity.hpp"
 #include "fragment/search_tab.hpp"
+#include "utils/xml_layout.hpp"
 
 SearchBangumi::SearchBangumi() {
-    this->inflateFromXMLRes("xml/fragment/search_bangumi.xml");
+    XMLLayout::inflate(this, "xml/fragment/search_bangumi.xml");
     brls::Logger::debug("Fragment SearchBangumi: create");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemSearchPGCVideoCard::create(); });
@@ -8,9 +8,10 @@
 #include "view/video_card.hpp"
 #include "activity/search_activity.hpp"
 #include "fragment/search_tab.hpp"
+#include "utils/xml_layout.hpp"
 
 SearchCinema::SearchCinema() {
-    this->inflateFromXMLRes("xml/fragment/search_cinema.xml");
+    XMLLayout::inflate(this, "xml/fragment/search_cinema.xml");
     brls::Logger::debug("Fragment SearchCinema: create");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemSearchPGCVideoCard::create(); });
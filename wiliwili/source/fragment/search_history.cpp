@@ -8,9 +8,10 @@
 #include "view/recycling_grid.hpp"
 #include "view/hots_card.hpp"
 #include "utils/config_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 SearchHistory::SearchHistory() {
-    this->inflateFromXMLRes("xml/fragment/search_history.xml");
+    XMLLayout::inflate(this, "xml/fragment/search_history.xml");
     brls::Logger::debug("Fragment SearchHistory: create");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemHotsCard::create(); });
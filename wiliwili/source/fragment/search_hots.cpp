@@ -9,9 +9,10 @@
 #include "view/hots_card.hpp"
 #include "bilibili.h"
 #include "bilibili/result/search_result.h"
+#include "utils/xml_layout.hpp"
 
 SearchHots::SearchHots() {
-    this->inflateFromXMLRes("xml/fragment/search_hots.xml");
+    XMLLayout::inflate(this, "xml/fragment/search_hots.xml");
     brls::Logger::debug("Fragment SearchHots: create");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemHotsCard::create(); });
@@ -8,9 +8,10 @@
 #include "fragment/search_cinema.hpp"
 #include "fragment/search_hots.hpp"
 #include "fragment/search_history.hpp"
+#include "utils/xml_layout.hpp"
 
 SearchTab::SearchTab() {
-    this->inflateFromXMLRes("xml/fragment/search_tab.xml");
+    XMLLayout::inflate(this, "xml/fragment/search_tab.xml");
     brls::Logger::debug("Fragment SearchTab: create");
 
     this->registerAction(
@@ -8,9 +8,10 @@
 #include "view/video_card.hpp"
 #include "activity/search_activity.hpp"
 #include "fragment/search_tab.hpp"
+#include "utils/xml_layout.hpp"
 
 SearchVideo::SearchVideo() {
-    this->inflateFromXMLRes("xml/fragment/search_video.xml");
+    XMLLayout::inflate(this, "xml/fragment/search_video.xml");
     brls::Logger::debug("Fragment SearchVideo: create");
     recyclingGrid->registerCell(
         "Cell", []() { return RecyclingGridItemVideoCard::create(); });
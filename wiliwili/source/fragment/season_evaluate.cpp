@@ -7,9 +7,10 @@
 #include "view/button_close.hpp"
 #include "utils/string_helper.hpp"
 #include "analytics.h"
+#include "utils/xml_layout.hpp"
 
 SeasonEvaluate::SeasonEvaluate() {
-    this->inflateFromXMLRes("xml/fragment/season_evaluate.xml");
+    XMLLayout::inflate(this, "xml/fragment/season_evaluate.xml");
 
     btnDouban->registerClickAction([this](...) {
         GA("open_douban")
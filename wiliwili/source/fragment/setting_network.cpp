@@ -8,11 +8,12 @@
 #include "bilibili/result/setting.h"
 #include "utils/number_helper.hpp"
 #include "utils/config_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
 SettingNetwork::SettingNetwork() {
-    this->inflateFromXMLRes("xml/fragment/setting_network.xml");
+    XMLLayout::inflate(this, "xml/fragment/setting_network.xml");
     brls::Logger::debug("Fragment SettingNetwork: create");
     this->networkTest();
     this->getUnixTime();
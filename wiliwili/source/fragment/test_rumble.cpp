@@ -3,6 +3,7 @@
 //
 
 #include "fragment/test_rumble.hpp"
+#include "utils/xml_layout.hpp"
 #ifdef __SWITCH__
 #include "borealis/platforms/switch/switch_input.hpp"
 #endif
@@ -63,7 +64,7 @@ std::vector<std::vector<float>> TestRumble::demo2 = {
 };
 
 TestRumble::TestRumble() {
-    this->inflateFromXMLRes("xml/fragment/test_rumble.xml");
+    XMLLayout::inflate(this, "xml/fragment/test_rumble.xml");
 
     // [40, 626]
     progress1->getProgressEvent()->subscribe([this](float value) {
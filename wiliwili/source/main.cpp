@@ -16,22 +16,42 @@
 
 #include "utils/config_helper.hpp"
 #include "utils/activity_helper.hpp"
+#include "utils/download_manager.hpp"
+#include "utils/frame_scheduler.hpp"
+#include "utils/history_reporter.hpp"
+#include "utils/startup_profiler.hpp"
+#include "utils/trace_helper.hpp"
 
 #ifdef IOS
 #include <SDL2/SDL_main.h>
 #endif
 
 int main(int argc, char* argv[]) {
+    // Record the time of each startup phase
+    auto& profiler = StartupProfiler::instance();
+
     // Set log level
     brls::Logger::setLogLevel(brls::LogLevel::LOG_INFO);
 
+#ifdef PERF_TRACE
+    // Export hot path traces with: kill -USR1 <pid>
+    wiliwili::PerfTrace::installSignal();
+    TRACE_THREAD_NAME("main");
+#endif
+
     // Load cookies and settings
-    ProgramConfig::instance().init();
+    {
+        StartupProfiler::Phase phase("config_init");
+        ProgramConfig::instance().init();
+    }
 
     // Init the app and i18n
-    if (!brls::Application::init()) {
-        brls::Logger::error("Unable to init application");
-        return EXIT_FAILURE;
+    {
+        StartupProfiler::Phase phase("application_init");
+        if (!brls::Application::init()) {
+            brls::Logger::error("Unable to init application");
+            return EXIT_FAILURE;
+        }
     }
 
 #ifdef __PSV__
@@ -41,50 +61,73 @@ int main(int argc, char* argv[]) {
     // Return directly to the desktop when closing the application (only for NX)
     brls::Application::getPlatform()->exitToHomeMode(true);
 
-    brls::Application::createWindow("wiliwili");
-    brls::Logger::info("createWindow done");
+    {
+        StartupProfiler::Phase phase("create_window");
+        brls::Application::createWindow("wiliwili");
+        brls::Logger::info("createWindow done");
+    }
 
     // Register custom view\theme\style
-    Register::initCustomView();
-    Register::initCustomTheme();
-    Register::initCustomStyle();
+    {
+        StartupProfiler::Phase phase("register_custom");
+        Register::initCustomView();
+        Register::initCustomTheme();
+        Register::initCustomStyle();
+    }
 
     brls::Application::getPlatform()->disableScreenDimming(false);
 
-    if (brls::Application::getPlatform()->isApplicationMode()) {
-        Intent::openMain();
-        // Use these activities to debug
-        //        Intent::openBV("BV18W4y1q72C");  // wiliwili介绍
-        //        Intent::openBV("BV1dx411c7Av");  // flv拼接视频
-        //        Intent::openBV("BV15z4y1Z734");  // 4K HDR 视频
-        //        Intent::openBV("BV1qM4y1w716");  // 8K
-        //        Intent::openBV("BV1PN4y1G7u2");  // up主视频自动跳转番剧
-        //        Intent::openBV("BV1sK411s7zq");  // 多P视频测试
-        //        Intent::openBV("BV1Cg411j76F");  // 多字幕测试
-        //        Intent::openBV("BV1A44y1u7PF");  // 测试FFMPEG在switch上的bug（加载时间过长）
-        //        Intent::openBV("BV1U3411c7Qx");  // 测试长标题
-        //        Intent::openBV("BV1fG411W7Px");  // 测试弹幕
-        //        Intent::openSeasonByEpId(323434);// 测试电影
-        //        Intent::openLive(1942240);       // 测试直播
-        //        Intent::openSearch("harry");     // 测试搜索影片
-        //        Intent::openTVSearch();          // 测试TV搜索模式
-        //        Intent::openHint();              // 应用开启教程页面
-        //        Intent::openPgcFilter("/page/home/pgc/more?type=2&index_type=2&area=2&order=2&season_status=-1&season_status=3,6"); // 影片分类索引
-        //        Intent::openSetting();  //  设置页面
-    } else {
-        Intent::openHint();
+    {
+        StartupProfiler::Phase phase("open_main");
+        if (brls::Application::getPlatform()->isApplicationMode()) {
+            Intent::openMain();
+            // Use these activities to debug
+            //        Intent::openBV("BV18W4y1q72C");  // wiliwili介绍
+            //        Intent::openBV("BV1dx411c7Av");  // flv拼接视频
+            //        Intent::openBV("BV15z4y1Z734");  // 4K HDR 视频
+            //        Intent::openBV("BV1qM4y1w716");  // 8K
+            //        Intent::openBV("BV1PN4y1G7u2");  // up主视频自动跳转番剧
+            //        Intent::openBV("BV1sK411s7zq");  // 多P视频测试
+            //        Intent::openBV("BV1Cg411j76F");  // 多字幕测试
+            //        Intent::openBV("BV1A44y1u7PF");  // 测试FFMPEG在switch上的bug（加载时间过长）
+            //        Intent::openBV("BV1U3411c7Qx");  // 测试长标题
+            //        Intent::openBV("BV1fG411W7Px");  // 测试弹幕
+            //        Intent::openSeasonByEpId(323434);// 测试电影
+            //        Intent::openLive(1942240);       // 测试直播
+            //        Intent::openSearch("harry");     // 测试搜索影片
+            //        Intent::openTVSearch();          // 测试TV搜索模式
+            //        Intent::openHint();              // 应用开启教程页面
+            //        Intent::openPgcFilter("/page/home/pgc/more?type=2&index_type=2&area=2&order=2&season_status=-1&season_status=3,6"); // 影片分类索引
+            //        Intent::openSetting();  //  设置页面
+        } else {
+            Intent::openHint();
+        }
     }
 
-    GA("open_app",
-       {{"version", APPVersion::instance().getVersionStr()},
-        {"language", brls::Application::getLocale()},
-        {"window", fmt::format("{}x{}", brls::Application::windowWidth,
-                               brls::Application::windowHeight)}})
-    APPVersion::instance().checkUpdate();
+    // Not needed by the first frame, deferred in parallel startup mode
+    profiler.defer("open_app_ga", []() {
+        GA("open_app",
+           {{"version", APPVersion::instance().getVersionStr()},
+            {"language", brls::Application::getLocale()},
+            {"window", fmt::format("{}x{}", brls::Application::windowWidth,
+                                   brls::Application::windowHeight)}})
+    });
+    profiler.defer("check_update", []() { APPVersion::instance().checkUpdate(); });
+    // Retry watch history reports left over from the last session
+    profiler.defer("history_retry",
+                   []() { HistoryReporter::instance().flush(); });
+    // Resume offline downloads left unfinished in the last session
+    profiler.defer("download_resume",
+                   []() { DownloadManager::instance(); });
 
     // Run the app
     // brls::Application::setLimitedFPS(60);
+    auto& scheduler = FrameScheduler::instance();
     while (brls::Application::mainLoop()) {
+        profiler.onFrame();
+        TRACE_POLL();
+        // Skip redrawing while nothing on screen changes
+        scheduler.waitForNextFrame();
     }
 
     brls::Logger::info("mainLoop done");
@@ -25,7 +25,9 @@ void DynamicVideoRequest::requestData(bool refresh) {
     if (refresh) {
         currentPage   = 1;
         currentOffset = "";
+        noMore        = false;
     }
+    if (noMore) return;
     if (this->currentUser == 0) {
         this->requestDynamicVideoList(currentPage, currentOffset);
     } else {
@@ -52,7 +54,9 @@ void DynamicVideoRequest::requestDynamicVideoList(unsigned int page,
             }
             currentOffset = result.offset;
             currentPage   = result.page + 1;
-            this->onDynamicVideoList(result.items, result.page);
+            noMore        = !result.has_more;
+            if (result.page == 1 || !result.items.empty())
+                this->onDynamicVideoList(result.items, result.page);
             UNSET_REQUEST
         },
         [this](const std::string &error) {
@@ -74,7 +78,10 @@ void DynamicVideoRequest::requestUserDynamicVideoList(int64_t mid, int pn,
                 return;
             }
             currentPage = result.page.pn + 1;
-            this->onDynamicVideoList(result.archives, result.page.pn);
+            noMore      = result.archives.empty() ||
+                          result.page.pn * result.page.ps >= result.page.count;
+            if (result.page.pn == 1 || !result.archives.empty())
+                this->onDynamicVideoList(result.archives, result.page.pn);
             UNSET_REQUEST
         },
         [this](const std::string &error) {
@@ -6,6 +6,7 @@
 #include "bilibili.h"
 #include "utils/activity_helper.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -120,13 +121,13 @@ void DataSourcePGCVideoList::onItemSelected(RecyclingGrid* recycler,
         if (this->videoList.module_id == 1741) {
             // 我的追番
             brls::Application::pushActivity(
-                new brls::Activity(brls::Box::createFromXMLResource(
+                new brls::Activity(XMLLayout::create(
                     "fragment/mine_bangumi_anime.xml")),
                 brls::TransitionAnimation::NONE);
         } else if (this->videoList.module_id == 1745) {
             // 我的追剧
             brls::Application::pushActivity(
-                new brls::Activity(brls::Box::createFromXMLResource(
+                new brls::Activity(XMLLayout::create(
                     "fragment/mine_bangumi_series.xml")),
                 brls::TransitionAnimation::NONE);
         } else {
@@ -0,0 +1,86 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <set>
+#include <borealis/core/thread.hpp>
+#include <borealis/core/logger.hpp>
+
+#include "bilibili.h"
+#include "bilibili/result/search_result.h"
+#include "presenter/search_suggest.hpp"
+#include "utils/config_helper.hpp"
+
+SearchSuggestRequest::SearchSuggestRequest() { this->refreshHistoryIndex(); }
+
+SearchSuggestRequest::~SearchSuggestRequest() {
+    brls::cancelDelay(suggestDelayIter);
+}
+
+void SearchSuggestRequest::refreshHistoryIndex() {
+    historyIndex.clear();
+    auto list = ProgramConfig::instance().getHistoryList();
+    // 越新的历史记录权重越大
+    for (size_t i = 0; i < list.size(); i++)
+        historyIndex.insert(list[i], list.size() - i);
+}
+
+std::vector<std::string> SearchSuggestRequest::matchLocal(
+    const std::string& key) {
+    auto res = historyIndex.match(key, LOCAL_LIMIT);
+    if (res.size() >= LOCAL_LIMIT) return res;
+    std::set<std::string> exist(res.begin(), res.end());
+    for (auto& i : suggestIndex.match(key, LOCAL_LIMIT)) {
+        if (res.size() >= LOCAL_LIMIT) break;
+        if (exist.insert(i).second) res.emplace_back(i);
+    }
+    return res;
+}
+
+void SearchSuggestRequest::cancelSuggest() {
+    brls::cancelDelay(suggestDelayIter);
+    suggestDelayIter = 0;
+    suggestGeneration++;
+}
+
+void SearchSuggestRequest::requestSuggest(const std::string& key) {
+    this->cancelSuggest();
+    if (key.empty()) return;
+    size_t generation = suggestGeneration;
+
+    auto local = this->matchLocal(key);
+    this->onSuggestList(key, local, false);
+
+    suggestDelayIter = brls::delay(DEBOUNCE, [this, key, generation, local]() {
+        suggestDelayIter = 0;
+        if (generation != suggestGeneration) return;
+        ASYNC_RETAIN
+        BILI::get_search_suggest_tv(
+            key,
+            [ASYNC_TOKEN, key, generation,
+             local](const bilibili::SearchSuggestList& result) {
+                brls::sync([ASYNC_TOKEN, key, generation, local, result]() {
+                    ASYNC_RELEASE
+                    // 已经被之后的输入取代
+                    if (generation != suggestGeneration) return;
+                    if (suggestIndex.size() > CACHE_SIZE) suggestIndex.clear();
+                    std::vector<std::string> list = local;
+                    std::set<std::string> exist(list.begin(), list.end());
+                    for (auto& i : result.tag) {
+                        suggestIndex.insert(i.value, ++suggestWeight);
+                        if (exist.insert(i.value).second)
+                            list.emplace_back(i.value);
+                    }
+                    this->onSuggestList(key, list, true);
+                });
+            },
+            [ASYNC_TOKEN, generation](BILI_ERR) {
+                brls::Logger::error("requestSearchSuggest: {}", error);
+                brls::sync([ASYNC_TOKEN, generation, error]() {
+                    ASYNC_RELEASE
+                    if (generation != suggestGeneration) return;
+                    this->onSuggestError(error);
+                });
+            });
+    });
+}
@@ -2,12 +2,15 @@
 // Created by fang on 2022/8/9.
 //
 #include <cstdlib>
-#include <tinyxml2.h>
 #include <pystring.h>
 #include "borealis.hpp"
 #include "presenter/video_detail.hpp"
 #include "utils/config_helper.hpp"
+#include "utils/comment_cache.hpp"
+#include "utils/download_manager.hpp"
+#include "utils/history_reporter.hpp"
 #include "utils/number_helper.hpp"
+#include "utils/opencc_helper.hpp"
 #include "view/mpv_core.hpp"
 #include "view/danmaku_core.hpp"
 #include "view/subtitle_core.hpp"
@@ -35,18 +38,20 @@ void VideoDetail::requestSeasonInfo(size_t seasonID, size_t epID) {
     ASYNC_RETAIN
     BILI::get_season_detail(
         seasonID, epID,
-        [ASYNC_TOKEN, epID](const bilibili::SeasonResultWrapper& result) {
-            brls::sync([ASYNC_TOKEN, result, epID]() {
+        [ASYNC_TOKEN, epID](bilibili::SeasonResultWrapper result) {
+            brls::sync([ASYNC_TOKEN, epID,
+                        data = wiliwili::moveToShared(std::move(result))]() {
                 ASYNC_RELEASE
                 brls::Logger::debug("BILI::get_season_detail");
-                seasonInfo = result;
+                seasonInfo   = std::move(*data);
+                auto& result = seasonInfo;
                 this->requestSeasonStatue(result.season_id);
 
                 // 合并数据，将所有分集合并成一个列表
                 // 1. 若存在额外分区, 切正片不为空则在正片分集前添加分区标题 "正片"
                 // 2. 将分区标题设置为仅有 title，id为0的分集项，显示时根据id来正确显示样式
                 // 3. 修改标题
-                episodeList.clear();
+                // 复制分集列表，onSeasonVideoInfo 仍需要统计分集数量
                 episodeList = seasonInfo.episodes;
 
                 for (auto& e : episodeList) {
@@ -149,10 +154,11 @@ void VideoDetail::requestSeasonRecommend(size_t seasonID) {
     ASYNC_RETAIN
     BILI::get_season_recommend(
         seasonID,
-        [ASYNC_TOKEN](const bilibili::SeasonRecommendWrapper& result) {
-            brls::sync([ASYNC_TOKEN, result]() {
+        [ASYNC_TOKEN](bilibili::SeasonRecommendWrapper result) {
+            brls::sync([ASYNC_TOKEN,
+                        data = wiliwili::moveToShared(std::move(result))]() {
                 ASYNC_RELEASE
-                this->onSeasonRecommend(result);
+                this->onSeasonRecommend(*data);
             });
         },
         [ASYNC_TOKEN](BILI_ERR) {
@@ -187,13 +193,14 @@ void VideoDetail::requestVideoInfo(const std::string& bvid) {
     brls::Logger::debug("请求视频信息: {}", bvid);
     BILI::get_video_detail_all(
         bvid,
-        [ASYNC_TOKEN](const bilibili::VideoDetailAllResult& result) {
-            brls::sync([ASYNC_TOKEN, result]() {
+        [ASYNC_TOKEN](bilibili::VideoDetailAllResult result) {
+            brls::sync([ASYNC_TOKEN,
+                        data = wiliwili::moveToShared(std::move(result))]() {
                 ASYNC_RELEASE
                 brls::Logger::debug("BILI::get_video_detail");
-                this->videoDetailResult = result.View;
-                this->userDetailResult  = result.Card;
-                this->videDetailRelated = result.Related;
+                this->videoDetailResult = std::move(data->View);
+                this->userDetailResult  = std::move(data->Card);
+                this->videDetailRelated = std::move(data->Related);
 
                 if (!this->videoDetailResult.redirect_url.empty()) {
                     // eg: https://www.bilibili.com/bangumi/play/ep568278
@@ -287,6 +294,13 @@ void VideoDetail::requestVideoUrl(std::string bvid, int cid,
                                   bool requestHistoryInfo) {
     // 重置MPV
     MPVCore::instance().reset();
+    MPVCore::instance().setContentId(fmt::format("{}/{}", bvid, cid));
+    if (this->requestOfflineVideo(cid)) {
+        // 弹幕与字幕从本地读取，仍然需要在线人数与历史播放记录
+        this->requestVideoOnline(bvid, cid);
+        this->requestVideoPageDetail(bvid, cid, requestHistoryInfo, false);
+        return;
+    }
     ASYNC_RETAIN
     brls::Logger::debug("请求视频播放地址: {}/{}/{}", bvid, cid,
                         defaultQuality);
@@ -294,11 +308,12 @@ void VideoDetail::requestVideoUrl(std::string bvid, int cid,
 
     BILI::get_video_url(
         bvid, cid, defaultQuality,
-        [ASYNC_TOKEN](const bilibili::VideoUrlResult& result) {
-            brls::sync([ASYNC_TOKEN, result]() {
+        [ASYNC_TOKEN](bilibili::VideoUrlResult result) {
+            brls::sync([ASYNC_TOKEN,
+                        data = wiliwili::moveToShared(std::move(result))]() {
                 ASYNC_RELEASE
-                this->videoUrlResult = result;
-                this->onVideoPlayUrl(result);
+                this->videoUrlResult = std::move(*data);
+                this->onVideoPlayUrl(this->videoUrlResult);
             });
         },
         [ASYNC_TOKEN](BILI_ERR) {
@@ -321,17 +336,25 @@ void VideoDetail::requestSeasonVideoUrl(const std::string& bvid, int cid,
                                         bool requestHistoryInfo) {
     // 重置MPV
     MPVCore::instance().reset();
+    MPVCore::instance().setContentId(fmt::format("{}/{}", bvid, cid));
+    if (this->requestOfflineVideo(cid)) {
+        // 弹幕与字幕从本地读取，仍然需要在线人数与历史播放记录
+        this->requestVideoOnline(bvid, cid);
+        this->requestVideoPageDetail(bvid, cid, requestHistoryInfo, false);
+        return;
+    }
 
     ASYNC_RETAIN
     brls::Logger::debug("请求番剧视频播放地址: {}", cid);
     BILI::get_season_url(
         cid, defaultQuality,
-        [ASYNC_TOKEN](const bilibili::VideoUrlResult& result) {
-            brls::sync([ASYNC_TOKEN, result]() {
+        [ASYNC_TOKEN](bilibili::VideoUrlResult result) {
+            brls::sync([ASYNC_TOKEN,
+                        data = wiliwili::moveToShared(std::move(result))]() {
                 ASYNC_RELEASE
                 brls::Logger::debug("BILI::get_video_url");
-                this->videoUrlResult = result;
-                this->onVideoPlayUrl(result);
+                this->videoUrlResult = std::move(*data);
+                this->onVideoPlayUrl(this->videoUrlResult);
             });
         },
         [ASYNC_TOKEN](BILI_ERR) {
@@ -415,29 +438,43 @@ void VideoDetail::requestVideoComment(int aid, int next, int mode) {
     if (next >= 0) {
         this->commentRequestIndex = next;
     }
+    this->resetCommentReplyPrefetch(aid);
+
+    // 使用预加载的评论
+    auto page = std::make_shared<bilibili::VideoCommentResultWrapper>();
+    if (CommentCache::instance().takePage(aid, commentMode, commentRequestIndex,
+                                          *page)) {
+        brls::Logger::debug("使用预加载的视频评论: {} {}", aid,
+                            commentRequestIndex);
+        ASYNC_RETAIN
+        brls::sync([ASYNC_TOKEN, aid, page]() {
+            ASYNC_RELEASE
+            this->onVideoCommentPage(aid, *page);
+        });
+        return;
+    }
+
+    // 正在预加载这一页，加载结束后再显示
+    if (commentPrefetching && commentPrefetchAid == aid &&
+        commentPrefetchIndex == commentRequestIndex &&
+        commentPrefetchMode == commentMode) {
+        this->commentWaiting = true;
+        return;
+    }
+    this->commentWaiting = false;
+
     brls::Logger::debug("请求视频评论: {} {}", aid, next);
     ASYNC_RETAIN
     BILI::get_comment(
         aid, commentRequestIndex, getVideoCommentMode(),
-        [ASYNC_TOKEN, aid](const bilibili::VideoCommentResultWrapper& result) {
-            brls::sync([ASYNC_TOKEN, aid, result]() {
+        [ASYNC_TOKEN, aid](bilibili::VideoCommentResultWrapper result) {
+            // 在网络线程中预先解析评论内容
+            CommentCache::instance().parse(aid, result.top_replies);
+            CommentCache::instance().parse(aid, result.replies);
+            brls::sync([ASYNC_TOKEN, aid,
+                        data = wiliwili::moveToShared(std::move(result))]() {
                 ASYNC_RELEASE
-                if (this->commentRequestIndex != result.requestIndex) {
-                    brls::Logger::error("request comment {}/{} got: {}", aid,
-                                        commentRequestIndex,
-                                        result.requestIndex);
-                    return;
-                }
-                if (!result.cursor.is_end) {
-                    this->commentRequestIndex = result.cursor.next;
-                }
-                bilibili::VideoCommentResultWrapper res = result;
-                std::string& video_uploader = userDetailResult.card.mid;
-                for (auto& i : res.top_replies)
-                    i.member.is_uploader = i.member.mid == video_uploader;
-                for (auto& i : res.replies)
-                    i.member.is_uploader = i.member.mid == video_uploader;
-                this->onCommentInfo(res);
+                this->onVideoCommentPage(aid, *data);
             });
         },
         [ASYNC_TOKEN](BILI_ERR) {
@@ -446,6 +483,129 @@ void VideoDetail::requestVideoComment(int aid, int next, int mode) {
         });
 }
 
+void VideoDetail::onVideoCommentPage(
+    int aid, bilibili::VideoCommentResultWrapper& result) {
+    if (this->commentRequestIndex != result.requestIndex) {
+        brls::Logger::error("request comment {}/{} got: {}", aid,
+                            commentRequestIndex, result.requestIndex);
+        return;
+    }
+    if (!result.cursor.is_end) {
+        this->commentRequestIndex = result.cursor.next;
+    }
+    std::string& video_uploader = userDetailResult.card.mid;
+    for (auto& i : result.top_replies)
+        i.member.is_uploader = i.member.mid == video_uploader;
+    for (auto& i : result.replies)
+        i.member.is_uploader = i.member.mid == video_uploader;
+    this->onCommentInfo(result);
+
+    // 阅读当前页时在后台加载下一页与前几条评论的回复
+    if (!result.cursor.is_end)
+        this->prefetchVideoComment(aid, commentMode, commentRequestIndex);
+    this->prefetchCommentReplies(aid, result);
+}
+
+void VideoDetail::prefetchVideoComment(int aid, int mode, int next) {
+    if (commentPrefetching && commentPrefetchAid == aid &&
+        commentPrefetchIndex == next && commentPrefetchMode == mode)
+        return;
+    this->commentPrefetching   = true;
+    this->commentPrefetchAid   = aid;
+    this->commentPrefetchIndex = next;
+    this->commentPrefetchMode  = mode;
+    this->commentWaiting       = false;
+
+    brls::Logger::debug("预加载视频评论: {} {}", aid, next);
+    ASYNC_RETAIN
+    BILI::get_comment(
+        aid, next, mode,
+        [ASYNC_TOKEN, aid, mode,
+         next](bilibili::VideoCommentResultWrapper result) {
+            CommentCache::instance().putPage(aid, mode, std::move(result));
+            brls::sync([ASYNC_TOKEN, aid, mode, next]() {
+                ASYNC_RELEASE
+                this->onCommentPrefetched(aid, mode, next, "");
+            });
+        },
+        [ASYNC_TOKEN, aid, mode, next](BILI_ERR) {
+            brls::sync([ASYNC_TOKEN, aid, mode, next, error]() {
+                ASYNC_RELEASE
+                this->onCommentPrefetched(aid, mode, next, error);
+            });
+        });
+}
+
+void VideoDetail::onCommentPrefetched(int aid, int mode, int next,
+                                      const std::string& error) {
+    // 已经开始预加载其他页
+    if (commentPrefetchAid != aid || commentPrefetchIndex != next ||
+        commentPrefetchMode != mode)
+        return;
+    this->commentPrefetching = false;
+    if (!commentWaiting) return;
+    this->commentWaiting = false;
+    if (commentRequestIndex != next || commentMode != mode) return;
+
+    if (error.empty())
+        this->requestVideoComment(aid);
+    else
+        this->onRequestCommentError(error);
+}
+
+void VideoDetail::resetCommentReplyPrefetch(int aid) {
+    if (commentReplyAid == aid && commentReplyValid) return;
+    if (commentReplyValid) *commentReplyValid = false;
+    this->commentReplyValid = std::make_shared<std::atomic<bool>>(true);
+    this->commentReplyAid   = aid;
+    this->commentReplyCount = 0;
+    this->commentReplyFetching.clear();
+}
+
+void VideoDetail::prefetchCommentReplies(
+    int aid, const bilibili::VideoCommentResultWrapper& result) {
+    this->resetCommentReplyPrefetch(aid);
+    auto& cache = CommentCache::instance();
+    std::vector<int64_t> roots;
+    for (auto* list : {&result.top_replies, &result.replies}) {
+        for (auto& i : *list) {
+            if (roots.size() >= CommentCache::PREFETCH_THREADS) break;
+            if (i.rcount <= 0 || commentReplyFetching.count(i.rpid) ||
+                cache.hasThread(aid, i.rpid))
+                continue;
+            roots.emplace_back(i.rpid);
+        }
+    }
+    // 限制单个视频的请求数量，避免反复翻页时重复请求
+    for (auto rpid : roots) {
+        if (commentReplyCount >= CommentCache::MAX_THREADS) break;
+        this->commentReplyCount++;
+        this->commentReplyFetching.insert(rpid);
+        auto valid = this->commentReplyValid;
+        ASYNC_RETAIN
+        BILI::get_comment_detail(
+            ProgramConfig::instance().getCSRF(), aid, rpid, 0,
+            [ASYNC_TOKEN, valid, aid,
+             rpid](bilibili::VideoSingleCommentDetail result) {
+                if (*valid)
+                    CommentCache::instance().putThread(aid, rpid,
+                                                       std::move(result));
+                brls::sync([ASYNC_TOKEN, valid, rpid]() {
+                    ASYNC_RELEASE
+                    if (*valid) this->commentReplyFetching.erase(rpid);
+                });
+            },
+            [ASYNC_TOKEN, valid, rpid](BILI_ERR) {
+                brls::sync([ASYNC_TOKEN, valid, rpid, error]() {
+                    ASYNC_RELEASE
+                    brls::Logger::warning("预加载评论回复失败: {} {}", rpid,
+                                          error);
+                    if (*valid) this->commentReplyFetching.erase(rpid);
+                });
+            });
+    }
+}
+
 int VideoDetail::getVideoCommentMode() { return commentMode; }
 
 void VideoDetail::setVideoCommentMode(int mode) { this->commentMode = mode; }
@@ -460,9 +620,11 @@ void VideoDetail::requestUploadedVideos(int64_t mid, int pn, int ps) {
     ASYNC_RETAIN
     BILI::get_user_videos(
         mid, userUploadedVideoRequestIndex, ps,
-        [ASYNC_TOKEN](const bilibili::UserUploadedVideoResultWrapper& result) {
-            brls::sync([ASYNC_TOKEN, result]() {
+        [ASYNC_TOKEN](bilibili::UserUploadedVideoResultWrapper result) {
+            brls::sync([ASYNC_TOKEN,
+                        data = wiliwili::moveToShared(std::move(result))]() {
                 ASYNC_RELEASE
+                auto& result = *data;
                 if (result.page.pn != this->userUploadedVideoRequestIndex)
                     return;
                 if (!result.list.empty()) {
@@ -540,44 +702,20 @@ void VideoDetail::requestVideoDanmaku(int cid) {
     ASYNC_RETAIN
     BILI::get_danmaku(
         cid,
-        [ASYNC_TOKEN](const std::string& result) {
+        [ASYNC_TOKEN](std::string result) {
             ASYNC_RELEASE
             brls::Logger::debug("DANMAKU: start decode");
+            std::vector<DanmakuItem> items = DanmakuCore::decodeXML(result);
 
-            // Load XML
-            tinyxml2::XMLDocument document = tinyxml2::XMLDocument();
-            tinyxml2::XMLError error       = document.Parse(result.c_str());
-
-            if (error != tinyxml2::XMLError::XML_SUCCESS) {
-                brls::Logger::error("Error decode danmaku xml[1]: {}",
-                                    std::to_string(error));
-                return;
-            }
-            tinyxml2::XMLElement* element = document.RootElement();
-            if (!element) {
-                brls::Logger::error(
-                    "Error decode danmaku xml[2]: no root element");
-                return;
-            }
-
-            std::vector<DanmakuItem> items;
-            for (auto child = element->FirstChildElement(); child != nullptr;
-                 child      = child->NextSiblingElement()) {
-                if (child->Name()[0] != 'd') continue;  // 简易判断是不是弹幕
-                const char* content = child->GetText();
-                if (!content) continue;
-                try {
-                    items.emplace_back(content, child->Attribute("p"));
-                } catch (...) {
-                    brls::Logger::error("DANMAKU: error decode: {}",
-                                        child->GetText());
-                }
-            }
-
-            brls::sync(
-                [items]() { DanmakuCore::instance().loadDanmakuData(items); });
+            // 简繁转换在工作线程中批量完成，避免加载弹幕时阻塞界面
+            OpenCCHelper::instance().convertBatch(
+                items, [](DanmakuItem& i) -> std::string& { return i.msg; });
 
             brls::Logger::debug("DANMAKU: decode done: {}", items.size());
+
+            brls::sync([data = wiliwili::moveToShared(std::move(items))]() {
+                DanmakuCore::instance().loadDanmakuData(std::move(*data));
+            });
         },
         [ASYNC_TOKEN](BILI_ERR) {
             ASYNC_RELEASE
@@ -585,22 +723,38 @@ void VideoDetail::requestVideoDanmaku(int cid) {
         });
 }
 
+bool VideoDetail::requestOfflineVideo(int cid) {
+    bilibili::VideoUrlResult result;
+    if (cid == 0 || !DownloadManager::instance().getLocalVideo(cid, result))
+        return false;
+    brls::Logger::info("播放离线缓存: {}", cid);
+    this->videoUrlResult = std::move(result);
+    this->onVideoPlayUrl(this->videoUrlResult);
+    DownloadManager::instance().loadExtras(cid);
+    return true;
+}
+
 /// 获取视频分P详情
 void VideoDetail::requestVideoPageDetail(const std::string& bvid, int cid,
-                                         bool requestVideoHistory) {
+                                         bool requestVideoHistory,
+                                         bool requestSubtitle) {
     brls::Logger::debug("请求字幕：bvid: {} cid: {}", bvid, cid);
     ASYNC_RETAIN
     BILI::get_page_detail(
         bvid, cid,
-        [ASYNC_TOKEN,
-         requestVideoHistory](const bilibili::VideoPageResult& result) {
-            brls::sync([ASYNC_TOKEN, result, requestVideoHistory]() {
+        [ASYNC_TOKEN, requestVideoHistory,
+         requestSubtitle](bilibili::VideoPageResult result) {
+            brls::sync([ASYNC_TOKEN, requestVideoHistory, requestSubtitle,
+                        data = wiliwili::moveToShared(std::move(result))]() {
                 ASYNC_RELEASE
-                SubtitleCore::instance().setSubtitleList(result);
-                // 存在UP主设置的字幕
-                if (!result.subtitles.empty() &&
-                    pystring::count(result.subtitles[0].lan, "ai") <= 0) {
-                    SubtitleCore::instance().selectSubtitle(0);
+                auto& result = *data;
+                if (requestSubtitle) {
+                    SubtitleCore::instance().setSubtitleList(result);
+                    // 存在UP主设置的字幕
+                    if (!result.subtitles.empty() &&
+                        pystring::count(result.subtitles[0].lan, "ai") <= 0) {
+                        SubtitleCore::instance().selectSubtitle(0);
+                    }
                 }
 
                 if (!requestVideoHistory) return;
@@ -642,24 +796,20 @@ void VideoDetail::requestVideoPageDetail(const std::string& bvid, int cid,
 /// 上报历史记录
 void VideoDetail::reportHistory(unsigned int aid, unsigned int cid,
                                 unsigned int progress, unsigned int duration,
-                                int type) {
+                                int type, bool flush) {
     if (!REPORT_HISTORY) return;
     if (aid == 0 || cid == 0) return;
-    brls::Logger::debug("reportHistory: aid{} cid{} progress{} duration{}", aid,
-                        cid, progress, duration);
-    std::string mid   = ProgramConfig::instance().getUserID();
-    std::string token = ProgramConfig::instance().getCSRF();
-    if (mid.empty() || token.empty()) return;
-    unsigned int sid = 0, epid = 0;
+    HistoryReport item;
+    item.aid      = aid;
+    item.cid      = cid;
+    item.type     = type;
+    item.progress = progress;
+    item.duration = duration;
     if (type == 4) {
-        sid  = seasonInfo.season_id;
-        epid = episodeResult.id;
+        item.sid  = seasonInfo.season_id;
+        item.epid = episodeResult.id;
     }
-
-    BILI::report_history(
-        mid, token, aid, cid, type, progress, duration, sid, epid,
-        []() { brls::Logger::debug("reportHistory: success"); },
-        [](const std::string& err) { brls::Logger::error("{}", err); });
+    HistoryReporter::instance().report(item, flush);
 }
 
 int VideoDetail::getCoinTolerate() {
@@ -0,0 +1,143 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <algorithm>
+#include <borealis/core/logger.hpp>
+
+#include "utils/comment_cache.hpp"
+#include "view/video_comment.hpp"
+
+void CommentCache::putPage(size_t aid, int mode,
+                           bilibili::VideoCommentResultWrapper page) {
+    ContentList contents;
+    for (auto& i : page.top_replies) parse(i, contents);
+    for (auto& i : page.replies) parse(i, contents);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& video = getVideo(aid);
+    insert(video, contents);
+    std::pair<int, size_t> key = {mode, page.requestIndex};
+    if (video.pages.count(key) == 0) video.pageOrder.emplace_back(key);
+    video.pages[key] = std::move(page);
+    // 丢弃最早加入的评论页
+    while (video.pageOrder.size() > MAX_PAGES) {
+        video.pages.erase(video.pageOrder.front());
+        video.pageOrder.pop_front();
+    }
+}
+
+bool CommentCache::takePage(size_t aid, int mode, size_t next,
+                            bilibili::VideoCommentResultWrapper& page) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* video = findVideo(aid);
+    if (!video) return false;
+    std::pair<int, size_t> key = {mode, next};
+    auto it                    = video->pages.find(key);
+    if (it == video->pages.end()) return false;
+    page = std::move(it->second);
+    video->pages.erase(it);
+    auto& order = video->pageOrder;
+    order.erase(std::find(order.begin(), order.end(), key));
+    return true;
+}
+
+void CommentCache::putThread(size_t aid, int64_t rpid,
+                             bilibili::VideoSingleCommentDetail thread) {
+    ContentList contents;
+    parse(thread.root, contents);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& video = getVideo(aid);
+    insert(video, contents);
+    if (video.threads.count(rpid) == 0) video.threadOrder.emplace_back(rpid);
+    video.threads[rpid] = std::move(thread);
+    while (video.threadOrder.size() > MAX_THREADS) {
+        video.threads.erase(video.threadOrder.front());
+        video.threadOrder.pop_front();
+    }
+}
+
+bool CommentCache::takeThread(size_t aid, int64_t rpid,
+                              bilibili::VideoSingleCommentDetail& thread) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* video = findVideo(aid);
+    if (!video) return false;
+    auto it = video->threads.find(rpid);
+    if (it == video->threads.end()) return false;
+    thread = std::move(it->second);
+    video->threads.erase(it);
+    auto& order = video->threadOrder;
+    order.erase(std::find(order.begin(), order.end(), rpid));
+    return true;
+}
+
+bool CommentCache::hasThread(size_t aid, int64_t rpid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* video = findVideo(aid);
+    return video && video->threads.count(rpid) > 0;
+}
+
+void CommentCache::parse(size_t aid,
+                         const bilibili::VideoCommentListResult& list) {
+    ContentList contents;
+    for (auto& i : list) parse(i, contents);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    insert(getVideo(aid), contents);
+}
+
+std::shared_ptr<const CommentContent> CommentCache::getContent(
+    const bilibili::VideoCommentResult& data) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* video = findVideo(data.oid);
+    if (!video) return nullptr;
+    auto it = video->contents.find(getContentId(data));
+    if (it == video->contents.end()) return nullptr;
+    return it->second;
+}
+
+uint64_t CommentCache::getContentId(const bilibili::VideoCommentResult& data) {
+    return ((uint64_t)data.rpid << 1) | (data.top ? 1 : 0);
+}
+
+CommentCache::VideoCache& CommentCache::getVideo(size_t aid) {
+    for (auto it = videos.begin(); it != videos.end(); it++) {
+        if (it->aid != aid) continue;
+        videos.splice(videos.begin(), videos, it);
+        return videos.front();
+    }
+    videos.emplace_front();
+    videos.front().aid = aid;
+    while (videos.size() > MAX_VIDEOS) {
+        brls::Logger::debug("CommentCache: release {}", videos.back().aid);
+        videos.pop_back();
+    }
+    return videos.front();
+}
+
+CommentCache::VideoCache* CommentCache::findVideo(size_t aid) {
+    for (auto& video : videos)
+        if (video.aid == aid) return &video;
+    return nullptr;
+}
+
+void CommentCache::parse(const bilibili::VideoCommentResult& data,
+                         ContentList& contents) {
+    auto content = std::make_shared<const CommentContent>(
+        VideoComment::parseContent(data));
+    contents.emplace_back(getContentId(data), std::move(content));
+    for (auto& i : data.replies) parse(i, contents);
+}
+
+void CommentCache::insert(VideoCache& video, ContentList& contents) {
+    for (auto& i : contents) {
+        if (video.contents.count(i.first) == 0)
+            video.contentOrder.emplace_back(i.first);
+        video.contents[i.first] = std::move(i.second);
+    }
+    while (video.contentOrder.size() > MAX_CONTENTS) {
+        video.contents.erase(video.contentOrder.front());
+        video.contentOrder.pop_front();
+    }
+}
@@ -9,6 +9,9 @@
 #include <borealis/platforms/desktop/desktop_platform.hpp>
 #endif
 
+#include <future>
+#include <algorithm>
+#include <pystring.h>
 #include <borealis.hpp>
 
 #include "bilibili.h"
@@ -16,7 +19,14 @@
 #include "utils/number_helper.hpp"
 #include "utils/thread_helper.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/media_proxy.hpp"
+#include "utils/download_manager.hpp"
+#include "utils/qoe_helper.hpp"
+#include "utils/startup_profiler.hpp"
 #include "utils/config_helper.hpp"
+#include "utils/config_writer.hpp"
+#include "utils/frame_scheduler.hpp"
+#include "utils/feed_snapshot.hpp"
 #include "utils/vibration_helper.hpp"
 #include "utils/ban_list.hpp"
 #include "utils/string_helper.hpp"
@@ -24,6 +34,7 @@
 #include "view/mpv_core.hpp"
 #include "view/danmaku_core.hpp"
 #include "view/video_view.hpp"
+#include "view/windowed_data_source.hpp"
 #include "activity/player_activity.hpp"
 #include "activity/search_activity_tv.hpp"
 
@@ -135,6 +146,23 @@ std::unordered_map<SettingItem, ProgramOption> ProgramConfig::SETTING_MAP = {
       {"0MB", "10MB", "20MB", "50MB", "100MB", "200MB", "500MB"},
       {0, 10, 20, 50, 100, 200, 500},
       1}},
+#endif
+#if defined(__PSV__)
+    {SettingItem::PLAYER_MEDIA_CACHE,
+     {"player_media_cache", {"0MB", "128MB", "256MB"}, {0, 128, 256}, 0}},
+#else
+    {SettingItem::PLAYER_MEDIA_CACHE,
+     {"player_media_cache",
+      {"0MB", "256MB", "512MB", "1GB", "2GB", "4GB"},
+      {0, 256, 512, 1024, 2048, 4096},
+      0}},
+#endif
+#if defined(__PSV__)
+    {SettingItem::PLAYER_MEDIA_CONNECTIONS,
+     {"player_media_connections", {"1", "2"}, {1, 2}, 0}},
+#else
+    {SettingItem::PLAYER_MEDIA_CONNECTIONS,
+     {"player_media_connections", {"1", "2", "4", "8"}, {1, 2, 4, 8}, 2}},
 #endif
     {
         SettingItem::PLAYER_DEFAULT_SPEED,
@@ -202,6 +230,15 @@ std::unordered_map<SettingItem, ProgramOption> ProgramConfig::SETTING_MAP = {
     {SettingItem::DEACTIVATED_TIME, {"deactivated_time", {}, {}, 0}},
     {SettingItem::DEACTIVATED_FPS, {"deactivated_fps", {}, {}, 0}},
     {SettingItem::DLNA_PORT, {"dlna_port", {}, {}, 0}},
+    {SettingItem::PLAYER_QOE_PORT, {"player_qoe_port", {}, {}, 0}},
+    {SettingItem::DOWNLOAD_CONNECTIONS, {"download_connections", {}, {}, 0}},
+    {SettingItem::DOWNLOAD_SPEED_LIMIT, {"download_speed_limit", {}, {}, 0}},
+    {SettingItem::STARTUP_PARALLEL, {"startup_parallel", {}, {}, 0}},
+    {SettingItem::STARTUP_TRACE, {"startup_trace", {}, {}, 0}},
+    {SettingItem::SEARCH_HISTORY_LOG, {"search_history_log", {}, {}, 0}},
+    {SettingItem::ON_DEMAND_RENDER, {"on_demand_render", {}, {}, 0}},
+    {SettingItem::LIST_MEMORY_LIMIT, {"list_memory_limit", {}, {}, 0}},
+    {SettingItem::FEED_SNAPSHOT, {"feed_snapshot", {}, {}, 0}},
 };
 
 ProgramConfig::ProgramConfig() = default;
@@ -241,9 +278,18 @@ Cookie ProgramConfig::getCookie() const { return this->cookie; }
 void ProgramConfig::addHistory(const std::string& key) {
     if (key.empty()) return;
     std::string newItem = wiliwili::base64Encode(key);
-    auto it             = this->searchHistory.begin();
+    this->pushHistory(newItem);
+    if (SEARCH_HISTORY_LOG) {
+        ConfigWriter::instance().append(this->getSearchHistoryPath(), newItem);
+    } else {
+        this->save();
+    }
+}
+
+void ProgramConfig::pushHistory(const std::string& item) {
+    auto it = this->searchHistory.begin();
     for (; it != this->searchHistory.end(); it++) {
-        if (*it == newItem) break;
+        if (*it == item) break;
     }
     if (it != this->searchHistory.end()) {
         this->searchHistory.erase(it);
@@ -251,8 +297,7 @@ void ProgramConfig::addHistory(const std::string& key) {
     if (this->searchHistory.size() == 50) {
         this->searchHistory.erase(this->searchHistory.begin());
     }
-    this->searchHistory.emplace_back(newItem);
-    this->save();
+    this->searchHistory.emplace_back(item);
 }
 
 std::vector<std::string> ProgramConfig::getHistoryList() {
@@ -376,42 +421,57 @@ void ProgramConfig::saveHomeWindowState() {
 }
 
 void ProgramConfig::load() {
-    const std::string path = this->getConfigDir() + "/wiliwili_config.json";
+    const std::string path = this->getConfigPath();
 
-    std::ifstream readFile(path);
-    if (readFile) {
+    std::string data;
+    if (ConfigWriter::read(path, data)) {
+        StartupProfiler::Phase phase("config_read");
         try {
-            nlohmann::json content;
-            readFile >> content;
-            readFile.close();
-            this->setProgramConfig(content.get<ProgramConfig>());
+            this->setProgramConfig(
+                nlohmann::json::parse(data).get<ProgramConfig>());
         } catch (const std::exception& e) {
             brls::Logger::error("ProgramConfig::load: {}", e.what());
         }
         brls::Logger::info("Load config from: {}", path);
     }
 
+    // 重放上次写入配置文件之后新增的搜索历史
+    if (ConfigWriter::read(this->getSearchHistoryPath(), data)) {
+        std::vector<std::string> lines;
+        pystring::splitlines(data, lines);
+        for (auto& i : lines) {
+            if (!i.empty()) this->pushHistory(i);
+        }
+    }
+
+    // 初始化启动模式
+    StartupProfiler::TRACE = getSettingItem(SettingItem::STARTUP_TRACE, false);
+    StartupProfiler::PARALLEL =
+        getSettingItem(SettingItem::STARTUP_PARALLEL, false);
+    SEARCH_HISTORY_LOG = getSettingItem(SettingItem::SEARCH_HISTORY_LOG, true);
+
+    // 扫描自定义主题与查找自定义字体只涉及文件系统，
+    // 并行启动时在后台线程中与下方的配置初始化同时进行，否则在需要时依次执行
+    auto policy = StartupProfiler::PARALLEL ? std::launch::async
+                                            : std::launch::deferred;
+    auto themeTask = std::async(policy, [this]() {
+        StartupProfiler::Phase phase("theme_scan");
+        this->loadCustomThemes();
+    });
+    std::string keymap =
+        getSettingItem(SettingItem::KEYMAP, std::string{"xbox"});
+    auto fontTask = std::async(policy, [this, keymap]() {
+        StartupProfiler::Phase phase("font_discovery");
+        this->initFontPath(keymap);
+    });
+    StartupProfiler::Phase applyPhase("config_apply");
+
 #ifdef IOS
 #elif defined(__APPLE__) || defined(__linux__) || defined(_WIN32)
     brls::DesktopPlatform::GAMEPAD_DB =
         getConfigDir() + "/gamecontrollerdb.txt";
 #endif
 
-    // 初始化自定义布局
-    std::string customThemeID =
-        getSettingItem(SettingItem::APP_RESOURCES, std::string{""});
-    if (!customThemeID.empty()) {
-        for (auto& theme : customThemes) {
-            if (theme.id == customThemeID) {
-                brls::View::CUSTOM_RESOURCES_PATH = theme.path;
-                break;
-            }
-        }
-        if (brls::View::CUSTOM_RESOURCES_PATH.empty()) {
-            brls::Logger::warning("Custom theme not found: {}", customThemeID);
-        }
-    }
-
     // 初始化 UI 缩放
     std::string UIScale =
         getSettingItem(SettingItem::APP_UI_SCALE, std::string{""});
@@ -532,6 +592,24 @@ void ProgramConfig::load() {
     // 初始化内存缓存大小
     MPVCore::INMEMORY_CACHE = getIntOption(SettingItem::PLAYER_INMEMORY_CACHE);
 
+    // 初始化磁盘媒体缓存大小
+    MediaProxy::CACHE_SIZE = getIntOption(SettingItem::PLAYER_MEDIA_CACHE);
+
+    // 初始化媒体并行下载连接数
+    MediaProxy::CONNECTIONS =
+        getIntOption(SettingItem::PLAYER_MEDIA_CONNECTIONS);
+
+    // 播放体验指标服务端口，为 0 时不启动
+    QoeRecorder::METRICS_PORT =
+        getSettingItem(SettingItem::PLAYER_QOE_PORT, QoeRecorder::METRICS_PORT);
+
+    // 离线缓存的并行分段数与速度上限 (KB/s)，速度上限为 0 时不限制
+    DownloadManager::CONNECTIONS = std::max(
+        1, getSettingItem(SettingItem::DOWNLOAD_CONNECTIONS,
+                          DownloadManager::CONNECTIONS));
+    DownloadManager::SPEED_LIMIT = getSettingItem(
+        SettingItem::DOWNLOAD_SPEED_LIMIT, DownloadManager::SPEED_LIMIT);
+
     // 初始化是否使用opencc自动转换简体
     brls::Label::OPENCC_ON = getBoolOption(SettingItem::OPENCC_ON);
 
@@ -576,6 +654,32 @@ void ProgramConfig::load() {
     brls::Application::setDeactivatedFPS(
         getSettingItem(SettingItem::DEACTIVATED_FPS, 5));
 
+    // 初始化按需绘制
+    // borealis 自身的动画 (焦点、滚动、跑马灯、页面切换) 无法请求绘制，
+    // 空闲时会降到很低的帧率，所以默认关闭
+    FrameScheduler::ENABLE =
+        getSettingItem(SettingItem::ON_DEMAND_RENDER, false);
+#ifdef PERF_TRACE
+    FrameScheduler::STAT_INTERVAL = 60;
+#endif
+    // 初始化列表的内存上限，内存较小的平台默认开启
+#if defined(__PSV__)
+    int listMemoryLimit = 512;
+#else
+    int listMemoryLimit = 0;
+#endif
+    WindowedDataSourceBase::MEMORY_LIMIT =
+        getSettingItem(SettingItem::LIST_MEMORY_LIMIT, listMemoryLimit) * 1024;
+
+    // 初始化列表快照
+    FeedSnapshot::ENABLE = getSettingItem(SettingItem::FEED_SNAPSHOT, true);
+
+    // 网络请求完成后唤醒主循环处理回调
+    bilibili::HTTP::ON_RESPONSE = []() { FrameScheduler::instance().wakeUp(); };
+    // 焦点变化时 borealis 会播放焦点动画，保持正常帧率
+    brls::Application::getGlobalFocusChangeEvent()->subscribe(
+        [](brls::View* view) { FrameScheduler::instance().wakeUp(); });
+
     // 初始化一些在创建窗口之后才能初始化的内容
     brls::Application::getWindowCreationDoneEvent()->subscribe([this]() {
         // 初始化主题
@@ -616,7 +720,25 @@ void ProgramConfig::load() {
 #endif
 
     // 检查不欢迎名单
-    wiliwili::checkBanList();
+    StartupProfiler::instance().defer("check_ban_list",
+                                      []() { wiliwili::checkBanList(); });
+
+    // 初始化自定义布局
+    fontTask.get();
+    themeTask.get();
+    std::string customThemeID =
+        getSettingItem(SettingItem::APP_RESOURCES, std::string{""});
+    if (!customThemeID.empty()) {
+        for (auto& theme : customThemes) {
+            if (theme.id == customThemeID) {
+                brls::View::CUSTOM_RESOURCES_PATH = theme.path;
+                break;
+            }
+        }
+        if (brls::View::CUSTOM_RESOURCES_PATH.empty()) {
+            brls::Logger::warning("Custom theme not found: {}", customThemeID);
+        }
+    }
 }
 
 ProgramOption ProgramConfig::getOptionData(SettingItem item) {
@@ -686,29 +808,39 @@ int ProgramConfig::getStringOptionIndex(SettingItem item) {
 }
 
 void ProgramConfig::save() {
-    const std::string path = this->getConfigDir() + "/wiliwili_config.json";
     // fs is defined in cpr/cpr.h
 #ifndef IOS
-    fs::create_directories(this->getConfigDir());
+    static bool dirCreated = false;
+    if (!dirCreated) {
+        fs::create_directories(this->getConfigDir());
+        dirCreated = true;
+    }
 #endif
     nlohmann::json content(*this);
-    std::ofstream writeFile(path);
-    if (!writeFile) {
-        brls::Logger::error("Cannot write config to: {}", path);
-        return;
-    }
-    writeFile << content.dump(2);
-    writeFile.close();
-    brls::Logger::info("Write config to: {}", path);
+    // 配置文件中已经包含了全部搜索历史，写入后清空日志
+    ConfigWriter::instance().write(this->getConfigPath(), content.dump(2),
+                                   {this->getSearchHistoryPath()});
+}
+
+std::string ProgramConfig::getConfigPath() {
+    return this->getConfigDir() + "/wiliwili_config.json";
+}
+
+std::string ProgramConfig::getSearchHistoryPath() {
+    return this->getConfigDir() + "/search_history.log";
 }
 
 void ProgramConfig::init() {
     brls::Logger::info("wiliwili {}", APPVersion::instance().git_tag);
 
     // Set min_threads and max_threads of http thread pool
-    curl_global_init(CURL_GLOBAL_DEFAULT);
-    cpr::async::startup(THREAD_POOL_MIN_THREAD_NUM, THREAD_POOL_MAX_THREAD_NUM,
-                        std::chrono::milliseconds(5000));
+    {
+        StartupProfiler::Phase phase("curl_init");
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        cpr::async::startup(THREAD_POOL_MIN_THREAD_NUM,
+                            THREAD_POOL_MAX_THREAD_NUM,
+                            std::chrono::milliseconds(5000));
+    }
 
 #if defined(_MSC_VER)
 #elif defined(__PSV__)
@@ -728,42 +860,11 @@ void ProgramConfig::init() {
     }
 #endif
 
-    // load custom theme
-    this->loadCustomThemes();
-
-    // load config from disk
+    // load config from disk, custom themes and fonts are loaded in it
     this->load();
 
-    // init custom font path
-    brls::FontLoader::USER_FONT_PATH = getConfigDir() + "/font.ttf";
-    brls::FontLoader::USER_ICON_PATH = getConfigDir() + "/icon.ttf";
-
-    if (access(brls::FontLoader::USER_ICON_PATH.c_str(), F_OK) == -1) {
-        // 自定义字体不存在，使用内置字体
-#if defined(__PSV__) || defined(PS4)
-        brls::FontLoader::USER_ICON_PATH = BRLS_ASSET("font/keymap_ps.ttf");
-#else
-        std::string icon =
-            getSettingItem(SettingItem::KEYMAP, std::string{"xbox"});
-        if (icon == "xbox") {
-            brls::FontLoader::USER_ICON_PATH =
-                BRLS_ASSET("font/keymap_xbox.ttf");
-        } else if (icon == "ps") {
-            brls::FontLoader::USER_ICON_PATH = BRLS_ASSET("font/keymap_ps.ttf");
-        } else {
-            brls::FontLoader::USER_ICON_PATH =
-                BRLS_ASSET("font/keymap_keyboard.ttf");
-        }
-#endif
-    }
-
-    brls::FontLoader::USER_EMOJI_PATH = getConfigDir() + "/emoji.ttf";
-    if (access(brls::FontLoader::USER_EMOJI_PATH.c_str(), F_OK) == -1) {
-        // 自定义emoji不存在，使用内置emoji
-        brls::FontLoader::USER_EMOJI_PATH = BRLS_ASSET("font/emoji.ttf");
-    }
-
     // set bilibili cookie and cookie update callback
+    StartupProfiler::Phase phase("bili_init");
     Cookie diskCookie = this->getCookie();
     BILI::init(
         diskCookie,
@@ -844,6 +945,7 @@ std::string ProgramConfig::getConfigDir() {
 }
 
 void ProgramConfig::exit(char* argv[]) {
+    ConfigWriter::instance().flush();
     cpr::async::cleanup();
     curl_global_cleanup();
 
@@ -869,6 +971,34 @@ void ProgramConfig::exit(char* argv[]) {
 #endif
 }
 
+void ProgramConfig::initFontPath(const std::string& keymap) {
+    brls::FontLoader::USER_FONT_PATH = getConfigDir() + "/font.ttf";
+    brls::FontLoader::USER_ICON_PATH = getConfigDir() + "/icon.ttf";
+
+    if (access(brls::FontLoader::USER_ICON_PATH.c_str(), F_OK) == -1) {
+        // 自定义字体不存在，使用内置字体
+#if defined(__PSV__) || defined(PS4)
+        brls::FontLoader::USER_ICON_PATH = BRLS_ASSET("font/keymap_ps.ttf");
+#else
+        if (keymap == "xbox") {
+            brls::FontLoader::USER_ICON_PATH =
+                BRLS_ASSET("font/keymap_xbox.ttf");
+        } else if (keymap == "ps") {
+            brls::FontLoader::USER_ICON_PATH = BRLS_ASSET("font/keymap_ps.ttf");
+        } else {
+            brls::FontLoader::USER_ICON_PATH =
+                BRLS_ASSET("font/keymap_keyboard.ttf");
+        }
+#endif
+    }
+
+    brls::FontLoader::USER_EMOJI_PATH = getConfigDir() + "/emoji.ttf";
+    if (access(brls::FontLoader::USER_EMOJI_PATH.c_str(), F_OK) == -1) {
+        // 自定义emoji不存在，使用内置emoji
+        brls::FontLoader::USER_EMOJI_PATH = BRLS_ASSET("font/emoji.ttf");
+    }
+}
+
 void ProgramConfig::loadCustomThemes() {
     customThemes.clear();
     std::string directoryPath = getConfigDir() + "/theme";
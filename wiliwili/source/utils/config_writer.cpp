@@ -0,0 +1,165 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <cstdio>
+#include <algorithm>
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include <borealis/core/logger.hpp>
+
+#include "utils/config_writer.hpp"
+
+static bool syncFile(FILE* fp) {
+    if (fflush(fp) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(fp)) == 0;
+#else
+    return fsync(fileno(fp)) == 0;
+#endif
+}
+
+ConfigWriter::ConfigWriter() {
+    thread = std::thread([this]() { this->run(); });
+}
+
+ConfigWriter::~ConfigWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    cv.notify_all();
+    if (thread.joinable()) thread.join();
+    this->process();
+}
+
+void ConfigWriter::write(const std::string& path, std::string content,
+                         const std::vector<std::string>& resetLogs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& task   = files[path];
+    task.content = std::move(content);
+    for (auto& log : resetLogs) {
+        // 等待追加的内容已经包含在新的文件中
+        logs.erase(log);
+        if (std::find(task.resetLogs.begin(), task.resetLogs.end(), log) ==
+            task.resetLogs.end())
+            task.resetLogs.emplace_back(log);
+    }
+    this->schedule();
+}
+
+void ConfigWriter::append(const std::string& path, const std::string& line) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& data = logs[path];
+    data += line;
+    data += '\n';
+    this->schedule();
+}
+
+void ConfigWriter::flush() { this->process(); }
+
+void ConfigWriter::schedule() {
+    if (scheduled) return;
+    scheduled = true;
+    deadline  = std::chrono::steady_clock::now() +
+               std::chrono::milliseconds(DELAY);
+    cv.notify_all();
+}
+
+void ConfigWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!quit) {
+        if (!scheduled) {
+            cv.wait(lock);
+            continue;
+        }
+        if (cv.wait_until(lock, deadline, [this]() { return quit; })) break;
+        lock.unlock();
+        this->process();
+        lock.lock();
+    }
+}
+
+void ConfigWriter::process() {
+    std::lock_guard<std::mutex> io(ioMutex);
+    std::unordered_map<std::string, FileTask> fileList;
+    std::unordered_map<std::string, std::string> logList;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fileList.swap(files);
+        logList.swap(logs);
+        scheduled = false;
+    }
+
+    // 先写入完整的文件，再追加之后产生的日志
+    for (auto& i : fileList) {
+        if (!writeAtomic(i.first, i.second.content)) continue;
+        for (auto& log : i.second.resetLogs) {
+            FILE* fp = fopen(log.c_str(), "wb");
+            if (fp) fclose(fp);
+        }
+    }
+    for (auto& i : logList) {
+        FILE* fp = fopen(i.first.c_str(), "ab");
+        if (!fp) {
+            brls::Logger::error("ConfigWriter: cannot open {}", i.first);
+            continue;
+        }
+        fwrite(i.second.data(), 1, i.second.size(), fp);
+        syncFile(fp);
+        fclose(fp);
+    }
+}
+
+bool ConfigWriter::writeAtomic(const std::string& path,
+                               const std::string& content) {
+    std::string temp = path + ".tmp";
+    FILE* fp         = fopen(temp.c_str(), "wb");
+    if (!fp) {
+        brls::Logger::error("ConfigWriter: cannot write {}", temp);
+        return false;
+    }
+    bool ok = fwrite(content.data(), 1, content.size(), fp) == content.size();
+    ok      = syncFile(fp) && ok;
+    fclose(fp);
+    if (!ok) {
+        brls::Logger::error("ConfigWriter: failed to write {}", temp);
+        remove(temp.c_str());
+        return false;
+    }
+
+#if defined(__WINRT__)
+    remove(path.c_str());
+    ok = rename(temp.c_str(), path.c_str()) == 0;
+#elif defined(_WIN32)
+    ok = MoveFileExA(temp.c_str(), path.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    ok = rename(temp.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) {
+        brls::Logger::error("ConfigWriter: failed to replace {}", path);
+        return false;
+    }
+    brls::Logger::info("Write config to: {}", path);
+    return true;
+}
+
+bool ConfigWriter::read(const std::string& path, std::string& content) {
+    for (auto& i : {path, path + ".tmp"}) {
+        FILE* fp = fopen(i.c_str(), "rb");
+        if (!fp) continue;
+        content.clear();
+        char buffer[4096];
+        size_t size;
+        while ((size = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+            content.append(buffer, size);
+        fclose(fp);
+        if (!content.empty()) return true;
+    }
+    return false;
+}
@@ -0,0 +1,673 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <cpr/cpr.h>
+#include <pystring.h>
+#include <borealis/core/i18n.hpp>
+#include <borealis/core/thread.hpp>
+#include <borealis/core/logger.hpp>
+#include <borealis/core/application.hpp>
+
+#include "bilibili.h"
+#include "utils/download_manager.hpp"
+#include "utils/config_helper.hpp"
+#include "utils/config_writer.hpp"
+#include "utils/opencc_helper.hpp"
+#include "utils/string_helper.hpp"
+#include "presenter/presenter.h"
+#include "view/danmaku_core.hpp"
+#include "view/subtitle_core.hpp"
+
+using namespace brls::literals;
+
+/// 超过该时长未收到数据视为连接中断
+#define DOWNLOAD_STALL_TIMEOUT 15
+
+class DownloadThreadPool : public cpr::ThreadPool,
+                           public brls::Singleton<DownloadThreadPool> {
+public:
+    DownloadThreadPool()
+        : cpr::ThreadPool(1, 8, std::chrono::milliseconds(5000)) {
+        this->Start();
+    }
+
+    ~DownloadThreadPool() override { this->Stop(); }
+};
+
+static std::string getQueuePath() {
+    return ProgramConfig::instance().getConfigDir() + "/download_queue.json";
+}
+
+static int64_t getUnixTimeMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * 按照设定的清晰度、编码与音质选择视频与音频，规则与播放时相同
+ * @return 没有可用的视频时返回 false
+ */
+static bool selectTracks(const bilibili::VideoUrlResult& result, int quality,
+                         int codecid, int audioId, bilibili::DashMedia& video,
+                         bilibili::DashMedia& audio) {
+    if (result.dash.video.empty()) return false;
+
+    // 找到不高于 quality 的最高清晰度
+    int target = result.dash.video.back().id;
+    for (const auto& i : result.dash.video) {
+        if (quality >= i.id) {
+            target = i.id;
+            break;
+        }
+    }
+    bool found = false;
+    for (const auto& i : result.dash.video) {
+        if (i.id != target) continue;
+        if (!found || i.codecid == codecid) video = i;
+        found = true;
+        if (i.codecid == codecid) break;
+    }
+
+    audio = bilibili::DashMedia();
+    if (!result.dash.audio.empty()) {
+        audio = result.dash.audio[0];
+        for (const auto& i : result.dash.audio) {
+            if (i.id == audioId) {
+                audio = i;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+static std::vector<std::string> getMirrors(const bilibili::DashMedia& media) {
+    std::vector<std::string> urls;
+    if (media.base_url.empty()) return urls;
+    urls.emplace_back(media.base_url);
+    urls.insert(urls.end(), media.backup_url.begin(), media.backup_url.end());
+    return urls;
+}
+
+/// DownloadFile
+
+bool DownloadFile::isFinished() const {
+    if (name.empty()) return true;
+    if (size == 0) return false;
+    return std::all_of(done.begin(), done.end(), [](bool i) { return i; });
+}
+
+size_t DownloadFile::getFinishedSize() const {
+    size_t res = 0;
+    for (size_t i = 0; i < done.size(); i++) {
+        if (!done[i]) continue;
+        res += std::min(DownloadManager::SEGMENT_SIZE,
+                        size - i * DownloadManager::SEGMENT_SIZE);
+    }
+    return res;
+}
+
+/// DownloadTask
+
+float DownloadTask::getProgress() const {
+    size_t total = video.size + audio.size;
+    if (total == 0) return 0;
+    return (float)(video.getFinishedSize() + audio.getFinishedSize()) /
+           (float)total;
+}
+
+/// DownloadManager
+
+DownloadManager::DownloadManager() {
+    limitTime = std::chrono::steady_clock::now();
+
+    std::string data;
+    if (ConfigWriter::read(getQueuePath(), data)) {
+        try {
+            nlohmann::json::parse(data).get_to(tasks);
+        } catch (const std::exception& e) {
+            brls::Logger::error("DownloadManager: failed to load queue: {}",
+                                e.what());
+        }
+    }
+
+    brls::Application::getExitEvent()->subscribe([this]() {
+        // 正在下载的分段会被中断，下次启动后重新下载
+        quit = true;
+        this->save();
+    });
+
+    // 重新下载上次没有保存成功的弹幕与字幕
+    for (auto& i : tasks) downloadExtras(i);
+
+    // 继续上次未完成的任务
+    this->schedule();
+}
+
+void DownloadManager::add(const std::string& bvid, unsigned int cid,
+                          const std::string& title, bool season,
+                          const bilibili::VideoUrlResult& result) {
+    auto* task = findTask(cid);
+    if (task) {
+        if (task->state != DownloadState::FAILED) return;
+        // 重新开始失败的任务，已下载的分段继续保留
+        task->state    = DownloadState::WAITING;
+        task->failures = 0;
+        task->videoUrls.clear();
+        task->audioUrls.clear();
+        this->save();
+        this->schedule();
+        return;
+    }
+
+    bilibili::DashMedia video, audio;
+    if (!selectTracks(result, result.quality, BILI::VIDEO_CODEC,
+                      BILI::AUDIO_QUALITY, video, audio))
+        return;
+
+    DownloadTask item;
+    item.bvid    = bvid;
+    item.cid     = cid;
+    item.title   = title;
+    item.season  = season;
+    item.quality = video.id;
+    item.codecid = video.codecid;
+    item.audioId = audio.id;
+    item.time    = getUnixTimeMs();
+    for (size_t i = 0; i < result.accept_quality.size() &&
+                       i < result.accept_description.size();
+         i++) {
+        if (result.accept_quality[i] == video.id)
+            item.description = result.accept_description[i];
+    }
+    item.video.name = "video.m4s";
+    if (!audio.base_url.empty()) item.audio.name = "audio.m4s";
+    // 直接使用当前的播放链接，无需重新请求
+    item.videoUrls = getMirrors(video);
+    item.audioUrls = getMirrors(audio);
+
+    try {
+        fs::create_directories(getTaskDir(cid));
+    } catch (const std::exception& e) {
+        brls::Logger::error("DownloadManager: cannot create dir: {}", e.what());
+        return;
+    }
+
+    brls::Logger::info("DownloadManager: add {}/{} quality: {}", bvid, cid,
+                       item.quality);
+    tasks.emplace_back(std::move(item));
+    downloadExtras(tasks.back());
+    this->save();
+    this->schedule();
+}
+
+const DownloadTask* DownloadManager::getTask(unsigned int cid) {
+    return findTask(cid);
+}
+
+DownloadTask* DownloadManager::findTask(unsigned int cid) {
+    for (auto& i : tasks)
+        if (i.cid == cid) return &i;
+    return nullptr;
+}
+
+bool DownloadManager::getLocalVideo(unsigned int cid,
+                                    bilibili::VideoUrlResult& result) {
+    auto* task = findTask(cid);
+    if (!task || task->state != DownloadState::FINISHED) return false;
+
+    std::string dir = getTaskDir(cid);
+    if (!isFileComplete(dir, task->video) ||
+        !isFileComplete(dir, task->audio)) {
+        // 缓存的文件已被删除或不完整
+        brls::Logger::warning("DownloadManager: missing file: {}", dir);
+        task->state = DownloadState::FAILED;
+        resetFile(task->video);
+        resetFile(task->audio);
+        this->save();
+        return false;
+    }
+
+    bilibili::DashMedia video{};
+    video.id       = task->quality;
+    video.codecid  = task->codecid;
+    video.base_url = dir + "/" + task->video.name;
+
+    result                    = bilibili::VideoUrlResult();
+    result.quality            = task->quality;
+    result.accept_quality     = {task->quality};
+    result.accept_description = {task->description};
+    result.dash.video         = {video};
+    if (!task->audio.name.empty()) {
+        bilibili::DashMedia audio{};
+        audio.id       = task->audioId;
+        audio.base_url = dir + "/" + task->audio.name;
+        result.dash.audio = {audio};
+    }
+    return true;
+}
+
+bool DownloadManager::isFileComplete(const std::string& dir,
+                                     const DownloadFile& file) {
+    if (file.name.empty()) return true;
+    if (!file.isFinished()) return false;
+    std::string path = dir + "/" + file.name;
+    try {
+        return fs::exists(path) && fs::file_size(path) >= file.size;
+    } catch (const std::exception& e) {
+        return false;
+    }
+}
+
+void DownloadManager::loadExtras(unsigned int cid) {
+    std::string dir = getTaskDir(cid);
+    DownloadThreadPool::instance().Submit([dir]() {
+        std::string content;
+        if (ConfigWriter::read(dir + "/danmaku.xml", content)) {
+            std::vector<DanmakuItem> items = DanmakuCore::decodeXML(content);
+            OpenCCHelper::instance().convertBatch(
+                items, [](DanmakuItem& i) -> std::string& { return i.msg; });
+            brls::sync([data = wiliwili::moveToShared(std::move(items))]() {
+                DanmakuCore::instance().loadDanmakuData(std::move(*data));
+            });
+        }
+
+        bilibili::VideoPageResult page{};
+        if (ConfigWriter::read(dir + "/subtitles.json", content)) {
+            try {
+                for (auto& i : nlohmann::json::parse(content)) {
+                    auto subtitle = i.get<bilibili::VideoPageSubtitle>();
+                    i.at("data").get_to(subtitle.data);
+                    page.subtitles.emplace_back(std::move(subtitle));
+                }
+            } catch (const std::exception& e) {
+                brls::Logger::error("DownloadManager: bad subtitles: {}",
+                                    e.what());
+                page.subtitles.clear();
+            }
+        }
+        brls::sync([data = wiliwili::moveToShared(std::move(page))]() {
+            SubtitleCore::instance().setSubtitleList(*data);
+            // 存在UP主设置的字幕
+            if (!data->subtitles.empty() &&
+                pystring::count(data->subtitles[0].lan, "ai") <= 0) {
+                SubtitleCore::instance().selectSubtitle(0);
+            }
+        });
+    });
+}
+
+bool DownloadManager::isLocalUrl(const std::string& url) {
+    return !url.empty() && !pystring::startswith(url, "http://") &&
+           !pystring::startswith(url, "https://");
+}
+
+std::string DownloadManager::getTaskDir(unsigned int cid) {
+    return ProgramConfig::instance().getConfigDir() + "/download/" +
+           std::to_string(cid);
+}
+
+void DownloadManager::schedule() {
+    if (quit) return;
+    for (auto& task : tasks) {
+        if (running >= CONNECTIONS) return;
+        if (task.state != DownloadState::WAITING || task.resolving) continue;
+        if (task.videoUrls.empty()) {
+            this->resolve(task);
+            continue;
+        }
+        this->dispatch(task, task.video, task.videoUrls);
+        this->dispatch(task, task.audio, task.audioUrls);
+    }
+}
+
+void DownloadManager::resolve(DownloadTask& task) {
+    task.resolving   = true;
+    unsigned int cid = task.cid;
+    brls::Logger::debug("DownloadManager: request url {}/{}", task.bvid, cid);
+
+    auto callback = [this, cid](bilibili::VideoUrlResult result) {
+        brls::sync(
+            [this, cid, data = wiliwili::moveToShared(std::move(result))]() {
+                this->onResolved(cid, *data);
+            });
+    };
+    auto error = [this, cid](BILI_ERR) {
+        brls::sync([this, cid, error]() { this->onResolveError(cid, error); });
+    };
+    if (task.season) {
+        BILI::get_season_url((int)cid, task.quality, callback, error);
+    } else {
+        BILI::get_video_url(task.bvid, (int)cid, task.quality, callback, error);
+    }
+}
+
+void DownloadManager::onResolved(unsigned int cid,
+                                 const bilibili::VideoUrlResult& result) {
+    auto* task = findTask(cid);
+    if (!task) return;
+    task->resolving = false;
+
+    bilibili::DashMedia video, audio;
+    if (!selectTracks(result, task->quality, task->codecid, task->audioId,
+                      video, audio)) {
+        // 不支持 flv 格式
+        this->onFailed(*task, "no dash media");
+        return;
+    }
+
+    // 清晰度或编码发生了变化 (如登录状态改变)，已下载的数据不能继续使用
+    if (video.id != task->quality || video.codecid != task->codecid ||
+        audio.id != task->audioId) {
+        brls::Logger::warning("DownloadManager: {} media changed, restart",
+                              cid);
+        task->quality = video.id;
+        task->codecid = video.codecid;
+        task->audioId = audio.id;
+        task->generation++;
+        resetFile(task->video);
+        resetFile(task->audio);
+        task->audio.name = audio.base_url.empty() ? "" : "audio.m4s";
+        this->save();
+    }
+
+    task->videoUrls = getMirrors(video);
+    task->audioUrls = getMirrors(audio);
+    downloadExtras(*task);
+    this->schedule();
+}
+
+void DownloadManager::onResolveError(unsigned int cid,
+                                     const std::string& error) {
+    auto* task = findTask(cid);
+    if (!task) return;
+    task->resolving = false;
+    this->onFailed(*task, error);
+}
+
+void DownloadManager::downloadExtras(DownloadTask& task) {
+    if (task.extras || task.fetchingExtras) return;
+    task.fetchingExtras = true;
+    std::string dir     = getTaskDir(task.cid);
+    unsigned int cid    = task.cid;
+
+    // 弹幕与字幕都保存成功后才标记完成，否则下次获取播放链接或重启时重试
+    struct Extras {
+        std::atomic_int remaining{2};
+        std::atomic_bool success{true};
+    };
+    auto extras = std::make_shared<Extras>();
+    auto finish = [this, cid, extras](bool success) {
+        if (!success) extras->success = false;
+        if (--extras->remaining > 0) return;
+        bool result = extras->success;
+        brls::sync([this, cid, result]() { this->onExtras(cid, result); });
+    };
+
+    BILI::get_danmaku(
+        cid,
+        [dir, finish](const std::string& result) {
+            finish(ConfigWriter::writeAtomic(dir + "/danmaku.xml", result));
+        },
+        [cid, finish](BILI_ERR) {
+            brls::Logger::error("DownloadManager: danmaku {}: {}", cid, error);
+            finish(false);
+        });
+
+    BILI::get_page_detail(
+        task.bvid, (int)cid,
+        [dir, finish](const bilibili::VideoPageResult& result) {
+            if (result.subtitles.empty()) {
+                finish(true);
+                return;
+            }
+            // 所有字幕下载完成后一起写入
+            struct Pending {
+                std::mutex mutex;
+                nlohmann::json list = nlohmann::json::array();
+                size_t remaining    = 0;
+                bool failed         = false;
+            };
+            auto pending       = std::make_shared<Pending>();
+            pending->remaining = result.subtitles.size();
+            auto done          = [dir, pending, finish]() {
+                if (--pending->remaining > 0) return;
+                if (pending->failed) {
+                    finish(false);
+                    return;
+                }
+                finish(ConfigWriter::writeAtomic(dir + "/subtitles.json",
+                                                 pending->list.dump()));
+            };
+            for (auto& i : result.subtitles) {
+                nlohmann::json item = {{"id_str", i.id_str},
+                                       {"lan", i.lan},
+                                       {"lan_doc", i.lan_doc},
+                                       {"subtitle_url", ""}};
+                BILI::get_subtitle(
+                    i.subtitle_url,
+                    [pending, done, item](const bilibili::SubtitleData& data) {
+                        std::lock_guard<std::mutex> lock(pending->mutex);
+                        auto subtitle    = item;
+                        subtitle["data"] = data;
+                        pending->list.emplace_back(std::move(subtitle));
+                        done();
+                    },
+                    [pending, done](BILI_ERR) {
+                        std::lock_guard<std::mutex> lock(pending->mutex);
+                        pending->failed = true;
+                        done();
+                    });
+            }
+        },
+        [cid, finish](BILI_ERR) {
+            brls::Logger::error("DownloadManager: subtitle {}: {}", cid, error);
+            finish(false);
+        });
+}
+
+void DownloadManager::onExtras(unsigned int cid, bool success) {
+    auto* task = findTask(cid);
+    if (!task) return;
+    task->fetchingExtras = false;
+    if (!success) return;
+    task->extras = true;
+    this->save();
+}
+
+void DownloadManager::dispatch(DownloadTask& task, DownloadFile& file,
+                               const std::vector<std::string>& urls) {
+    if (file.name.empty() || urls.empty()) return;
+    // 文件大小未知时先下载第一个分段，从响应中得到文件大小
+    size_t count = file.size == 0 ? 1 : file.done.size();
+    for (size_t index = 0; index < count && running < CONNECTIONS; index++) {
+        if (file.size > 0 && file.done[index]) continue;
+        if (file.running.count(index)) continue;
+
+        size_t from = index * SEGMENT_SIZE;
+        size_t to   = from + SEGMENT_SIZE - 1;
+        if (file.size > 0) to = std::min(to, file.size - 1);
+        // 不同的分段轮流使用不同的镜像
+        std::string url  = urls[index % urls.size()];
+        std::string path = getTaskDir(task.cid) + "/" + file.name;
+        unsigned int cid = task.cid;
+        bool isAudio     = &file == &task.audio;
+        int generation   = task.generation;
+
+        file.running.insert(index);
+        running++;
+        DownloadThreadPool::instance().Submit([this, url, path, from, to, cid,
+                                               isAudio, index, generation]() {
+            size_t total = 0;
+            bool success = this->fetchSegment(url, path, from, to, total);
+            brls::sync([this, cid, isAudio, index, generation, success,
+                        total]() {
+                this->onSegment(cid, isAudio, index, generation, success,
+                                total);
+            });
+        });
+    }
+}
+
+void DownloadManager::onSegment(unsigned int cid, bool isAudio, size_t index,
+                                int generation, bool success, size_t total) {
+    running--;
+    auto* task = findTask(cid);
+    if (!task) return;
+    auto& file = isAudio ? task->audio : task->video;
+    file.running.erase(index);
+
+    if (quit) return;
+    if (generation != task->generation) {
+        this->schedule();
+        return;
+    }
+    if (!success) {
+        this->onFailed(*task, "segment " + std::to_string(index));
+        return;
+    }
+
+    if (file.size == 0) {
+        file.size = total;
+        file.done.assign((total + SEGMENT_SIZE - 1) / SEGMENT_SIZE, false);
+    } else if (total != file.size) {
+        // 服务器上的文件发生了变化
+        brls::Logger::warning("DownloadManager: {} size changed, restart", cid);
+        task->generation++;
+        resetFile(file);
+        this->save();
+        this->schedule();
+        return;
+    }
+    if (index < file.done.size()) file.done[index] = true;
+    task->failures = 0;
+
+    if (task->video.isFinished() && task->audio.isFinished()) {
+        task->state = DownloadState::FINISHED;
+        brls::Logger::info("DownloadManager: finished {}/{}", task->bvid, cid);
+        brls::Application::notify(wiliwili::format(
+            "wiliwili/player/download/done"_i18n, task->title));
+    }
+    this->save();
+    this->schedule();
+}
+
+void DownloadManager::onFailed(DownloadTask& task, const std::string& reason) {
+    brls::Logger::warning("DownloadManager: {} failed: {}", task.cid, reason);
+    if (++task.failures >= MAX_FAILURES) {
+        task.state = DownloadState::FAILED;
+        brls::Application::notify(wiliwili::format(
+            "wiliwili/player/download/failed"_i18n, task.title));
+        this->save();
+    } else {
+        // 链接可能已经过期，下次调度时重新获取
+        task.videoUrls.clear();
+        task.audioUrls.clear();
+    }
+    // 失败后稍后再重试，避免网络不可用时连续请求
+    brls::delay(3000, [this]() { this->schedule(); });
+}
+
+void DownloadManager::resetFile(DownloadFile& file) {
+    file.size = 0;
+    file.done.clear();
+}
+
+bool DownloadManager::fetchSegment(const std::string& url,
+                                   const std::string& path, size_t from,
+                                   size_t to, size_t& total) {
+    // 以追加模式创建文件，避免其它线程写入的数据被清空
+    std::ofstream(path, std::ios::binary | std::ios::app).close();
+    std::fstream out(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!out) {
+        brls::Logger::error("DownloadManager: cannot open {}", path);
+        return false;
+    }
+    out.seekp((std::streamoff)from);
+
+    int status = 0;
+    size_t pos = from;
+    auto lastData = std::chrono::steady_clock::now();
+
+    cpr::Session s;
+    s.SetUrl(cpr::Url{url});
+    s.SetHeader(cpr::Header{
+        {"User-Agent", bilibili::HTTP::HEADERS["User-Agent"]},
+        {"Referer", "https://www.bilibili.com"},
+        {"Range", fmt::format("bytes={}-{}", from, to)},
+    });
+    s.SetProxies(bilibili::HTTP::PROXIES);
+#ifndef VERIFY_SSL
+    s.SetVerifySsl(cpr::VerifySsl{false});
+#endif
+    s.SetConnectTimeout(cpr::ConnectTimeout{5000});
+    s.SetHeaderCallback(cpr::HeaderCallback{[&](std::string header,
+                                                intptr_t) {
+        std::string line = pystring::lower(pystring::strip(header));
+        if (pystring::startswith(line, "http/")) {
+            auto parts = pystring::split(line, " ");
+            if (parts.size() > 1) status = std::atoi(parts[1].c_str());
+        } else if (pystring::startswith(line, "content-range:")) {
+            auto p = line.rfind('/');
+            if (p != std::string::npos && line[p + 1] != '*')
+                total = std::strtoull(line.c_str() + p + 1, nullptr, 10);
+        }
+        return true;
+    }});
+    s.SetWriteCallback(cpr::WriteCallback{[&](std::string data, intptr_t) {
+        // 不支持范围请求的服务器无法分段下载
+        if (status != 206 || pos + data.size() > to + 1) return false;
+        this->limitSpeed(data.size());
+        out.write(data.data(), (std::streamsize)data.size());
+        pos += data.size();
+        lastData = std::chrono::steady_clock::now();
+        return !quit && out.good();
+    }});
+    s.SetProgressCallback(cpr::ProgressCallback{
+        [&](cpr::cpr_off_t, cpr::cpr_off_t, cpr::cpr_off_t, cpr::cpr_off_t,
+            intptr_t) {
+            if (quit) return false;
+            return std::chrono::steady_clock::now() - lastData <
+                   std::chrono::seconds(DOWNLOAD_STALL_TIMEOUT);
+        }});
+
+    auto r = s.Get();
+    out.flush();
+    if (r.error || status != 206 || total == 0 || !out.good()) {
+        if (!quit)
+            brls::Logger::warning("DownloadManager: fetch {} failed: {} {}",
+                                  url, status, r.error.message);
+        return false;
+    }
+    // 最后一个分段不足 SEGMENT_SIZE
+    return pos == std::min(to + 1, total);
+}
+
+void DownloadManager::limitSpeed(size_t size) {
+    if (SPEED_LIMIT <= 0) return;
+    double rate = SPEED_LIMIT * 1024.0;
+    double wait = 0;
+    {
+        std::lock_guard<std::mutex> lock(limitMutex);
+        auto now = std::chrono::steady_clock::now();
+        double elapsed =
+            std::chrono::duration<double>(now - limitTime).count();
+        limitTime = now;
+        // 最多积累一秒的额度
+        limitTokens = std::min(rate, limitTokens + elapsed * rate);
+        limitTokens -= (double)size;
+        if (limitTokens < 0) wait = -limitTokens / rate;
+    }
+    if (wait > 0)
+        std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+}
+
+void DownloadManager::save() {
+    ConfigWriter::instance().write(getQueuePath(),
+                                   nlohmann::json(tasks).dump());
+}
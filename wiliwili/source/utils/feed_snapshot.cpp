@@ -0,0 +1,43 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <borealis/core/application.hpp>
+
+#include "utils/feed_snapshot.hpp"
+#include "utils/config_helper.hpp"
+#include "utils/config_writer.hpp"
+
+FeedSnapshot::FeedSnapshot() {
+    std::string content;
+    if (ENABLE && ConfigWriter::read(getPath(), content)) {
+        try {
+            data = nlohmann::json::from_msgpack(content);
+        } catch (const std::exception& e) {
+            brls::Logger::error("FeedSnapshot: failed to load: {}", e.what());
+        }
+        // 快照属于其他账号
+        if (!data.is_object() || data.value("mid", std::string()) !=
+                                     ProgramConfig::instance().getUserID())
+            data = nlohmann::json::object();
+    }
+
+    brls::Application::getExitEvent()->subscribe([this]() { this->save(); });
+    brls::Application::getWindowFocusChangedEvent()->subscribe(
+        [this](bool focus) {
+            if (!focus) this->save();
+        });
+}
+
+void FeedSnapshot::save() {
+    if (!dirty) return;
+    dirty       = false;
+    data["mid"] = ProgramConfig::instance().getUserID();
+    auto bytes  = nlohmann::json::to_msgpack(data);
+    ConfigWriter::instance().write(getPath(),
+                                   std::string(bytes.begin(), bytes.end()));
+}
+
+std::string FeedSnapshot::getPath() {
+    return ProgramConfig::instance().getConfigDir() + "/feed_snapshot.bin";
+}
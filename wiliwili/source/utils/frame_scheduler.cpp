@@ -0,0 +1,129 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <borealis/core/time.hpp>
+#include <borealis/core/logger.hpp>
+
+#ifdef __SDL2__
+#include <SDL2/SDL.h>
+#elif defined(__GLFW__)
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#endif
+
+#include "utils/frame_scheduler.hpp"
+#include "utils/trace_helper.hpp"
+
+#ifdef __SDL2__
+static Uint32 WAKE_EVENT = (Uint32)-1;
+#endif
+
+FrameScheduler::FrameScheduler() {
+#ifdef __SDL2__
+    // 用于从其它线程唤醒 SDL_WaitEventTimeout
+    WAKE_EVENT = SDL_RegisterEvents(1);
+#endif
+    lastActive = statStart = brls::getCPUTimeUsec();
+}
+
+void FrameScheduler::requestFrame(int64_t delay) {
+    int64_t time = brls::getCPUTimeUsec() + delay;
+    if (time < deadline) deadline = time;
+}
+
+void FrameScheduler::wakeUp() {
+    if (!ENABLE || woken.exchange(true)) return;
+#ifdef __SDL2__
+    if (WAKE_EVENT != (Uint32)-1) {
+        SDL_Event event;
+        SDL_zero(event);
+        event.type = WAKE_EVENT;
+        SDL_PushEvent(&event);
+    }
+#elif defined(__GLFW__)
+    glfwPostEmptyEvent();
+#else
+    std::lock_guard<std::mutex> lock(mutex);
+    cv.notify_all();
+#endif
+}
+
+void FrameScheduler::waitForNextFrame() {
+    if (!ENABLE) return;
+    int64_t now  = brls::getCPUTimeUsec();
+    int64_t next = deadline;
+    deadline     = INT64_MAX;
+    frames++;
+    updateStat(now);
+
+    if (woken.exchange(false)) lastActive = now;
+    // 刚刚发生过变化，或者有动画需要立即绘制
+    if (now - lastActive < IDLE_DELAY * 1000LL || next <= now) return;
+
+    int64_t timeout = std::min<int64_t>(next - now, MAX_WAIT * 1000LL);
+    TRACE_SCOPE("frame", "FrameScheduler::idle");
+    bool event = this->wait(timeout);
+    int64_t end = brls::getCPUTimeUsec();
+    idleTime += end - now;
+    if (event || woken.exchange(false)) lastActive = end;
+}
+
+bool FrameScheduler::wait(int64_t timeout) {
+#ifdef __SDL2__
+    // 不取出事件，留给 borealis 处理
+    return SDL_WaitEventTimeout(nullptr, (int)(timeout / 1000)) == 1;
+#elif defined(__GLFW__)
+    // glfw 的手柄需要主动查询，分段等待并检查手柄状态
+    int64_t end = brls::getCPUTimeUsec() + timeout;
+    while (true) {
+        int64_t start = brls::getCPUTimeUsec();
+        if (start >= end) return false;
+        int64_t step = std::min<int64_t>(end - start, GAMEPAD_POLL * 1000LL);
+        glfwWaitEventsTimeout((double)step / 1000000);
+        // glfw 无法得知是否有事件发生，提前返回时认为有事件
+        if (brls::getCPUTimeUsec() - start + 1000 < step) return true;
+        if (woken.load() || gamepadActive()) return true;
+    }
+#else
+    std::unique_lock<std::mutex> lock(mutex);
+    return cv.wait_for(lock, std::chrono::microseconds(timeout),
+                       [this]() { return woken.load(); });
+#endif
+}
+
+bool FrameScheduler::gamepadActive() {
+#if defined(__GLFW__) && !defined(__SDL2__)
+    for (int i = GLFW_JOYSTICK_1; i <= GLFW_JOYSTICK_LAST; i++) {
+        GLFWgamepadstate state;
+        if (!glfwJoystickIsGamepad(i) || !glfwGetGamepadState(i, &state))
+            continue;
+        for (auto button : state.buttons)
+            if (button == GLFW_PRESS) return true;
+        for (int axis = 0; axis <= GLFW_GAMEPAD_AXIS_LAST; axis++) {
+            float value = state.axes[axis];
+            // 扳机在松开时为 -1
+            if (axis == GLFW_GAMEPAD_AXIS_LEFT_TRIGGER ||
+                axis == GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER)
+                value = (value + 1) / 2;
+            if (std::fabs(value) > 0.2f) return true;
+        }
+    }
+#endif
+    return false;
+}
+
+void FrameScheduler::updateStat(int64_t now) {
+    if (STAT_INTERVAL <= 0) return;
+    int64_t duration = now - statStart;
+    if (duration < STAT_INTERVAL * 1000000LL) return;
+    brls::Logger::info("FrameScheduler: {} frames in {}s, idle {:.1f}%",
+                       frames, duration / 1000000,
+                       idleTime * 100.0 / (double)duration);
+    statStart = now;
+    idleTime  = 0;
+    frames    = 0;
+}
@@ -0,0 +1,143 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <chrono>
+#include <algorithm>
+#include <borealis/core/logger.hpp>
+#include <borealis/core/thread.hpp>
+#include <borealis/core/application.hpp>
+
+#include "bilibili.h"
+#include "utils/history_reporter.hpp"
+#include "utils/config_helper.hpp"
+#include "utils/config_writer.hpp"
+
+HistoryReporter::HistoryReporter() {
+    this->load();
+    // 退出前尝试发送，未完成的记录已经保存在队列中，下次启动时重试
+    brls::Application::getExitEvent()->subscribe([this]() { this->flush(); });
+    // 切换到后台后程序可能被直接关闭
+    brls::Application::getWindowFocusChangedEvent()->subscribe(
+        [this](bool focus) {
+            if (!focus) this->flush();
+        });
+}
+
+uint64_t HistoryReporter::getKey(const HistoryReport& item) {
+    return ((uint64_t)item.aid << 32) | item.cid;
+}
+
+void HistoryReporter::report(HistoryReport item, bool flush) {
+    if (item.aid == 0 || item.cid == 0) return;
+    item.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+    pending[getKey(item)] = item;
+    if (flush) {
+        this->flush();
+    } else {
+        this->schedule();
+    }
+}
+
+void HistoryReporter::flush() {
+    std::string mid   = ProgramConfig::instance().getUserID();
+    std::string token = ProgramConfig::instance().getCSRF();
+    if (mid.empty() || mid == "0" || token.empty()) return;
+
+    if (!pending.empty()) {
+        for (auto& i : pending) unsent[i.first] = i.second;
+        pending.clear();
+        // 超出上限时丢弃最旧的记录
+        while (unsent.size() > QUEUE_SIZE) {
+            auto oldest = unsent.begin();
+            for (auto it = unsent.begin(); it != unsent.end(); it++)
+                if (it->second.time < oldest->second.time) oldest = it;
+            unsent.erase(oldest);
+        }
+        this->save();
+    }
+
+    for (auto& i : unsent) {
+        if (sending.count(i.first)) continue;
+        this->send(i.second);
+    }
+    // 发送失败的记录等待下一次重试
+    if (!unsent.empty()) this->schedule();
+}
+
+void HistoryReporter::schedule() {
+    if (scheduled) return;
+    scheduled = true;
+    // 按队列中失败次数最多的记录计算退避时间
+    int retries = 0;
+    for (auto& i : unsent) retries = std::max(retries, i.second.retries);
+    int64_t interval = (int64_t)FLUSH_INTERVAL << std::min(retries, 16);
+    interval         = std::min<int64_t>(interval, MAX_RETRY_INTERVAL);
+    brls::delay(interval, [this]() {
+        scheduled = false;
+        this->flush();
+    });
+}
+
+void HistoryReporter::send(const HistoryReport& item) {
+    uint64_t key = getKey(item);
+    int64_t time = item.time;
+    sending.insert(key);
+    brls::Logger::debug("reportHistory: aid{} cid{} progress{} duration{}",
+                        item.aid, item.cid, item.progress, item.duration);
+    BILI::report_history(
+        ProgramConfig::instance().getUserID(),
+        ProgramConfig::instance().getCSRF(), item.aid, item.cid, item.type,
+        item.progress, item.duration, item.sid, item.epid,
+        [this, key, time]() {
+            brls::sync([this, key, time]() {
+                sending.erase(key);
+                auto it = unsent.find(key);
+                // 发送期间产生的新进度需要继续发送
+                if (it == unsent.end() || it->second.time > time) return;
+                unsent.erase(it);
+                this->save();
+                brls::Logger::debug("reportHistory: success");
+            });
+        },
+        [this, key, time](BILI_ERR) {
+            brls::sync([this, key, time, error]() {
+                sending.erase(key);
+                brls::Logger::error("reportHistory: {}", error);
+                auto it = unsent.find(key);
+                // 发送期间产生的新进度重新计数
+                if (it == unsent.end() || it->second.time > time) return;
+                if (++it->second.retries >= MAX_RETRIES) {
+                    brls::Logger::warning("reportHistory: drop aid{} cid{}",
+                                          it->second.aid, it->second.cid);
+                    unsent.erase(it);
+                }
+                this->save();
+            });
+        });
+}
+
+void HistoryReporter::load() {
+    std::string data;
+    if (!ConfigWriter::read(
+            ProgramConfig::instance().getConfigDir() + "/history_queue.json",
+            data))
+        return;
+    try {
+        for (auto& i : nlohmann::json::parse(data).get<std::vector<HistoryReport>>())
+            unsent[getKey(i)] = i;
+    } catch (const std::exception& e) {
+        brls::Logger::error("HistoryReporter: failed to load queue: {}",
+                            e.what());
+    }
+}
+
+void HistoryReporter::save() {
+    std::vector<HistoryReport> list;
+    for (auto& i : unsent) list.emplace_back(i.second);
+    ConfigWriter::instance().write(
+        ProgramConfig::instance().getConfigDir() + "/history_queue.json",
+        nlohmann::json(list).dump());
+}
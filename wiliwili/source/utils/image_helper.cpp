@@ -6,6 +6,8 @@
 #include "borealis/core/singleton.hpp"
 #include "borealis/core/cache_helper.hpp"
 #include "utils/thread_helper.hpp"
+#include "utils/frame_scheduler.hpp"
+#include "utils/trace_helper.hpp"
 #include "borealis/core/thread.hpp"
 #include "stb_image.h"
 
@@ -102,12 +104,17 @@ void ImageHelper::requestImage() {
                           this->isCancel);
 
     // 请求图片
-    cpr::Response r = cpr::Get(
+    cpr::Response r;
+    {
+        TRACE_SCOPE("image", "ImageHelper::download");
+        r = cpr::Get(
 #ifndef VERIFY_SSL
-        cpr::VerifySsl{false},
+            cpr::VerifySsl{false},
 #endif
-        cpr::Url{this->imageUrl},
-        cpr::ProgressCallback([this](...) -> bool { return !this->isCancel; }));
+            cpr::Url{this->imageUrl},
+            cpr::ProgressCallback(
+                [this](...) -> bool { return !this->isCancel; }));
+    }
 
     // 图片请求失败或取消请求
     if (r.status_code != 200 || r.downloaded_bytes == 0 || this->isCancel) {
@@ -127,21 +134,10 @@ void ImageHelper::requestImage() {
     bool isWebp = false;
 
 #ifdef USE_WEBP
-    if (imageUrl.size() > 5 &&
-        imageUrl.substr(imageUrl.size() - 5, 5) == ".webp") {
-        imageData =
-            WebPDecodeRGBA((const uint8_t*)r.text.c_str(),
-                           (size_t)r.downloaded_bytes, &imageW, &imageH);
-        isWebp = true;
-    } else {
-#endif
-        int n;
-        imageData = stbi_load_from_memory((unsigned char*)r.text.c_str(),
-                                          (int)r.downloaded_bytes, &imageW,
-                                          &imageH, &n, 4);
-#ifdef USE_WEBP
-    }
+    isWebp = imageUrl.size() > 5 &&
+             imageUrl.substr(imageUrl.size() - 5, 5) == ".webp";
 #endif
+    imageData = decodeImage(r.text, isWebp, &imageW, &imageH);
 
     brls::sync([this, r, imageData, imageW, imageH, isWebp]() {
         // 再检查一遍缓存
@@ -152,6 +148,7 @@ void ImageHelper::requestImage() {
         } else {
             NVGcontext* vg = brls::Application::getNVGContext();
             if (imageData) {
+                TRACE_SCOPE("image", "ImageHelper::upload");
                 tex = nvgCreateImageRGBA(vg, imageW, imageH, 0, imageData);
             } else {
                 brls::Logger::error("Failed to load image: {}", this->imageUrl);
@@ -165,16 +162,33 @@ void ImageHelper::requestImage() {
                 }
             }
         }
-        if (imageData) {
-#ifdef USE_WEBP
-            if (isWebp)
-                WebPFree(imageData);
-            else
-#endif
-                stbi_image_free(imageData);
-        }
+        if (imageData) freeImage(imageData, isWebp);
         this->clean();
     });
+    FrameScheduler::instance().wakeUp();
+}
+
+uint8_t* ImageHelper::decodeImage(const std::string& data, bool isWebp,
+                                  int* width, int* height) {
+    TRACE_SCOPE("image", "ImageHelper::decode");
+#ifdef USE_WEBP
+    if (isWebp)
+        return WebPDecodeRGBA((const uint8_t*)data.c_str(), data.size(), width,
+                              height);
+#endif
+    int n;
+    return stbi_load_from_memory((unsigned char*)data.c_str(), (int)data.size(),
+                                 width, height, &n, 4);
+}
+
+void ImageHelper::freeImage(uint8_t* data, bool isWebp) {
+#ifdef USE_WEBP
+    if (isWebp) {
+        WebPFree(data);
+        return;
+    }
+#endif
+    stbi_image_free(data);
 }
 
 void ImageHelper::clean() {
@@ -0,0 +1,926 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <fstream>
+#include <algorithm>
+#include <mongoose.h>
+#include <cpr/cpr.h>
+#include <pystring.h>
+#include <borealis/core/logger.hpp>
+#include <borealis/core/application.hpp>
+
+#include "utils/media_proxy.hpp"
+#include "utils/config_helper.hpp"
+#include "bilibili/util/md5.hpp"
+
+/// 代理端口，从 PROXY_PORT 开始尝试 (DLNA 使用 9958)
+#define PROXY_PORT 9960
+#define PROXY_PORT_RETRY 10
+/// 单个请求在内存中等待发送的最大数据量
+#define SESSION_BUFFER_SIZE (4 * 1024 * 1024)
+/// 连接发送缓冲区的上限，超过后暂停向 mongoose 写入数据
+#define SEND_BUFFER_SIZE (1024 * 1024)
+/// 回源时超过该时长未收到数据视为连接中断，尝试下一个镜像
+#define FETCH_STALL_TIMEOUT 15
+/// 并行下载时每个连接单次请求的数据量，为数据块大小的整数倍
+#define CHUNK_SIZE (MediaCache::BLOCK_SIZE * 2)
+
+class MediaThreadPool : public cpr::ThreadPool,
+                        public brls::Singleton<MediaThreadPool> {
+public:
+    MediaThreadPool() : cpr::ThreadPool(1, 8, std::chrono::milliseconds(5000)) {
+        this->Start();
+    }
+
+    ~MediaThreadPool() override { this->Stop(); }
+};
+
+/// 并行回源时下载分片的线程池，限制全部请求的下载线程总数
+/// 与 MediaThreadPool 分开，等待分片的请求不会占满下载分片需要的线程
+class MediaRangeThreadPool : public cpr::ThreadPool,
+                             public brls::Singleton<MediaRangeThreadPool> {
+public:
+    MediaRangeThreadPool()
+        : cpr::ThreadPool(1, 8, std::chrono::milliseconds(5000)) {
+        this->Start();
+    }
+
+    ~MediaRangeThreadPool() override { this->Stop(); }
+};
+
+/// 回源请求的公共设置，to 为 0 时表示请求到文件末尾
+static void initSession(cpr::Session& s, const std::string& url, size_t from,
+                        size_t to) {
+    std::string range = "bytes=" + std::to_string(from) + "-";
+    if (to > 0) range += std::to_string(to);
+
+    s.SetUrl(cpr::Url{url});
+    s.SetHeader(cpr::Header{
+        {"User-Agent", bilibili::HTTP::HEADERS["User-Agent"]},
+        {"Referer", "https://www.bilibili.com"},
+        {"Range", range},
+    });
+    s.SetProxies(bilibili::HTTP::PROXIES);
+#ifndef VERIFY_SSL
+    s.SetVerifySsl(cpr::VerifySsl{false});
+#endif
+    s.SetConnectTimeout(cpr::ConnectTimeout{5000});
+}
+
+/// MediaCache
+
+MediaCache::~MediaCache() {
+    if (scanThread.joinable()) scanThread.join();
+}
+
+void MediaCache::init(const std::string& path, size_t size) {
+    if (scanThread.joinable()) scanThread.join();
+    size_t gen;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->dir      = path;
+        this->capacity = size;
+        this->usage    = 0;
+        this->lru.clear();
+        this->blocks.clear();
+        this->totalSize.clear();
+        gen = ++generation;
+    }
+    // 缓存目录中可能有上千个文件，不在调用者 (主线程) 中扫描
+    scanThread = std::thread([this, path, gen]() { this->scan(path, gen); });
+}
+
+void MediaCache::scan(const std::string& path, size_t gen) {
+    using Time = decltype(fs::last_write_time(fs::path(path)));
+    std::vector<std::pair<Time, Block>> found;
+    try {
+        if (!fs::exists(path)) return;
+        for (const auto& keyDir : fs::directory_iterator(path)) {
+            if (!fs::is_directory(keyDir.path())) continue;
+            std::string key = keyDir.path().filename().string();
+            for (const auto& file : fs::directory_iterator(keyDir.path())) {
+                if (file.path().extension().string() != ".blk") continue;
+                std::string name = file.path().stem().string();
+                size_t index     = std::strtoull(name.c_str(), nullptr, 10);
+                found.emplace_back(
+                    fs::last_write_time(file.path()),
+                    Block{key, index, (size_t)fs::file_size(file.path())});
+            }
+        }
+    } catch (const std::exception& e) {
+        brls::Logger::error("MediaCache: failed to scan {}: {}", path,
+                            e.what());
+        return;
+    }
+    // 按修改时间恢复上次运行时的访问顺序
+    std::sort(found.begin(), found.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<std::string> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (gen != generation) return;
+        // 扫描期间写入的数据块更新，排在扫描结果之后
+        auto pos = lru.begin();
+        for (auto& i : found) {
+            std::string id = getBlockId(i.second.key, i.second.index);
+            if (blocks.count(id) || writing.count(id)) continue;
+            usage += i.second.size;
+            blocks[id] = lru.insert(pos, i.second);
+        }
+        brls::Logger::info("MediaCache: load {} blocks, {}MB", lru.size(),
+                           usage / 1024 / 1024);
+        removed = this->trim();
+    }
+    removeFiles(removed);
+}
+
+void MediaCache::setCapacity(size_t size) {
+    std::vector<std::string> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->capacity = size;
+        removed        = this->trim();
+    }
+    removeFiles(removed);
+}
+
+bool MediaCache::hasBlock(const std::string& key, size_t index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return blocks.count(getBlockId(key, index)) > 0;
+}
+
+bool MediaCache::readBlock(const std::string& key, size_t index,
+                           std::string& data) {
+    std::string id = getBlockId(key, index);
+    std::string path;
+    size_t size;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = blocks.find(id);
+        if (it == blocks.end()) return false;
+        path = getBlockPath(key, index);
+        size = it->second->size;
+        lru.splice(lru.end(), lru, it->second);
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (file) {
+        data.resize(size);
+        file.read(data.data(), (std::streamsize)data.size());
+        if (file.gcount() == (std::streamsize)data.size()) return true;
+    }
+
+    // 数据块损坏、被外部删除或在读取期间被淘汰
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = blocks.find(id);
+    if (it != blocks.end()) {
+        usage -= it->second->size;
+        lru.erase(it->second);
+        blocks.erase(it);
+    }
+    return false;
+}
+
+void MediaCache::writeBlock(const std::string& key, size_t index,
+                            const std::string& data) {
+    std::string id = getBlockId(key, index);
+    std::string path, keyDir;
+    size_t gen;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (capacity == 0 || data.empty()) return;
+        if (blocks.count(id) || !writing.insert(id).second) return;
+        path   = getBlockPath(key, index);
+        keyDir = dir + "/" + key;
+        gen    = generation;
+    }
+
+    bool success = false;
+    try {
+        fs::create_directories(keyDir);
+        std::ofstream file(path + ".tmp", std::ios::binary);
+        file.write(data.data(), (std::streamsize)data.size());
+        file.close();
+        if (file) {
+            fs::rename(path + ".tmp", path);
+            success = true;
+        }
+    } catch (const std::exception& e) {
+        brls::Logger::error("MediaCache: failed to write {}: {}", path,
+                            e.what());
+    }
+
+    std::vector<std::string> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        writing.erase(id);
+        if (!success) return;
+        if (gen != generation) {
+            // 写入期间缓存被清空
+            removed.emplace_back(path);
+        } else {
+            lru.emplace_back(Block{key, index, data.size()});
+            blocks[id] = --lru.end();
+            usage += data.size();
+            removed = this->trim();
+        }
+    }
+    removeFiles(removed);
+}
+
+size_t MediaCache::getTotalSize(const std::string& key) {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = totalSize.find(key);
+        if (it != totalSize.end()) return it->second;
+        path = dir + "/" + key + "/size";
+    }
+
+    size_t size = 0;
+    std::ifstream file(path);
+    if (file) file >> size;
+    if (size == 0) return 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    totalSize[key] = size;
+    return size;
+}
+
+void MediaCache::setTotalSize(const std::string& key, size_t size) {
+    std::string keyDir;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (capacity == 0 || totalSize[key] == size) return;
+        totalSize[key] = size;
+        keyDir         = dir + "/" + key;
+    }
+    try {
+        fs::create_directories(keyDir);
+        std::ofstream file(keyDir + "/size");
+        file << size;
+    } catch (const std::exception& e) {
+        brls::Logger::error("MediaCache: failed to write size: {}", e.what());
+    }
+}
+
+void MediaCache::clear() {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        lru.clear();
+        blocks.clear();
+        totalSize.clear();
+        usage = 0;
+        generation++;
+        path = dir;
+    }
+    try {
+        if (fs::exists(path)) fs::remove_all(path);
+    } catch (const std::exception& e) {
+        brls::Logger::error("MediaCache: failed to clear {}: {}", path,
+                            e.what());
+    }
+}
+
+std::string MediaCache::getBlockPath(const std::string& key, size_t index) {
+    return dir + "/" + key + "/" + std::to_string(index) + ".blk";
+}
+
+std::string MediaCache::getBlockId(const std::string& key, size_t index) {
+    return key + ":" + std::to_string(index);
+}
+
+std::vector<std::string> MediaCache::trim() {
+    std::vector<std::string> removed;
+    while (usage > capacity && !lru.empty()) {
+        auto& block = lru.front();
+        removed.emplace_back(getBlockPath(block.key, block.index));
+        usage -= block.size;
+        blocks.erase(getBlockId(block.key, block.index));
+        lru.pop_front();
+    }
+    return removed;
+}
+
+void MediaCache::removeFiles(const std::vector<std::string>& files) {
+    for (auto& i : files) {
+        try {
+            fs::remove(i);
+        } catch (const std::exception& e) {
+            brls::Logger::warning("MediaCache: failed to remove block: {}",
+                                  e.what());
+        }
+    }
+}
+
+/// MediaProxySession
+
+bool MediaProxySession::push(const char* data, size_t size) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock,
+            [this]() { return cancel || buffer.size() < SESSION_BUFFER_SIZE; });
+    if (cancel) return false;
+    buffer.append(data, size);
+    return true;
+}
+
+std::string MediaProxySession::pop(size_t size) {
+    std::string data;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (buffer.empty()) return data;
+        if (buffer.size() <= size) {
+            data.swap(buffer);
+        } else {
+            data = buffer.substr(0, size);
+            buffer.erase(0, size);
+        }
+    }
+    cv.notify_all();
+    return data;
+}
+
+/// MediaProxy
+
+MediaProxy::MediaProxy()
+    : MediaProxy(ProgramConfig::instance().getConfigDir() + "/media_cache") {
+    brls::Application::getExitDoneEvent()->subscribe([this]() { this->stop(); });
+}
+
+MediaProxy::MediaProxy(const std::string& cacheDir) {
+    cache.init(cacheDir, (size_t)CACHE_SIZE * 1024 * 1024);
+}
+
+MediaProxy::~MediaProxy() { this->stop(); }
+
+bool MediaProxy::start() {
+    if (running) return true;
+
+    mgr = new mg_mgr();
+    mg_mgr_init(mgr);
+    for (int i = 0; i < PROXY_PORT_RETRY; i++) {
+        std::string listen = "http://127.0.0.1:" + std::to_string(PROXY_PORT + i);
+        if (mg_http_listen(mgr, listen.c_str(), eventHandler, this)) {
+            port = PROXY_PORT + i;
+            break;
+        }
+    }
+    if (port == 0) {
+        brls::Logger::error("MediaProxy: failed to listen on local port");
+        mg_mgr_free(mgr);
+        delete mgr;
+        mgr = nullptr;
+        return false;
+    }
+
+    brls::Logger::info("MediaProxy: listen on 127.0.0.1:{}", port);
+    quit    = false;
+    running = true;
+    thread  = std::thread([this]() {
+        while (!quit) {
+            // 有请求在传输时提高轮询频率
+            mg_mgr_poll(mgr, sessions.empty() ? 500 : 5);
+        }
+        for (auto& i : sessions) {
+            i.second->cancel = true;
+            i.second->cv.notify_all();
+        }
+        sessions.clear();
+        mg_mgr_free(mgr);
+    });
+    return true;
+}
+
+void MediaProxy::stop() {
+    if (!running) return;
+    quit = true;
+    if (thread.joinable()) thread.join();
+    delete mgr;
+    mgr     = nullptr;
+    port    = 0;
+    running = false;
+}
+
+bool MediaProxy::isRunning() const { return running; }
+
+void MediaProxy::clearCache() { cache.clear(); }
+
+void MediaProxy::setCapacity(int mb) {
+    CACHE_SIZE = mb;
+    cache.setCapacity((size_t)mb * 1024 * 1024);
+}
+
+std::string MediaProxy::getProxyUrl(const std::string& url, bool primary) {
+    if (CACHE_SIZE <= 0) return url;
+    if (!pystring::startswith(url, "http")) return url;
+    if (!running && !start()) return url;
+
+    std::string key = getKey(url);
+    {
+        std::lock_guard<std::mutex> lock(urlMutex);
+        auto& list = mirrors[key];
+        if (primary) {
+            list = {url};
+        } else if (std::find(list.begin(), list.end(), url) == list.end()) {
+            list.emplace_back(url);
+        }
+    }
+    return "http://127.0.0.1:" + std::to_string(port) + "/media/" + key;
+}
+
+std::vector<std::string> MediaProxy::getMirrors(const std::string& key) {
+    std::lock_guard<std::mutex> lock(urlMutex);
+    auto it = mirrors.find(key);
+    if (it == mirrors.end()) return {};
+    return it->second;
+}
+
+std::string MediaProxy::getKey(const std::string& url) {
+    // 去掉域名与参数，同一文件的不同镜像与不同签名共享缓存
+    std::string path = url;
+    auto pos         = path.find("://");
+    if (pos != std::string::npos) {
+        pos  = path.find('/', pos + 3);
+        path = pos == std::string::npos ? "/" : path.substr(pos);
+    }
+    pos = path.find('?');
+    if (pos != std::string::npos) path = path.substr(0, pos);
+    return websocketpp::md5::md5_hash_hex(path);
+}
+
+void MediaProxy::eventHandler(mg_connection* c, int ev, void* ev_data,
+                              void* fn_data) {
+    auto* self = (MediaProxy*)fn_data;
+    if (ev == MG_EV_HTTP_MSG) {
+        self->onRequest(c, ev_data);
+    } else if (ev == MG_EV_POLL) {
+        self->onPoll(c);
+    } else if (ev == MG_EV_CLOSE) {
+        self->onClose(c);
+    }
+}
+
+void MediaProxy::onRequest(mg_connection* c, void* data) {
+    auto* hm = (mg_http_message*)data;
+    std::string uri(hm->uri.ptr, hm->uri.len);
+    if (mg_vcasecmp(&hm->method, "GET") != 0 ||
+        !pystring::startswith(uri, "/media/")) {
+        mg_http_reply(c, 404, "", "Not Found");
+        return;
+    }
+
+    auto session = std::make_shared<MediaProxySession>();
+    session->key = uri.substr(7);
+    if (getMirrors(session->key).empty()) {
+        mg_http_reply(c, 404, "", "Not Found");
+        return;
+    }
+
+    // Range: bytes=start-[end]
+    struct mg_str* range = mg_http_get_header(hm, "Range");
+    if (range) {
+        std::string value(range->ptr, range->len);
+        auto pos = value.find('=');
+        if (pos != std::string::npos) {
+            std::string start, end;
+            auto dash = value.find('-', pos);
+            start     = value.substr(pos + 1, dash - pos - 1);
+            if (dash != std::string::npos) end = value.substr(dash + 1);
+            session->hasRange = true;
+            session->start    = std::strtoull(start.c_str(), nullptr, 10);
+            if (!end.empty()) {
+                session->end     = std::strtoull(end.c_str(), nullptr, 10);
+                session->openEnd = false;
+            }
+        }
+    }
+
+    brls::Logger::debug("MediaProxy: request {} range: {}-{}", session->key,
+                        session->start,
+                        session->openEnd ? "" : std::to_string(session->end));
+    sessions[c->id] = session;
+    MediaThreadPool::instance().Submit(
+        [this, session]() { this->produce(session); });
+}
+
+void MediaProxy::onPoll(mg_connection* c) {
+    auto it = sessions.find(c->id);
+    if (it == sessions.end()) return;
+    // 持有一份引用，从 sessions 中移除时 session 仍然有效
+    auto session = it->second;
+
+    if (!session->headerSent) {
+        size_t total = session->total;
+        if (total == 0) {
+            if (session->failed) {
+                mg_http_reply(c, 502, "", "Bad Gateway");
+                sessions.erase(it);
+            }
+            return;
+        }
+        if (session->start >= total) {
+            std::string header =
+                "Content-Range: bytes */" + std::to_string(total) + "\r\n";
+            mg_http_reply(c, 416, header.c_str(), "");
+            session->cancel = true;
+            session->cv.notify_all();
+            sessions.erase(it);
+            return;
+        }
+        size_t end = session->openEnd ? total - 1
+                                      : std::min(session->end, total - 1);
+        if (session->hasRange) {
+            mg_printf(c,
+                      "HTTP/1.1 206 Partial Content\r\n"
+                      "Content-Type: application/octet-stream\r\n"
+                      "Accept-Ranges: bytes\r\n"
+                      "Content-Range: bytes %llu-%llu/%llu\r\n"
+                      "Content-Length: %llu\r\n"
+                      "Connection: close\r\n\r\n",
+                      (unsigned long long)session->start,
+                      (unsigned long long)end, (unsigned long long)total,
+                      (unsigned long long)(end - session->start + 1));
+        } else {
+            mg_printf(c,
+                      "HTTP/1.1 200 OK\r\n"
+                      "Content-Type: application/octet-stream\r\n"
+                      "Accept-Ranges: bytes\r\n"
+                      "Content-Length: %llu\r\n"
+                      "Connection: close\r\n\r\n",
+                      (unsigned long long)total);
+        }
+        session->headerSent = true;
+    }
+
+    while (c->send.len < SEND_BUFFER_SIZE) {
+        std::string data = session->pop(SEND_BUFFER_SIZE - c->send.len);
+        if (data.empty()) break;
+        mg_send(c, data.data(), data.size());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        if (!session->buffer.empty()) return;
+        if (session->finished) {
+            // 发送完毕后关闭连接
+            c->is_draining = 1;
+        } else if (session->failed) {
+            c->is_closing = 1;
+        } else {
+            return;
+        }
+    }
+    sessions.erase(it);
+}
+
+void MediaProxy::onClose(mg_connection* c) {
+    auto it = sessions.find(c->id);
+    if (it == sessions.end()) return;
+    it->second->cancel = true;
+    it->second->cv.notify_all();
+    sessions.erase(it);
+}
+
+void MediaProxy::produce(const std::shared_ptr<MediaProxySession>& session) {
+    const size_t blockSize = MediaCache::BLOCK_SIZE;
+    auto urls              = getMirrors(session->key);
+    session->total         = cache.getTotalSize(session->key);
+    size_t pos             = session->start;
+
+    while (!session->cancel) {
+        size_t total = session->total;
+        if (total > 0) {
+            size_t end = session->openEnd ? total - 1
+                                          : std::min(session->end, total - 1);
+            if (pos > end) break;
+
+            // 优先读取磁盘缓存
+            size_t block = pos / blockSize;
+            std::string data;
+            if (cache.readBlock(session->key, block, data)) {
+                size_t offset = pos - block * blockSize;
+                if (offset >= data.size()) {
+                    session->failed = true;
+                    break;
+                }
+                size_t len = std::min(data.size() - offset, end - pos + 1);
+                if (!session->push(data.data() + offset, len)) return;
+                pos += len;
+                continue;
+            }
+
+            // 回源获取从当前块开始到下一个已缓存块之前的数据
+            size_t next = block + 1;
+            size_t last = end / blockSize;
+            while (next <= last && !cache.hasBlock(session->key, next)) next++;
+            size_t to = std::min(next * blockSize, total) - 1;
+
+            // 缺失的数据较多时使用多个连接并行下载
+            if (CONNECTIONS > 1 && to + 1 - block * blockSize > CHUNK_SIZE) {
+                if (fetchParallel(session, urls, block * blockSize, to, pos))
+                    continue;
+                if (session->cancel) return;
+                brls::Logger::warning(
+                    "MediaProxy: parallel fetch failed, fallback to single "
+                    "connection");
+            }
+
+            bool success = false;
+            for (auto& url : urls) {
+                if (fetch(session, url, block * blockSize, to, pos)) {
+                    success = true;
+                    break;
+                }
+                if (session->cancel) return;
+            }
+            if (!success) {
+                session->failed = true;
+                break;
+            }
+        } else {
+            // 文件大小未知，从当前块开始请求，由响应头获取文件大小
+            size_t from = pos / blockSize * blockSize;
+            size_t to   = 0;
+            if (!session->openEnd)
+                to = (session->end / blockSize + 1) * blockSize - 1;
+            // 使用并行下载时，只请求第一个分片来获取文件大小
+            if (CONNECTIONS > 1 && (to == 0 || to + 1 - from > CHUNK_SIZE))
+                to = from + CHUNK_SIZE - 1;
+
+            bool success = false;
+            for (auto& url : urls) {
+                if (fetch(session, url, from, to, pos)) {
+                    success = true;
+                    break;
+                }
+                if (session->cancel) return;
+            }
+            if (!success || session->total == 0) {
+                session->failed = true;
+                break;
+            }
+        }
+    }
+
+    if (!session->failed) session->finished = true;
+}
+
+bool MediaProxy::fetch(const std::shared_ptr<MediaProxySession>& session,
+                       const std::string& url, size_t from, size_t to,
+                       size_t& pos) {
+    const size_t blockSize = MediaCache::BLOCK_SIZE;
+    int status             = 0;
+    size_t skip            = 0;  // 服务器不支持范围请求时需要跳过的数据
+    size_t streamPos       = from;
+    bool satisfied         = false;
+    std::string blockData;
+    auto lastData = std::chrono::steady_clock::now();
+
+    auto onData = [&](const char* data, size_t size) -> bool {
+        if (session->cancel) return false;
+        size_t total = session->total;
+        size_t end   = session->openEnd ? SIZE_MAX : session->end;
+        if (total > 0) end = std::min(end, total - 1);
+
+        // 发送给 mpv
+        if (streamPos + size > pos && pos <= end) {
+            size_t offset = pos > streamPos ? pos - streamPos : 0;
+            size_t len    = std::min(size - offset, end - pos + 1);
+            if (!session->push(data + offset, len)) return false;
+            pos += len;
+        }
+
+        // 按块写入磁盘缓存
+        while (size > 0) {
+            size_t len = std::min(size, blockSize - blockData.size());
+            blockData.append(data, len);
+            data += len;
+            size -= len;
+            streamPos += len;
+            if (blockData.size() == blockSize) {
+                cache.writeBlock(session->key, (streamPos - 1) / blockSize,
+                                 blockData);
+                blockData.clear();
+            }
+        }
+
+        lastData = std::chrono::steady_clock::now();
+        // 已满足请求的范围，在块边界结束传输
+        if (pos > end && blockData.empty()) {
+            satisfied = true;
+            return false;
+        }
+        return true;
+    };
+
+    cpr::Session s;
+    initSession(s, url, from, to);
+    s.SetHeaderCallback(cpr::HeaderCallback{[&](std::string header,
+                                                intptr_t) {
+        std::string line = pystring::lower(pystring::strip(header));
+        if (pystring::startswith(line, "http/")) {
+            auto parts = pystring::split(line, " ");
+            if (parts.size() > 1) status = std::atoi(parts[1].c_str());
+        } else if (status == 206 &&
+                   pystring::startswith(line, "content-range:")) {
+            auto pos = line.rfind('/');
+            if (pos != std::string::npos && line[pos + 1] != '*')
+                session->total =
+                    std::strtoull(line.c_str() + pos + 1, nullptr, 10);
+        } else if (status == 200 &&
+                   pystring::startswith(line, "content-length:")) {
+            session->total =
+                std::strtoull(line.c_str() + 15, nullptr, 10);
+            skip = from;
+        }
+        return true;
+    }});
+    s.SetWriteCallback(cpr::WriteCallback{[&](std::string data, intptr_t) {
+        if (status != 200 && status != 206) return false;
+        if (skip > 0) {
+            if (data.size() <= skip) {
+                skip -= data.size();
+                return true;
+            }
+            data.erase(0, skip);
+            skip = 0;
+        }
+        return onData(data.data(), data.size());
+    }});
+    s.SetProgressCallback(cpr::ProgressCallback{
+        [&](cpr::cpr_off_t, cpr::cpr_off_t, cpr::cpr_off_t, cpr::cpr_off_t,
+            intptr_t) {
+            if (session->cancel) return false;
+            return std::chrono::steady_clock::now() - lastData <
+                   std::chrono::seconds(FETCH_STALL_TIMEOUT);
+        }});
+
+    auto r = s.Get();
+    if (session->total > 0)
+        cache.setTotalSize(session->key, session->total);
+
+    // 文件末尾不足一块的数据
+    if (!blockData.empty() && streamPos == session->total) {
+        cache.writeBlock(session->key, (streamPos - 1) / blockSize, blockData);
+    }
+
+    if (satisfied || session->cancel) return true;
+    if (r.error || (status != 200 && status != 206)) {
+        brls::Logger::warning("MediaProxy: fetch {} failed: {} {}", url,
+                              status, r.error.message);
+        // 已经发送了部分数据，换一个镜像继续
+        return false;
+    }
+    return streamPos > from;
+}
+
+bool MediaProxy::fetchChunk(const std::string& url, size_t from, size_t to,
+                            std::string& data,
+                            const std::function<bool()>& isCancel) {
+    auto lastData = std::chrono::steady_clock::now();
+    size_t last   = 0;
+
+    cpr::Session s;
+    initSession(s, url, from, to);
+    s.SetProgressCallback(cpr::ProgressCallback{
+        [&](cpr::cpr_off_t, cpr::cpr_off_t downloadNow, cpr::cpr_off_t,
+            cpr::cpr_off_t, intptr_t) {
+            if (isCancel()) return false;
+            auto now = std::chrono::steady_clock::now();
+            if ((size_t)downloadNow != last) {
+                last     = downloadNow;
+                lastData = now;
+            }
+            return now - lastData < std::chrono::seconds(FETCH_STALL_TIMEOUT);
+        }});
+
+    auto r = s.Get();
+    // 不支持范围请求的服务器无法并行下载
+    if (r.error || r.status_code != 206 || r.text.size() != to - from + 1) {
+        if (!isCancel())
+            brls::Logger::warning("MediaProxy: fetch chunk {} failed: {} {}",
+                                  url, r.status_code, r.error.message);
+        return false;
+    }
+    data = std::move(r.text);
+    return true;
+}
+
+bool MediaProxy::fetchParallel(
+    const std::shared_ptr<MediaProxySession>& session,
+    const std::vector<std::string>& urls, size_t from, size_t to,
+    size_t& pos) {
+    const size_t blockSize = MediaCache::BLOCK_SIZE;
+    const size_t count     = (to - from) / CHUNK_SIZE + 1;
+    // 已下载但还未发送给 mpv 的分片数量上限
+    const size_t window    = CONNECTIONS * 2;
+    size_t total           = session->total;
+    size_t end = session->openEnd ? total - 1 : std::min(session->end, total - 1);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::unordered_map<size_t, std::string> chunks;
+    size_t next      = 0;  // 下一个等待下载的分片
+    size_t delivered = 0;  // 下一个等待发送的分片
+    std::atomic_bool error{false};
+    std::atomic_bool stop{false};
+    auto isCancel = [&]() { return session->cancel || error || stop; };
+
+    auto worker = [&](size_t id) {
+        while (true) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() {
+                    return isCancel() || next >= count ||
+                           next < delivered + window;
+                });
+                if (isCancel() || next >= count) return;
+                index = next++;
+            }
+
+            size_t a = from + index * CHUNK_SIZE;
+            size_t b = std::min(a + CHUNK_SIZE - 1, to);
+            std::string data;
+            bool success = false;
+            // 不同的连接从不同的镜像开始，失败时依次尝试其他镜像
+            for (size_t i = 0; i < urls.size() && !success && !isCancel(); i++)
+                success =
+                    fetchChunk(urls[(id + index + i) % urls.size()], a, b, data,
+                               isCancel);
+            if (!success) {
+                error = true;
+                cv.notify_all();
+                return;
+            }
+
+            for (size_t offset = 0; offset < data.size(); offset += blockSize)
+                cache.writeBlock(session->key, (a + offset) / blockSize,
+                                 data.substr(offset, blockSize));
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                chunks[index] = std::move(data);
+            }
+            cv.notify_all();
+        }
+    };
+
+    // 分片任务引用了当前函数中的变量，返回前需要等待全部任务结束
+    size_t workers = std::min((size_t)CONNECTIONS, count);
+    size_t running = workers;
+    for (size_t i = 0; i < workers; i++) {
+        MediaRangeThreadPool::instance().Submit([&, i]() {
+            worker(i);
+            std::lock_guard<std::mutex> lock(mutex);
+            running--;
+            cv.notify_all();
+        });
+    }
+
+    // 按顺序将分片发送给 mpv
+    auto startTime = std::chrono::steady_clock::now();
+    while (delivered < count && !isCancel()) {
+        std::string data;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock,
+                    [&]() { return isCancel() || chunks.count(delivered); });
+            if (isCancel()) break;
+            data = std::move(chunks[delivered]);
+            chunks.erase(delivered);
+        }
+
+        size_t a = from + delivered * CHUNK_SIZE;
+        size_t b = a + data.size() - 1;
+        if (pos <= end && b >= pos) {
+            size_t offset = pos - a;
+            size_t len    = std::min(b, end) - pos + 1;
+            if (!session->push(data.data() + offset, len)) break;
+            pos += len;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            delivered++;
+        }
+        cv.notify_all();
+        // 已满足请求的范围
+        if (pos > end) break;
+    }
+
+    stop = true;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.notify_all();
+        cv.wait(lock, [&]() { return running == 0; });
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startTime)
+                        .count();
+    brls::Logger::debug("MediaProxy: parallel fetch {} chunks x{} in {}ms",
+                        delivered, workers, duration);
+    return !error && (delivered == count || pos > end);
+}
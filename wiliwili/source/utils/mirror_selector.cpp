@@ -0,0 +1,216 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <cpr/cpr.h>
+#include <borealis/core/logger.hpp>
+#include <borealis/core/thread.hpp>
+
+#include "utils/mirror_selector.hpp"
+#include "utils/config_helper.hpp"
+#include "bilibili/util/http.hpp"
+
+/// 测速请求的数据量
+#define PROBE_SIZE (64 * 1024)
+/// 没有测速记录时使用的预估耗时 (ms)
+#define UNKNOWN_COST 2000.0
+/// 每次连续失败增加的耗时 (ms)
+#define FAILURE_COST 5000.0
+
+MirrorSelector::MirrorSelector() { this->load(); }
+
+void MirrorSelector::select(const std::vector<std::string>& videos,
+                            const std::vector<std::string>& audios,
+                            const Callback& callback) {
+    std::thread([this, videos, audios, callback]() {
+        // 视频与音频的域名通常相同，合并后一次测速
+        std::vector<std::string> all = videos;
+        all.insert(all.end(), audios.begin(), audios.end());
+        this->rank(all);
+
+        auto videoList = this->sort(videos);
+        auto audioList = this->sort(audios);
+        brls::sync([callback, videoList, audioList]() {
+            callback(videoList, audioList);
+        });
+    }).detach();
+}
+
+std::vector<std::string> MirrorSelector::rank(
+    const std::vector<std::string>& urls) {
+    if (urls.size() <= 1) return urls;
+
+    // 只测试没有测速记录或记录已过期的域名
+    std::vector<std::string> targets;
+    std::vector<std::string> hosts;
+    auto now = std::chrono::system_clock::to_time_t(
+        std::chrono::system_clock::now());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& url : urls) {
+            std::string host = getHost(url);
+            if (std::find(hosts.begin(), hosts.end(), host) != hosts.end())
+                continue;
+            hosts.emplace_back(host);
+            auto it = scores.find(host);
+            if (it == scores.end() || now - it->second.time > PROBE_INTERVAL)
+                targets.emplace_back(url);
+        }
+    }
+    if (targets.size() > 1 ||
+        (targets.size() == 1 && hosts.size() > 1)) {
+        this->probe(targets);
+        this->save();
+    }
+    return this->sort(urls);
+}
+
+std::vector<std::string> MirrorSelector::sort(
+    const std::vector<std::string>& urls) {
+    std::vector<std::pair<double, std::string>> list;
+    for (auto& url : urls) list.emplace_back(getCost(getHost(url)), url);
+    std::stable_sort(
+        list.begin(), list.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<std::string> res;
+    for (auto& i : list) res.emplace_back(i.second);
+    return res;
+}
+
+std::string MirrorSelector::getHost(const std::string& url) {
+    auto start = url.find("://");
+    start      = start == std::string::npos ? 0 : start + 3;
+    auto end   = url.find('/', start);
+    return url.substr(start, end == std::string::npos ? end : end - start);
+}
+
+void MirrorSelector::probe(const std::vector<std::string>& urls) {
+    struct ProbeResult {
+        std::chrono::steady_clock::time_point header{};
+        std::chrono::steady_clock::time_point last{};
+        size_t size = 0;
+    };
+
+    cpr::MultiPerform multiperform;
+    std::vector<std::shared_ptr<cpr::Session>> sessionList;
+    std::vector<std::shared_ptr<ProbeResult>> resultList;
+    for (auto& url : urls) {
+        auto s      = std::make_shared<cpr::Session>();
+        auto result = std::make_shared<ProbeResult>();
+        s->SetUrl(cpr::Url{url});
+        s->SetHeader(cpr::Header{
+            {"User-Agent", bilibili::HTTP::HEADERS["User-Agent"]},
+            {"Referer", "https://www.bilibili.com"},
+            {"Range", "bytes=0-" + std::to_string(PROBE_SIZE - 1)},
+        });
+        s->SetProxies(bilibili::HTTP::PROXIES);
+#ifndef VERIFY_SSL
+        s->SetVerifySsl(cpr::VerifySsl{false});
+#endif
+        s->SetTimeout(PROBE_TIMEOUT);
+        s->SetHeaderCallback(
+            cpr::HeaderCallback{[result](std::string header, intptr_t) {
+                if (result->header.time_since_epoch().count() == 0)
+                    result->header = std::chrono::steady_clock::now();
+                return true;
+            }});
+        s->SetWriteCallback(
+            cpr::WriteCallback{[result](std::string data, intptr_t) {
+                result->size += data.size();
+                result->last = std::chrono::steady_clock::now();
+                return true;
+            }});
+        sessionList.emplace_back(s);
+        resultList.emplace_back(result);
+        multiperform.AddSession(s);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<cpr::Response> responses = multiperform.Get();
+    auto now = std::chrono::system_clock::to_time_t(
+        std::chrono::system_clock::now());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < urls.size() && i < responses.size(); i++) {
+        auto& r      = responses[i];
+        auto& result = resultList[i];
+        auto& score  = scores[getHost(urls[i])];
+        score.time   = now;
+
+        if (r.error || (r.status_code != 200 && r.status_code != 206) ||
+            result->size == 0) {
+            score.failures++;
+            brls::Logger::debug("MirrorSelector: {} failed: {} {}",
+                                getHost(urls[i]), r.status_code,
+                                r.error.message);
+            continue;
+        }
+
+        double latency = std::chrono::duration<double, std::milli>(
+                             result->header - start)
+                             .count();
+        double duration = std::chrono::duration<double>(result->last -
+                                                        result->header)
+                              .count();
+        double throughput =
+            (double)result->size / std::max(duration, 0.001);
+
+        // 与历史记录加权平均，避免单次波动影响过大
+        if (score.latency == 0 && score.throughput == 0) {
+            score.latency    = latency;
+            score.throughput = throughput;
+        } else {
+            score.latency    = score.latency * 0.5 + latency * 0.5;
+            score.throughput = score.throughput * 0.5 + throughput * 0.5;
+        }
+        score.failures = 0;
+        brls::Logger::debug("MirrorSelector: {} latency: {:.0f}ms speed: {:.0f}KB/s",
+                            getHost(urls[i]), latency, throughput / 1024);
+    }
+}
+
+double MirrorSelector::getCost(const std::string& host) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = scores.find(host);
+    if (it == scores.end()) return UNKNOWN_COST;
+    auto& score = it->second;
+    double cost = score.failures * FAILURE_COST;
+    if (score.throughput <= 0) return cost + UNKNOWN_COST;
+    return cost + score.latency + 1024 * 1024 * 1000 / score.throughput;
+}
+
+void MirrorSelector::load() {
+    const std::string path =
+        ProgramConfig::instance().getConfigDir() + "/mirror_score.json";
+    std::ifstream readFile(path);
+    if (!readFile) return;
+    try {
+        nlohmann::json content;
+        readFile >> content;
+        std::lock_guard<std::mutex> lock(mutex);
+        content.get_to(scores);
+    } catch (const std::exception& e) {
+        brls::Logger::error("MirrorSelector: failed to load {}: {}", path,
+                            e.what());
+    }
+}
+
+void MirrorSelector::save() {
+    const std::string path =
+        ProgramConfig::instance().getConfigDir() + "/mirror_score.json";
+    nlohmann::json content;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        content = scores;
+    }
+    std::ofstream writeFile(path);
+    if (!writeFile) {
+        brls::Logger::error("MirrorSelector: failed to write {}", path);
+        return;
+    }
+    writeFile << content.dump();
+}
@@ -0,0 +1,66 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <borealis/core/application.hpp>
+#include <borealis/views/label.hpp>
+
+#include "utils/opencc_helper.hpp"
+
+bool OpenCCHelper::isEnabled() {
+#ifdef OPENCC
+    static bool ZH_T = brls::Application::getLocale() == brls::LOCALE_ZH_HANT ||
+                       brls::Application::getLocale() == brls::LOCALE_ZH_TW;
+    return ZH_T && brls::Label::OPENCC_ON;
+#else
+    return false;
+#endif
+}
+
+std::string OpenCCHelper::convert(const std::string& text) {
+    if (!isEnabled()) return text;
+    return this->convertCached(text);
+}
+
+std::string OpenCCHelper::convertCached(const std::string& text) {
+#ifdef OPENCC
+    if (text.empty()) return text;
+
+    auto& shard = shards[std::hash<std::string>{}(text) % SHARDS];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.map.find(text);
+        if (it != shard.map.end()) {
+            shard.list.splice(shard.list.begin(), shard.list, it->second);
+            return it->second->second;
+        }
+    }
+
+    // 转换时不持有缓存的锁，同一文本可能被转换多次，结果相同
+    std::string res;
+    {
+        std::lock_guard<std::mutex> lock(converterMutex);
+        res = brls::Label::STConverter(text);
+    }
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.map.find(text) != shard.map.end()) return res;
+    shard.list.emplace_front(text, res);
+    shard.map[text] = shard.list.begin();
+    while (shard.list.size() > CACHE_SIZE / SHARDS + 1) {
+        shard.map.erase(shard.list.back().first);
+        shard.list.pop_back();
+    }
+    return res;
+#else
+    return text;
+#endif
+}
+
+void OpenCCHelper::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.map.clear();
+        shard.list.clear();
+    }
+}
@@ -0,0 +1,223 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <fstream>
+#include <mongoose.h>
+#include <fmt/format.h>
+#include <borealis/core/logger.hpp>
+
+#include "utils/qoe_helper.hpp"
+#include "utils/config_helper.hpp"
+
+/// QoeMonitor
+
+void QoeMonitor::onLoad(const std::string& content) {
+    if (active && !content.empty() && session.content == content) {
+        // 同一内容重新加载，视为切换清晰度
+        session.qualitySwitches++;
+        decoderDropsBase += decoderDropsCurrent;
+        outputDropsBase += outputDropsCurrent;
+        decoderDropsCurrent = outputDropsCurrent = 0;
+        this->onPausedForCache(false);
+        return;
+    }
+
+    this->finish();
+    active              = true;
+    firstFrame          = false;
+    stalling            = false;
+    session             = QoeSession();
+    session.content     = content;
+    session.startTime   = std::chrono::system_clock::to_time_t(
+        std::chrono::system_clock::now());
+    loadTime            = Clock::now();
+    decoderDropsBase    = decoderDropsCurrent = 0;
+    outputDropsBase     = outputDropsCurrent = 0;
+    videoBitrateSum     = audioBitrateSum = 0;
+    videoBitrateCount   = audioBitrateCount = 0;
+}
+
+void QoeMonitor::onFirstFrame() {
+    if (!active || firstFrame) return;
+    firstFrame             = true;
+    session.startupLatency = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 Clock::now() - loadTime)
+                                 .count();
+    brls::Logger::debug("QoE: startup latency {}ms", session.startupLatency);
+}
+
+void QoeMonitor::onPausedForCache(bool paused) {
+    // 首帧前的缓冲计入启动耗时
+    if (!active || !firstFrame) return;
+    if (paused && !stalling) {
+        stalling  = true;
+        stallTime = Clock::now();
+        session.stallCount++;
+    } else if (!paused && stalling) {
+        stalling = false;
+        session.stallDuration +=
+            std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                                  stallTime)
+                .count();
+    }
+}
+
+void QoeMonitor::onDecoderDrops(int64_t count) {
+    decoderDropsCurrent  = count;
+    session.decoderDrops = decoderDropsBase + decoderDropsCurrent;
+}
+
+void QoeMonitor::onOutputDrops(int64_t count) {
+    outputDropsCurrent  = count;
+    session.outputDrops = outputDropsBase + outputDropsCurrent;
+}
+
+void QoeMonitor::onVideoBitrate(double value) {
+    if (!active || value <= 0) return;
+    videoBitrateSum += value;
+    session.videoBitrate = videoBitrateSum / ++videoBitrateCount;
+}
+
+void QoeMonitor::onAudioBitrate(double value) {
+    if (!active || value <= 0) return;
+    audioBitrateSum += value;
+    session.audioBitrate = audioBitrateSum / ++audioBitrateCount;
+}
+
+void QoeMonitor::finish() {
+    if (!active) return;
+    this->onPausedForCache(false);
+    active = false;
+    QoeRecorder::instance().push(session);
+}
+
+QoeSession QoeMonitor::getSession() const { return session; }
+
+bool QoeMonitor::isActive() const { return active; }
+
+/// QoeRecorder
+
+QoeRecorder::QoeRecorder() { sessions.reserve(CAPACITY); }
+
+QoeRecorder::~QoeRecorder() { this->stopServer(); }
+
+void QoeRecorder::push(const QoeSession& session) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sessions.size() < CAPACITY) {
+        sessions.emplace_back(session);
+    } else {
+        sessions[head] = session;
+    }
+    head = (head + 1) % CAPACITY;
+}
+
+std::vector<QoeSession> QoeRecorder::getSessions() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sessions.size() < CAPACITY) return sessions;
+    std::vector<QoeSession> res(sessions.begin() + head, sessions.end());
+    res.insert(res.end(), sessions.begin(), sessions.begin() + head);
+    return res;
+}
+
+std::string QoeRecorder::toJson() {
+    nlohmann::json content = getSessions();
+    return content.dump(2);
+}
+
+std::string QoeRecorder::toPrometheus() {
+    auto list = getSessions();
+    int played = 0, stalls = 0;
+    int64_t startup = 0, stallDuration = 0, decoderDrops = 0, outputDrops = 0;
+    int64_t switches = 0;
+    double videoBitrate = 0;
+    for (auto& i : list) {
+        if (i.startupLatency >= 0) {
+            played++;
+            startup += i.startupLatency;
+        }
+        stalls += i.stallCount;
+        stallDuration += i.stallDuration;
+        decoderDrops += i.decoderDrops;
+        outputDrops += i.outputDrops;
+        switches += i.qualitySwitches;
+        videoBitrate += i.videoBitrate;
+    }
+
+    std::string res;
+    res += "# TYPE wiliwili_qoe_sessions gauge\n";
+    res += fmt::format("wiliwili_qoe_sessions {}\n", list.size());
+    res += "# TYPE wiliwili_qoe_sessions_failed gauge\n";
+    res += fmt::format("wiliwili_qoe_sessions_failed {}\n",
+                       list.size() - played);
+    res += "# TYPE wiliwili_qoe_startup_seconds_avg gauge\n";
+    res += fmt::format("wiliwili_qoe_startup_seconds_avg {:.3f}\n",
+                       played ? startup / 1000.0 / played : 0);
+    res += "# TYPE wiliwili_qoe_stalls gauge\n";
+    res += fmt::format("wiliwili_qoe_stalls {}\n", stalls);
+    res += "# TYPE wiliwili_qoe_stall_seconds gauge\n";
+    res += fmt::format("wiliwili_qoe_stall_seconds {:.3f}\n",
+                       stallDuration / 1000.0);
+    res += "# TYPE wiliwili_qoe_dropped_frames gauge\n";
+    res += fmt::format("wiliwili_qoe_dropped_frames{{stage=\"decoder\"}} {}\n",
+                       decoderDrops);
+    res += fmt::format("wiliwili_qoe_dropped_frames{{stage=\"output\"}} {}\n",
+                       outputDrops);
+    res += "# TYPE wiliwili_qoe_quality_switches gauge\n";
+    res += fmt::format("wiliwili_qoe_quality_switches {}\n", switches);
+    res += "# TYPE wiliwili_qoe_video_bitrate_avg gauge\n";
+    res += fmt::format("wiliwili_qoe_video_bitrate_avg {:.0f}\n",
+                       list.empty() ? 0 : videoBitrate / list.size());
+    return res;
+}
+
+bool QoeRecorder::exportJson() {
+    const std::string path =
+        ProgramConfig::instance().getConfigDir() + "/qoe.json";
+    std::ofstream writeFile(path);
+    if (!writeFile) {
+        brls::Logger::error("QoE: failed to write {}", path);
+        return false;
+    }
+    writeFile << toJson();
+    return true;
+}
+
+static void qoeEventHandler(struct mg_connection* c, int ev, void* ev_data,
+                            void* fn_data) {
+    if (ev != MG_EV_HTTP_MSG) return;
+    auto* hm       = (struct mg_http_message*)ev_data;
+    auto* recorder = (QoeRecorder*)fn_data;
+    if (mg_http_match_uri(hm, "/metrics")) {
+        mg_http_reply(c, 200, "Content-Type: text/plain; version=0.0.4\r\n",
+                      "%s", recorder->toPrometheus().c_str());
+    } else if (mg_http_match_uri(hm, "/qoe.json")) {
+        mg_http_reply(c, 200, "Content-Type: application/json\r\n", "%s",
+                      recorder->toJson().c_str());
+    } else {
+        mg_http_reply(c, 404, "", "Not Found");
+    }
+}
+
+void QoeRecorder::startServer(int port) {
+    if (serverRunning || port <= 0) return;
+    serverRunning = true;
+    serverThread  = std::thread([this, port]() {
+        struct mg_mgr mgr {};
+        mg_mgr_init(&mgr);
+        std::string url = "http://127.0.0.1:" + std::to_string(port);
+        if (!mg_http_listen(&mgr, url.c_str(), qoeEventHandler, this)) {
+            brls::Logger::error("QoE: failed to listen on {}", url);
+            serverRunning = false;
+        } else {
+            brls::Logger::info("QoE: metrics on {}/metrics", url);
+        }
+        while (serverRunning) mg_mgr_poll(&mgr, 500);
+        mg_mgr_free(&mgr);
+    });
+}
+
+void QoeRecorder::stopServer() {
+    serverRunning = false;
+    if (serverThread.joinable()) serverThread.join();
+}
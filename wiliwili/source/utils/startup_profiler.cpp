@@ -0,0 +1,166 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <borealis/core/logger.hpp>
+
+#include "utils/startup_profiler.hpp"
+#include "utils/config_helper.hpp"
+
+/// StartupProfiler::Phase
+
+StartupProfiler::Phase::Phase(std::string name)
+    : name(std::move(name)), start(Clock::now()) {}
+
+StartupProfiler::Phase::~Phase() {
+    StartupProfiler::instance().record(name, start, Clock::now());
+}
+
+/// StartupProfiler
+
+StartupProfiler::StartupProfiler() : launchTime(Clock::now()) {
+    // 在 main 函数开始时创建，当前线程即为主线程
+    this->getThreadIndex();
+}
+
+size_t StartupProfiler::getThreadIndex() {
+    auto id = std::this_thread::get_id();
+    auto it = threads.find(id);
+    if (it != threads.end()) return it->second;
+    size_t index = threads.size() + 1;
+    threads[id]  = index;
+    return index;
+}
+
+void StartupProfiler::record(const std::string& name, Clock::time_point start,
+                             Clock::time_point end) {
+    StartupPhaseRecord item;
+    item.name  = name;
+    item.start = std::chrono::duration_cast<std::chrono::microseconds>(
+                     start - launchTime)
+                     .count();
+    item.duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+            .count();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // 首帧之后不再记录，避免长期运行时占用内存
+    if (firstFrame) return;
+    item.thread = this->getThreadIndex();
+    records.emplace_back(std::move(item));
+}
+
+void StartupProfiler::defer(const std::string& name,
+                            const std::function<void()>& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (PARALLEL && !firstFrame) {
+            deferredTasks.emplace_back(name, task);
+            return;
+        }
+    }
+    Phase phase(name);
+    task();
+}
+
+void StartupProfiler::onFirstFrame() {
+    std::vector<std::pair<std::string, std::function<void()>>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (firstFrame) return;
+        tasks.swap(deferredTasks);
+    }
+    auto now = Clock::now();
+    this->record("first_frame", launchTime, now);
+
+    for (auto& task : tasks) {
+        Phase phase(task.first);
+        task.second();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        firstFrame = true;
+    }
+
+    brls::Logger::info(
+        "Startup: first frame in {}ms{}",
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - launchTime)
+            .count(),
+        PARALLEL ? " (parallel)" : "");
+    if (TRACE) this->exportJson();
+}
+
+void StartupProfiler::markFirstContent(const std::string& source) {
+    if (contentSource.empty()) contentSource = source;
+}
+
+void StartupProfiler::onFrame() {
+    this->onFirstFrame();
+    if (contentPainted || contentSource.empty()) return;
+    contentPainted = true;
+
+    auto now = Clock::now();
+    StartupPhaseRecord item;
+    item.name     = "first_content_" + contentSource;
+    item.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                        now - launchTime)
+                        .count();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        item.thread = this->getThreadIndex();
+        records.emplace_back(std::move(item));
+    }
+
+    brls::Logger::info(
+        "Startup: first content from {} in {}ms", contentSource,
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - launchTime)
+            .count());
+    if (TRACE) this->exportJson();
+}
+
+std::string StartupProfiler::toJson() {
+    nlohmann::json events = nlohmann::json::array();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& i : threads) {
+        events.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", 1},
+            {"tid", i.second},
+            {"args", {{"name", i.second == 1 ? "main" : "worker"}}},
+        });
+    }
+    for (auto& i : records) {
+        events.push_back({
+            {"name", i.name},
+            {"cat", "startup"},
+            {"ph", "X"},
+            {"ts", i.start},
+            {"dur", i.duration},
+            {"pid", 1},
+            {"tid", i.thread},
+        });
+    }
+    nlohmann::json content = {
+        {"traceEvents", events},
+        {"displayTimeUnit", "ms"},
+        {"otherData", {{"parallel", PARALLEL}}},
+    };
+    return content.dump(2);
+}
+
+bool StartupProfiler::exportJson() {
+    const std::string path =
+        ProgramConfig::instance().getConfigDir() + "/startup_trace.json";
+    std::ofstream writeFile(path);
+    if (!writeFile) {
+        brls::Logger::error("Startup: failed to write {}", path);
+        return false;
+    }
+    writeFile << toJson();
+    brls::Logger::info("Startup: write trace to {}", path);
+    return true;
+}
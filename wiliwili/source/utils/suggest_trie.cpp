@@ -0,0 +1,75 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <algorithm>
+
+#include "utils/suggest_trie.hpp"
+
+static inline char foldCase(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+SuggestTrie::SuggestTrie() { this->clear(); }
+
+void SuggestTrie::insert(const std::string& word, size_t weight) {
+    if (word.empty()) return;
+    size_t current = 0;
+    for (char c : word) {
+        c       = foldCase(c);
+        auto it = nodes[current].children.find(c);
+        if (it != nodes[current].children.end()) {
+            current = it->second;
+            continue;
+        }
+        nodes.emplace_back();
+        nodes[current].children[c] = nodes.size() - 1;
+        current                    = nodes.size() - 1;
+    }
+    auto& node = nodes[current];
+    if (node.word.empty()) {
+        count++;
+    } else if (node.weight > weight) {
+        return;
+    }
+    node.word   = word;
+    node.weight = weight;
+}
+
+std::vector<std::string> SuggestTrie::match(const std::string& prefix,
+                                            size_t limit) const {
+    std::vector<std::string> res;
+    if (prefix.empty() || limit == 0) return res;
+
+    size_t current = 0;
+    for (char c : prefix) {
+        auto& children = nodes[current].children;
+        auto it        = children.find(foldCase(c));
+        if (it == children.end()) return res;
+        current = it->second;
+    }
+
+    // 收集子树中所有的词
+    std::vector<const Node*> words;
+    std::vector<size_t> stack{current};
+    while (!stack.empty()) {
+        auto& node = nodes[stack.back()];
+        stack.pop_back();
+        if (!node.word.empty()) words.emplace_back(&node);
+        for (auto& i : node.children) stack.emplace_back(i.second);
+    }
+
+    size_t size = std::min(limit, words.size());
+    std::partial_sort(words.begin(), words.begin() + size, words.end(),
+                      [](const Node* a, const Node* b) {
+                          return a->weight > b->weight;
+                      });
+    for (size_t i = 0; i < size; i++) res.emplace_back(words[i]->word);
+    return res;
+}
+
+void SuggestTrie::clear() {
+    nodes.clear();
+    nodes.emplace_back();
+    count = 0;
+}
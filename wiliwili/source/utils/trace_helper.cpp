@@ -0,0 +1,179 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <fmt/format.h>
+#include <borealis/core/logger.hpp>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <csignal>
+#endif
+
+#include "utils/trace_helper.hpp"
+#include "utils/config_helper.hpp"
+#include "utils/number_helper.hpp"
+
+namespace wiliwili {
+
+/// TraceBuffer
+
+TraceBuffer::TraceBuffer(size_t tid, size_t capacity)
+    : tid(tid), capacity(capacity), slots(new Slot[capacity]) {}
+
+void TraceBuffer::push(const char* category, const char* name, int64_t start,
+                       int64_t duration) {
+    uint64_t index = head.load(std::memory_order_relaxed);
+    Slot& slot     = slots[index % capacity];
+    slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(duration, std::memory_order_relaxed);
+    slot.sequence.store(index * 2 + 2, std::memory_order_release);
+    head.store(index + 1, std::memory_order_release);
+}
+
+void TraceBuffer::collect(std::vector<TraceRecord>& out) const {
+    uint64_t end   = head.load(std::memory_order_acquire);
+    uint64_t begin = end > capacity ? end - capacity : 0;
+    for (uint64_t index = begin; index < end; index++) {
+        const Slot& slot = slots[index % capacity];
+        uint64_t before  = slot.sequence.load(std::memory_order_acquire);
+        if (before != index * 2 + 2) continue;
+        TraceRecord record;
+        record.category = slot.category.load(std::memory_order_relaxed);
+        record.name     = slot.name.load(std::memory_order_relaxed);
+        record.start    = slot.start.load(std::memory_order_relaxed);
+        record.duration = slot.duration.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != before) continue;
+        out.emplace_back(record);
+    }
+}
+
+/// PerfTrace
+
+// 缓冲区由全局列表持有，线程退出后记录仍可导出
+static std::mutex& getBufferMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::vector<std::shared_ptr<TraceBuffer>>& getBufferList() {
+    static std::vector<std::shared_ptr<TraceBuffer>> list;
+    return list;
+}
+
+class TraceBufferHolder {
+public:
+    ~TraceBufferHolder() {
+        if (buffer) buffer->retired = true;
+    }
+
+    std::shared_ptr<TraceBuffer> buffer;
+};
+
+static std::atomic_bool exportRequested{false};
+
+int64_t PerfTrace::now() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - epoch)
+        .count();
+}
+
+TraceBuffer* PerfTrace::getBuffer() {
+    static thread_local TraceBufferHolder holder;
+    if (holder.buffer) return holder.buffer.get();
+
+    static size_t tid = 0;
+    std::lock_guard<std::mutex> lock(getBufferMutex());
+    auto& list = getBufferList();
+    if (list.size() >= MAX_BUFFERS) {
+        // 优先释放最早退出的线程的缓冲区
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            if ((*it)->retired) {
+                list.erase(it);
+                break;
+            }
+        }
+    }
+    holder.buffer = std::make_shared<TraceBuffer>(++tid, CAPACITY);
+    list.emplace_back(holder.buffer);
+    return holder.buffer.get();
+}
+
+void PerfTrace::record(const char* category, const char* name, int64_t start,
+                       int64_t duration) {
+    getBuffer()->push(category, name, start, duration);
+}
+
+void PerfTrace::setThreadName(const char* name) {
+    getBuffer()->threadName = name;
+}
+
+std::string PerfTrace::exportJson() {
+    std::vector<std::shared_ptr<TraceBuffer>> list;
+    {
+        std::lock_guard<std::mutex> lock(getBufferMutex());
+        list = getBufferList();
+    }
+
+    const std::string path =
+        fmt::format("{}/perf_trace_{}.json",
+                    ProgramConfig::instance().getConfigDir(), getUnixTime());
+    std::ofstream writeFile(path);
+    if (!writeFile) {
+        brls::Logger::error("PerfTrace: failed to write {}", path);
+        return "";
+    }
+
+    // 记录数量可能很多，直接写入文件，避免构造完整的 json 对象
+    size_t count = 0;
+    writeFile << R"({"displayTimeUnit":"ms","traceEvents":[)";
+    std::vector<TraceRecord> records;
+    for (auto& buffer : list) {
+        const char* threadName = buffer->threadName;
+        if (buffer != list.front()) writeFile << ",";
+        writeFile << "\n"
+                  << fmt::format(
+                         R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})",
+                         buffer->tid,
+                         threadName ? threadName
+                                    : fmt::format("thread {}", buffer->tid));
+
+        records.clear();
+        buffer->collect(records);
+        for (auto& i : records) {
+            writeFile << ",\n"
+                      << fmt::format(
+                             R"({{"name":"{}","cat":"{}","ph":"X","ts":{},"dur":{},"pid":1,"tid":{}}})",
+                             i.name, i.category, i.start, i.duration,
+                             buffer->tid);
+        }
+        count += records.size();
+    }
+    writeFile << "\n]}\n";
+    brls::Logger::info("PerfTrace: write {} events to {}", count, path);
+    return path;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+static void onExportSignal(int) { exportRequested = true; }
+#endif
+
+void PerfTrace::installSignal() {
+#if defined(__linux__) || defined(__APPLE__)
+    signal(SIGUSR1, onExportSignal);
+#endif
+}
+
+void PerfTrace::poll() {
+    if (exportRequested.exchange(false)) exportJson();
+}
+
+}  // namespace wiliwili
@@ -0,0 +1,136 @@
+//
+// Created by fang on 2026/10/19.
+//
+
+#include <chrono>
+#include <cstring>
+#include <tinyxml2.h>
+#include <borealis/core/view.hpp>
+#include <borealis/core/logger.hpp>
+
+#include "utils/xml_layout.hpp"
+
+#ifdef PRECOMPILED_XML_LAYOUT
+// 由 scripts/compile_xml_layout.py 生成
+extern const unsigned char XML_LAYOUT_DATA[];
+extern const size_t XML_LAYOUT_SIZE;
+#endif
+
+static size_t readVarint(const unsigned char*& p) {
+    size_t value = 0;
+    int shift    = 0;
+    while (true) {
+        unsigned char byte = *p++;
+        value |= (size_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+        shift += 7;
+    }
+}
+
+/// 跳过一个节点及其全部子节点
+static void skipNode(const unsigned char*& p) {
+    readVarint(p);
+    size_t attrs = readVarint(p);
+    for (size_t i = 0; i < attrs * 2; i++) readVarint(p);
+    readVarint(p);
+    size_t children = readVarint(p);
+    for (size_t i = 0; i < children; i++) skipNode(p);
+}
+
+static tinyxml2::XMLElement* buildNode(tinyxml2::XMLDocument* doc,
+                                       const std::vector<std::string>& strings,
+                                       const unsigned char*& p) {
+    auto* element = doc->NewElement(strings[readVarint(p)].c_str());
+    size_t attrs  = readVarint(p);
+    for (size_t i = 0; i < attrs; i++) {
+        const std::string& name  = strings[readVarint(p)];
+        const std::string& value = strings[readVarint(p)];
+        element->SetAttribute(name.c_str(), value.c_str());
+    }
+    size_t text = readVarint(p);
+    if (text > 0) element->SetText(strings[text - 1].c_str());
+    size_t children = readVarint(p);
+    for (size_t i = 0; i < children; i++)
+        element->InsertEndChild(buildNode(doc, strings, p));
+    return element;
+}
+
+XMLLayout::XMLLayout() {
+#ifdef PRECOMPILED_XML_LAYOUT
+    const unsigned char* p = XML_LAYOUT_DATA;
+    if (XML_LAYOUT_SIZE < 4 || memcmp(p, "WXL1", 4) != 0) {
+        brls::Logger::error("XMLLayout: invalid layout data");
+        return;
+    }
+    p += 4;
+
+    size_t count = readVarint(p);
+    strings.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        size_t length = readVarint(p);
+        strings.emplace_back((const char*)p, length);
+        p += length;
+    }
+
+    count = readVarint(p);
+    for (size_t i = 0; i < count; i++) {
+        const std::string& name = strings[readVarint(p)];
+        offsets[name]           = p - XML_LAYOUT_DATA;
+        skipNode(p);
+    }
+    brls::Logger::debug("XMLLayout: {} layouts", offsets.size());
+#endif
+}
+
+XMLLayout::~XMLLayout() = default;
+
+tinyxml2::XMLElement* XMLLayout::getElement(const std::string& res) {
+#ifdef PRECOMPILED_XML_LAYOUT
+    // 自定义布局可能覆盖任意文件，直接使用 XML 文件
+    if (!brls::View::CUSTOM_RESOURCES_PATH.empty()) return nullptr;
+
+    auto doc = documents.find(res);
+    if (doc != documents.end()) return doc->second->RootElement();
+
+    auto offset = offsets.find(res);
+    if (offset == offsets.end()) return nullptr;
+    const unsigned char* p = XML_LAYOUT_DATA + offset->second;
+    auto document          = std::make_unique<tinyxml2::XMLDocument>();
+    document->InsertEndChild(buildNode(document.get(), strings, p));
+    auto* root     = document->RootElement();
+    documents[res] = std::move(document);
+    return root;
+#else
+    return nullptr;
+#endif
+}
+
+void XMLLayout::inflate(brls::View* view, const std::string& res) {
+    auto start    = std::chrono::steady_clock::now();
+    auto* element = XMLLayout::instance().getElement(res);
+    if (element) {
+        view->inflateFromXMLElement(element);
+    } else {
+        view->inflateFromXMLRes(res);
+    }
+    brls::Logger::verbose(
+        "XMLLayout: inflate {} ({}): {}us", res,
+        element ? "precompiled" : "xml",
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+}
+
+brls::View* XMLLayout::create(const std::string& name) {
+    auto start    = std::chrono::steady_clock::now();
+    auto* element = XMLLayout::instance().getElement("xml/" + name);
+    brls::View* view = element ? brls::View::createFromXMLElement(element)
+                               : brls::View::createFromXMLResource(name);
+    brls::Logger::verbose(
+        "XMLLayout: create {} ({}): {}us", name,
+        element ? "precompiled" : "xml",
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+    return view;
+}
@@ -4,6 +4,7 @@
 
 #include "view/animation_image.hpp"
 #include "borealis/core/cache_helper.hpp"
+#include "utils/frame_scheduler.hpp"
 
 AnimationImage::AnimationImage() {
     brls::Logger::debug("View AnimationImage: create");
@@ -66,7 +67,6 @@ brls::View* AnimationImage::create() { return new AnimationImage(); }
 void AnimationImage::draw(NVGcontext* vg, float x, float y, float width,
                           float height, brls::Style style,
                           brls::FrameContext* ctx) {
-    brls::Application::setActiveEvent(true);
     size_t time_now = brls::getCPUTimeUsec();
     if (time_now - last_refresh_time > frame_time) {
         last_refresh_time = time_now;
@@ -74,6 +74,14 @@ void AnimationImage::draw(NVGcontext* vg, float x, float y, float width,
         current_frame++;
         current_frame %= frame;
     }
+    if (!FrameScheduler::ENABLE) {
+        // 未开启按需绘制时避免主循环进入低帧率的闲置状态
+        brls::Application::setActiveEvent(true);
+    } else if (frame > 1) {
+        // 只在切换到下一帧图片时需要重绘
+        FrameScheduler::instance().requestFrame(
+            (int64_t)(last_refresh_time + frame_time - time_now));
+    }
 
     this->paint.xform[4] = x - last_x;
     this->paint.xform[5] = y;
@@ -20,6 +20,7 @@
 #include "view/auto_tab_frame.hpp"
 #include "view/svg_image.hpp"
 #include "view/button_refresh.hpp"
+#include "utils/frame_scheduler.hpp"
 
 /**
  * auto tab frame
@@ -574,6 +575,7 @@ void AutoTabFrame::draw(NVGcontext* vg, float x, float y, float width,
         nvgFillPaint(vg, paint);
         nvgRoundedRect(vg, drawX, drawY, drawWidth, drawHeight, 6);
         nvgFill(vg);
+        FrameScheduler::instance().requestFrame();
 
         if (!this->isHorizontal) return;
 
@@ -3,9 +3,10 @@
 //
 
 #include "view/button_close.hpp"
+#include "utils/xml_layout.hpp"
 
 ButtonClose::ButtonClose() {
-    this->inflateFromXMLRes("xml/views/button_close.xml");
+    XMLLayout::inflate(this, "xml/views/button_close.xml");
     brls::Logger::debug("View ButtonClose: create");
 
     this->registerColorXMLAttribute("textColor", [this](NVGcolor value) {
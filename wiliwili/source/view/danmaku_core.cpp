@@ -3,20 +3,17 @@
 //
 
 #include <pystring.h>
+#include <tinyxml2.h>
 #include <cstdlib>
 #include <utility>
 
 #include "view/danmaku_core.hpp"
 #include "utils/config_helper.hpp"
+#include "utils/trace_helper.hpp"
 #include "borealis/core/logger.hpp"
 
 DanmakuItem::DanmakuItem(std::string content, const char *attributes)
     : msg(std::move(content)) {
-#ifdef OPENCC
-    static bool ZH_T = brls::Application::getLocale() == brls::LOCALE_ZH_HANT ||
-                       brls::Application::getLocale() == brls::LOCALE_ZH_TW;
-    if (ZH_T && brls::Label::OPENCC_ON) msg = brls::Label::STConverter(msg);
-#endif
     std::vector<std::string> attrs;
     pystring::split(attributes, attrs, ",");
     if (attrs.size() < 9) {
@@ -71,10 +68,10 @@ void DanmakuCore::reset() {
     danmakuMutex.unlock();
 }
 
-void DanmakuCore::loadDanmakuData(const std::vector<DanmakuItem> &data) {
+void DanmakuCore::loadDanmakuData(std::vector<DanmakuItem> data) {
     danmakuMutex.lock();
-    this->danmakuData = data;
-    if (!data.empty()) danmakuLoaded = true;
+    this->danmakuData = std::move(data);
+    if (!danmakuData.empty()) danmakuLoaded = true;
     std::sort(danmakuData.begin(), danmakuData.end());
     danmakuMutex.unlock();
 
@@ -82,6 +79,36 @@ void DanmakuCore::loadDanmakuData(const std::vector<DanmakuItem> &data) {
     MPVCore::instance().getCustomEvent()->fire("DANMAKU_LOADED", nullptr);
 }
 
+std::vector<DanmakuItem> DanmakuCore::decodeXML(const std::string &content) {
+    std::vector<DanmakuItem> items;
+
+    tinyxml2::XMLDocument document = tinyxml2::XMLDocument();
+    tinyxml2::XMLError error       = document.Parse(content.c_str());
+    if (error != tinyxml2::XMLError::XML_SUCCESS) {
+        brls::Logger::error("Error decode danmaku xml[1]: {}",
+                            std::to_string(error));
+        return items;
+    }
+    tinyxml2::XMLElement *element = document.RootElement();
+    if (!element) {
+        brls::Logger::error("Error decode danmaku xml[2]: no root element");
+        return items;
+    }
+
+    for (auto child = element->FirstChildElement(); child != nullptr;
+         child      = child->NextSiblingElement()) {
+        if (child->Name()[0] != 'd') continue;  // 简易判断是不是弹幕
+        const char *text = child->GetText();
+        if (!text) continue;
+        try {
+            items.emplace_back(text, child->Attribute("p"));
+        } catch (...) {
+            brls::Logger::error("DANMAKU: error decode: {}", text);
+        }
+    }
+    return items;
+}
+
 void DanmakuCore::addSingleDanmaku(const DanmakuItem &item) {
     danmakuMutex.lock();
     this->danmakuData.emplace_back(item);
@@ -188,6 +215,7 @@ NVGcolor DanmakuCore::a(NVGcolor color, float alpha) {
 
 void DanmakuCore::draw(NVGcontext *vg, float x, float y, float width,
                               float height, float alpha) {
+    TRACE_SCOPE("render", "DanmakuCore::draw");
     if (!DanmakuCore::DANMAKU_ON) return;
     if (!this->danmakuLoaded) return;
     if (danmakuData.empty()) return;
@@ -3,6 +3,7 @@
 //
 
 #include "view/grid_dropdown.hpp"
+#include "utils/xml_layout.hpp"
 
 /// EmptyDropDown
 
@@ -57,7 +58,7 @@ bool EmptyDropdown::isTranslucent() { return true; }
 
 /// GridRadioCell
 GridRadioCell::GridRadioCell() {
-    this->inflateFromXMLRes("xml/views/grid_radio_cell.xml");
+    XMLLayout::inflate(this, "xml/views/grid_radio_cell.xml");
 }
 
 void GridRadioCell::setSelected(bool selected) {
@@ -103,7 +104,7 @@ void TextDataSourceDropdown::clearData() { this->data.clear(); }
 BaseDropdown::BaseDropdown(const std::string& title,
                            ValueSelectedEvent::Callback cb, int selected)
     : cb(std::move(cb)), selected(selected) {
-    this->inflateFromXMLRes("xml/views/grid_dropdown.xml");
+    XMLLayout::inflate(this, "xml/views/grid_dropdown.xml");
     this->title->setText(title);
 
     this->cancel->registerClickAction([this](...) {
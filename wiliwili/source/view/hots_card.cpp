@@ -4,9 +4,10 @@
 
 #include "view/hots_card.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 RecyclingGridItemHotsCard::RecyclingGridItemHotsCard() {
-    this->inflateFromXMLRes("xml/views/hots_card.xml");
+    XMLLayout::inflate(this, "xml/views/hots_card.xml");
 }
 
 RecyclingGridItemHotsCard::~RecyclingGridItemHotsCard() = default;
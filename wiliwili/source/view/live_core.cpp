@@ -4,6 +4,7 @@
 
 #include "view/live_core.hpp"
 #include "view/danmaku_core.hpp"
+#include "utils/trace_helper.hpp"
 
 #include <chrono>
 #include <cstddef>
@@ -63,6 +64,7 @@ void LiveDanmakuCore::add(const std::vector<LiveDanmakuItem> &dan_l) {
 
 void LiveDanmakuCore::draw(NVGcontext *vg, float x, float y, float width,
                            float height, float alpha) {
+    TRACE_SCOPE("render", "LiveDanmakuCore::draw");
     if (!DanmakuCore::DANMAKU_ON) return;
 
     int r, g, b;
@@ -8,6 +8,8 @@
 #include <pystring.h>
 #include "utils/config_helper.hpp"
 #include "utils/number_helper.hpp"
+#include "utils/frame_scheduler.hpp"
+#include "utils/trace_helper.hpp"
 
 #if !defined(MPV_NO_FB) && !defined(MPV_SW_RENDER) && \
     !defined(BOREALIS_USE_DEKO3D)
@@ -80,10 +82,12 @@ void MPVCore::on_update(void *self) {
         }
 #endif
     });
+    FrameScheduler::instance().wakeUp();
 }
 
 void MPVCore::on_wakeup(void *self) {
     brls::sync([]() { MPVCore::instance().eventMainLoop(); });
+    FrameScheduler::instance().wakeUp();
 }
 
 MPVCore::MPVCore() {
@@ -209,6 +213,17 @@ void MPVCore::init() {
     check_error(mpv_observe_property(mpv, 14, "seeking", MPV_FORMAT_FLAG));
     check_error(
         mpv_observe_property(mpv, 15, "hwdec-current", MPV_FORMAT_STRING));
+    check_error(mpv_observe_property(mpv, 16, "decoder-frame-drop-count",
+                                     MPV_FORMAT_INT64));
+    check_error(
+        mpv_observe_property(mpv, 17, "frame-drop-count", MPV_FORMAT_INT64));
+    check_error(
+        mpv_observe_property(mpv, 18, "video-bitrate", MPV_FORMAT_DOUBLE));
+    check_error(
+        mpv_observe_property(mpv, 19, "audio-bitrate", MPV_FORMAT_DOUBLE));
+
+    // 播放体验指标服务
+    QoeRecorder::instance().startServer(QoeRecorder::METRICS_PORT);
 
     // init renderer params
 #ifdef MPV_SW_RENDER
@@ -289,6 +304,11 @@ MPVCore::~MPVCore() = default;
 void MPVCore::clean() {
     check_error(mpv_command_string(this->mpv, "quit"));
 
+    // 保存播放体验记录
+    qoe.finish();
+    QoeRecorder::instance().exportJson();
+    QoeRecorder::instance().stopServer();
+
     brls::Application::getWindowFocusChangedEvent()->unsubscribe(
         focusSubscription);
 
@@ -650,6 +670,7 @@ std::string MPVCore::getCacheSpeed() const {
 }
 
 void MPVCore::eventMainLoop() {
+    TRACE_SCOPE("mpv", "MPVCore::eventMainLoop");
     while (true) {
         auto event = mpv_wait_event(this->mpv, 0);
         switch (event->event_id) {
@@ -697,6 +718,7 @@ void MPVCore::eventMainLoop() {
                 // event 21: 开始播放文件（一般是播放或调整进度结束之后触发）
                 brls::Logger::info("========> MPV_EVENT_PLAYBACK_RESTART");
                 video_stopped = false;
+                qoe.onFirstFrame();
                 mpvCoreEvent.fire(MpvEventEnum::LOADING_END);
                 if (AUTO_PLAY) {
                     mpvCoreEvent.fire(MpvEventEnum::MPV_RESUME);
@@ -791,6 +813,7 @@ void MPVCore::eventMainLoop() {
                     case 7:
                         // 发生了缓存等待
                         if (!data) break;
+                        qoe.onPausedForCache(*(int *)data);
 
                         if (*(int *)data) {
                             brls::Logger::info(
@@ -891,6 +914,19 @@ void MPVCore::eventMainLoop() {
                             brls::Logger::info("========> HW: {}", hwCurrent);
                             GA("hwdec", {{"hwdec", hwCurrent}})
                         }
+                        break;
+                    case 16:
+                        if (data) qoe.onDecoderDrops(*(int64_t *)data);
+                        break;
+                    case 17:
+                        if (data) qoe.onOutputDrops(*(int64_t *)data);
+                        break;
+                    case 18:
+                        if (data) qoe.onVideoBitrate(*(double *)data);
+                        break;
+                    case 19:
+                        if (data) qoe.onAudioBitrate(*(double *)data);
+                        break;
                     default:
                         break;
                 }
@@ -911,6 +947,7 @@ void MPVCore::reset() {
     this->playback_time  = 0;
     this->video_progress = 0;
     this->mpv_error_code = 0;
+    this->contentId.clear();
 
     // 软硬解切换后应该手动设置一次渲染尺寸
     // 切换视频前设置渲染尺寸可以顺便将上一条视频的最后一帧画面清空
@@ -920,6 +957,7 @@ void MPVCore::reset() {
 void MPVCore::setUrl(const std::string &url, const std::string &extra,
                      const std::string &method) {
     brls::Logger::debug("{} Url: {}, extra: {}", method, url, extra);
+    if (method == "replace") qoe.onLoad(contentId);
     if (extra.empty()) {
         command_async("loadfile", url, method);
     } else {
@@ -931,6 +969,8 @@ void MPVCore::setBackupUrl(const std::string &url, const std::string &extra) {
     this->setUrl(url, extra, "append");
 }
 
+void MPVCore::setContentId(const std::string &id) { contentId = id; }
+
 void MPVCore::setVolume(int64_t value) {
     if (value < 0 || value > 100) return;
     command_async("set", "volume", value);
@@ -3,8 +3,12 @@
 //
 
 #include <utility>
+#include <algorithm>
+#include <unordered_map>
 #include "view/recycling_grid.hpp"
 #include "view/button_refresh.hpp"
+#include "utils/trace_helper.hpp"
+#include "utils/frame_scheduler.hpp"
 
 /// RecyclingGridItem
 
@@ -47,6 +51,7 @@ void SkeletonCell::draw(NVGcontext* vg, float x, float y, float width,
     nvgFillPaint(vg, paint);
     nvgRoundedRect(vg, x, y, width, height, 6);
     nvgFill(vg);
+    FrameScheduler::instance().requestFrame();
 }
 
 /// Skeleton DataSource
@@ -124,6 +129,10 @@ RecyclingGrid::RecyclingGrid() {
         this->reloadData();
     });
 
+    this->registerFloatXMLAttribute("nextPageLine", [this](float value) {
+        this->nextPageLine = value;
+    });
+
     this->registerBoolXMLAttribute("flowMode", [this](bool value) {
         this->spanCount  = 1;
         this->isFlowMode = value;
@@ -183,10 +192,10 @@ void RecyclingGrid::registerCell(
     allocationMap.insert(std::make_pair(identifier, allocation));
 }
 
-void RecyclingGrid::addCellAt(size_t index, int downSide) {
-    RecyclingGridItem* cell;
+void RecyclingGrid::addCellAt(size_t index, int downSide,
+                              RecyclingGridItem* cell) {
     //获取到一个填充好数据的cell
-    cell = dataSource->cellForRow(this, index);
+    if (!cell) cell = dataSource->cellForRow(this, index);
 
     float cellHeight = estimatedRowHeight;
     float cellWidth =
@@ -261,6 +270,7 @@ void RecyclingGrid::setDataSource(RecyclingGridDataSource* source) {
     if (this->dataSource) delete this->dataSource;
 
     this->dataSource = source;
+    requestNextPage  = false;
     if (layouted) reloadData();
 }
 
@@ -282,7 +292,11 @@ void RecyclingGrid::reloadData() {
 
     setContentOffsetY(0, false);
 
+    itemKeys.clear();
+    itemHashes.clear();
     if (dataSource) {
+        updateItemKeys(itemKeys, itemHashes);
+
         // 设置列表的高度（真实高度，非显示的高度）
         if (!isFlowMode || spanCount != 1) {
             // 设置了固定的高度
@@ -322,9 +336,28 @@ void RecyclingGrid::reloadData() {
 }
 
 void RecyclingGrid::notifyDataChanged() {
-    // todo: 目前仅能处理data在原本的基础上增加的情况，需要考虑data减少或更换时的情况
+    // 有新数据时允许再次请求，没有新数据时保持，避免在列表末尾反复请求
+    if (this->getItemCount() != nextPageItemCount) requestNextPage = false;
     if (!layouted) return;
 
+    if (dataSource && dataSource->hasItemKey()) {
+        std::vector<int64_t> keys;
+        std::vector<size_t> hashes;
+        updateItemKeys(keys, hashes);
+        // 只在原本的数据之后追加了数据时，不需要改动屏幕上的列表项
+        bool append =
+            keys.size() >= itemKeys.size() &&
+            std::equal(itemKeys.begin(), itemKeys.end(), keys.begin()) &&
+            std::equal(itemHashes.begin(), itemHashes.end(), hashes.begin());
+        if (!append) {
+            this->applyDiff(std::move(keys), std::move(hashes));
+            return;
+        }
+        itemKeys.swap(keys);
+        itemHashes.swap(hashes);
+    }
+
+    // 没有提供标识的数据源，仅能处理在原本的基础上增加数据的情况
     if (dataSource) {
         if (isFlowMode) {
             for (size_t i = cellHeightCache.size();
@@ -343,6 +376,186 @@ void RecyclingGrid::notifyDataChanged() {
     }
 }
 
+void RecyclingGrid::updateItemKeys(std::vector<int64_t>& keys,
+                                   std::vector<size_t>& hashes) {
+    keys.clear();
+    hashes.clear();
+    if (!dataSource->hasItemKey()) return;
+    size_t count = dataSource->getItemCount();
+    keys.reserve(count);
+    hashes.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        keys.emplace_back(dataSource->getItemKey(i));
+        hashes.emplace_back(dataSource->getItemHash(i));
+    }
+}
+
+void RecyclingGrid::applyDiff(std::vector<int64_t> keys,
+                              std::vector<size_t> hashes) {
+    TRACE_SCOPE("render", "RecyclingGrid::applyDiff");
+    if (keys.empty()) {
+        this->reloadData();
+        return;
+    }
+
+    // 旧的索引 -> 新的索引，内容摘要变化的项目视为删除后重新插入
+    std::unordered_map<int64_t, size_t> newIndex;
+    for (size_t i = 0; i < keys.size(); i++) newIndex.emplace(keys[i], i);
+    auto findNew = [&](size_t index) -> size_t {
+        if (index >= itemKeys.size()) return SIZE_MAX;
+        auto it = newIndex.find(itemKeys[index]);
+        if (it == newIndex.end() || hashes[it->second] != itemHashes[index])
+            return SIZE_MAX;
+        return it->second;
+    };
+
+    // 锚点：焦点所在的列表项，或者屏幕上第一个仍然存在的列表项
+    // 更新后锚点在屏幕上的位置保持不变
+    RecyclingGridItem* focusCell = getFocusedCell();
+    size_t focusIndex            = focusCell ? focusCell->getIndex() : SIZE_MAX;
+    size_t anchorOld = SIZE_MAX, anchorNew = SIZE_MAX;
+    if (focusCell && findNew(focusIndex) != SIZE_MAX) {
+        anchorOld = focusIndex;
+    } else {
+        for (size_t i = visibleMin; i <= visibleMax; i++) {
+            if (findNew(i) == SIZE_MAX) continue;
+            anchorOld = i;
+            break;
+        }
+    }
+    float offset = this->getContentOffsetY();
+    if (anchorOld != SIZE_MAX) {
+        anchorNew = findNew(anchorOld);
+        offset -= getHeightByCellIndex(anchorOld);
+    }
+
+    // 瀑布流模式下复用仍然存在的项目的高度
+    if (isFlowMode) {
+        std::vector<float> cache(keys.size(), -1);
+        for (size_t i = 0; i < cellHeightCache.size(); i++) {
+            size_t j = findNew(i);
+            if (j != SIZE_MAX) cache[j] = cellHeightCache[i];
+        }
+        for (size_t j = 0; j < keys.size(); j++)
+            if (cache[j] == -1) cache[j] = dataSource->heightForRow(this, j);
+        cellHeightCache.swap(cache);
+    }
+
+    // 移除屏幕上的列表项，仍然存在的项目稍后放到新的位置，其余的回收
+    std::unordered_map<size_t, RecyclingGridItem*> kept;
+    auto children = this->contentBox->getChildren();
+    for (auto const& child : children) {
+        auto* cell = (RecyclingGridItem*)child;
+        size_t j   = findNew(cell->getIndex());
+        this->contentBox->removeView(cell, false);
+        if (j != SIZE_MAX && kept.find(j) == kept.end())
+            kept[j] = cell;
+        else
+            queueReusableCell(cell);
+    }
+    itemKeys.swap(keys);
+    itemHashes.swap(hashes);
+
+    // 更新列表高度与滚动位置
+    size_t count = itemKeys.size();
+    float contentHeight;
+    if (isFlowMode) {
+        contentHeight = getHeightByCellIndex(count);
+    } else {
+        contentHeight =
+            (estimatedRowHeight + estimatedRowSpace) * this->getRowCount();
+    }
+    contentHeight += paddingTop + paddingBottom;
+    contentBox->setHeight(contentHeight);
+    if (anchorNew != SIZE_MAX) offset += getHeightByCellIndex(anchorNew);
+    offset = std::min(offset, contentHeight - this->getHeight());
+    offset = std::max(offset, 0.0f);
+    this->setContentOffsetY(offset, false);
+
+    // 从屏幕顶部所在的行开始重新填充
+    size_t start = 0;
+    float top    = paddingTop;
+    while (start + spanCount < count) {
+        float height = getHeightByCellIndex(start + spanCount, start);
+        if (top + height > offset) break;
+        top += height;
+        start += spanCount;
+    }
+
+    visibleMin               = UINT_MAX;
+    visibleMax               = 0;
+    renderedFrame            = brls::Rect();
+    renderedFrame.origin.y   = top - paddingTop;
+    renderedFrame.size.width = getWidth();
+
+    float bottom   = offset + this->getHeight();
+    bool focusKept = false;
+    for (size_t row = start; row < count; row++) {
+        RecyclingGridItem* cell = nullptr;
+        auto it                 = kept.find(row);
+        if (it != kept.end()) {
+            cell = it->second;
+            kept.erase(it);
+            if (cell == focusCell) focusKept = true;
+        }
+        this->addCellAt(row, true, cell);
+        if ((row + 1) % spanCount == 0 &&
+            renderedFrame.getMaxY() -
+                    getHeightByCellIndex(row + 1 - preFetchLine * spanCount,
+                                         row + 1) >
+                bottom)
+            break;
+    }
+    for (auto& i : kept) queueReusableCell(i.second);
+
+    // 焦点所在的项目被删除时，将焦点交给占据原本位置的项目
+    if (focusKept) {
+        brls::Application::giveFocus(focusCell);
+    } else if (focusCell) {
+        RecyclingGridItem* cell =
+            getGridItemByIndex(std::min(focusIndex, count - 1));
+        brls::Application::giveFocus(cell ? (brls::View*)cell : this);
+    }
+}
+
+RecyclingGridItem* RecyclingGrid::getFocusedCell() {
+    brls::View* v = brls::Application::getCurrentFocus();
+    while (v && v->hasParent()) {
+        if (v->getParent() == contentBox)
+            return dynamic_cast<RecyclingGridItem*>(v);
+        v = v->getParent();
+    }
+    return nullptr;
+}
+
+void RecyclingGrid::reloadCell(size_t index) {
+    RecyclingGridItem* old = getGridItemByIndex(index);
+    if (!old) return;
+
+    // 焦点在旧的列表项上时需要转移到新的列表项
+    bool focused = getFocusedCell() == old;
+
+    RecyclingGridItem* cell = dataSource->cellForRow(this, index);
+    cell->setWidth(old->getWidth());
+    cell->setHeight(old->getHeight());
+    cell->setDetachedPositionX(old->getDetachedPosition().x);
+    cell->setDetachedPositionY(old->getDetachedPosition().y);
+    cell->setIndex(index);
+
+    queueReusableCell(old);
+    this->contentBox->removeView(old, false);
+    this->contentBox->getChildren().insert(
+        this->contentBox->getChildren().end(), cell);
+
+    size_t* userdata = (size_t*)malloc(sizeof(size_t));
+    *userdata        = index;
+    cell->setParent(this->contentBox, userdata);
+
+    this->contentBox->invalidate();
+    cell->View::willAppear();
+    if (focused) brls::Application::giveFocus(cell);
+}
+
 RecyclingGridItem* RecyclingGrid::getGridItemByIndex(size_t index) {
     for (brls::View* i : contentBox->getChildren()) {
         RecyclingGridItem* v = dynamic_cast<RecyclingGridItem*>(i);
@@ -358,6 +571,7 @@ std::vector<RecyclingGridItem*>& RecyclingGrid::getGridItems() {
 }
 
 void RecyclingGrid::clearData() {
+    requestNextPage = false;
     if (dataSource) {
         dataSource->clearData();
         this->reloadData();
@@ -397,6 +611,7 @@ void RecyclingGrid::onNextPage(const std::function<void()>& callback) {
 }
 
 void RecyclingGrid::itemsRecyclingLoop() {
+    TRACE_SCOPE("render", "RecyclingGrid::itemsRecyclingLoop");
     if (!dataSource) return;
 
     brls::Rect visibleFrame = getVisibleFrame();
@@ -490,20 +705,24 @@ void RecyclingGrid::itemsRecyclingLoop() {
                         visibleMax + 1,
                         visibleMax + 1 - preFetchLine * spanCount) >
                 visibleFrame.getMaxY() - paddingBottom) {
-                requestNextPage = false;  // 允许加载下一页
+                // 数据有变化时允许加载下一页
+                if (this->getItemCount() != nextPageItemCount)
+                    requestNextPage = false;
                 break;
             }
         addCellAt(visibleMax + 1, true);
     }
 
-    if (visibleMax + 1 >= this->getItemCount()) {
+    // 在到达末尾之前提前请求下一页
+    if (visibleMax + 1 + nextPageLine * spanCount >= this->getItemCount()) {
         // 只有当 requestNextPage 为false时，才可以请求下一页，避免多次重复请求
         if (!requestNextPage && nextPageCallback) {
             // 有数据、不是骨架屏数据、数据不为空
             if (dataSource && !dynamic_cast<DataSourceSkeleton*>(dataSource) &&
                 dataSource->getItemCount() > 0) {
                 brls::Logger::debug("RecyclingGrid request next page");
-                requestNextPage = true;
+                requestNextPage   = true;
+                nextPageItemCount = this->getItemCount();
                 this->nextPageCallback();
             }
         }
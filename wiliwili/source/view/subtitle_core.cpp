@@ -2,6 +2,8 @@
 // Created by fang on 2023/3/6.
 //
 
+#include <algorithm>
+
 #include "view/subtitle_core.hpp"
 #include "bilibili.h"
 
@@ -22,8 +24,12 @@ SubtitleCore::~SubtitleCore() { MPV_E->unsubscribe(event_id); }
 
 void SubtitleCore::setSubtitleList(const bilibili::VideoPageResult& data) {
     videoPageData = data;
-    for (auto& i : data.subtitles) {
+    requestingSubtitles.clear();
+    pendingSubtitle.clear();
+    for (auto& i : videoPageData.subtitles) {
         brls::Logger::debug("{}: {}", i.lan_doc, i.subtitle_url);
+        // 预先下载全部字幕，切换字幕时不需要等待
+        this->requestSubtitle(i);
     }
 }
 
@@ -32,7 +38,7 @@ void SubtitleCore::reset() {
     this->videoPageData.last_play_cid  = 0;
     this->videoPageData.last_play_time = 0;
     this->videoPageData.online_count   = 0;
-    this->subtitleIndex                = 0;
+    this->requestingSubtitles.clear();
     this->clearSubtitle();
 }
 
@@ -40,57 +46,91 @@ void SubtitleCore::reset() {
     return !videoPageData.subtitles.empty();
 }
 
+void SubtitleCore::seekSubtitle(double time) {
+    auto& body = currentSubtitle.data.body;
+    auto it    = std::partition_point(
+        body.begin(), body.end(),
+        [time](const bilibili::SubtitleLine& i) { return i.to < time; });
+    subtitleIndex = it - body.begin();
+}
+
+void SubtitleCore::measureSubtitle(NVGcontext* vg, bilibili::SubtitleLine& line) {
+    float bounds[4];
+    line.length = 0;
+    for (auto& row : line.rows) {
+        nvgTextBounds(vg, 0, 0, row.content.c_str(), nullptr, bounds);
+        row.length  = bounds[2] - bounds[0];
+        line.length = std::max(line.length, row.length);
+    }
+}
+
 void SubtitleCore::drawSubtitle(NVGcontext* vg, float x, float y, float width,
                                 float height, float alpha) {
+    auto& body = currentSubtitle.data.body;
+    if (body.empty()) return;
+
+    // 正常播放时字幕索引只向前移动，进度回退或大幅跳转时重新查找
     double playbackTime = MPVCore::instance().playback_time;
-    for (size_t i = subtitleIndex; i < currentSubtitle.data.body.size(); i++) {
-        auto& line = currentSubtitle.data.body[i];
-        // 当前还不能播放字幕
-        if (line.from >= playbackTime) break;
-        // 当前字幕播放结束，应该播放下一条
-        if (line.to < playbackTime) continue;
-
-        float fontSize               = 26;
-        float borderV                = 6;
-        float borderH                = 16;
-        float bottomSpace            = 26;
-        float backgroundCornerRadius = 2;
-
-        // 初始化
-        nvgFontSize(vg, fontSize);
-        nvgTextAlign(vg, NVG_ALIGN_TOP | NVG_ALIGN_LEFT);
-        nvgFontFaceId(vg, this->subtitleFont);
-        nvgTextLineHeight(vg, 1);
-        if (line.length <= 0) {
-            float bounds[4];
-            nvgTextBounds(vg, 0, 0, line.content.c_str(), nullptr, bounds);
-            line.length = bounds[2] - bounds[0];
-        }
+    if (playbackTime < lastPlaybackTime ||
+        playbackTime - lastPlaybackTime > SEEK_THRESHOLD) {
+        this->seekSubtitle(playbackTime);
+    } else {
+        while (subtitleIndex < body.size() &&
+               body[subtitleIndex].to < playbackTime)
+            subtitleIndex++;
+    }
+    lastPlaybackTime = playbackTime;
+
+    float fontSize               = 26;
+    float borderV                = 6;
+    float borderH                = 16;
+    float bottomSpace            = 26;
+    float backgroundCornerRadius = 2;
+
+    // 初始化
+    nvgFontSize(vg, fontSize);
+    nvgTextAlign(vg, NVG_ALIGN_TOP | NVG_ALIGN_LEFT);
+    nvgFontFaceId(vg, this->subtitleFont);
+    nvgTextLineHeight(vg, 1);
+
+    // 分批测量即将显示的字幕，避免在字幕出现时集中测量
+    measuredIndex = std::max(measuredIndex, subtitleIndex);
+    size_t measureEnd = std::min(body.size(), measuredIndex + MEASURE_BATCH);
+    for (; measuredIndex < measureEnd; measuredIndex++) {
+        if (body[measuredIndex].length < 0)
+            measureSubtitle(vg, body[measuredIndex]);
+    }
 
-        // 绘制字幕背景
-        nvgBeginPath(vg);
-        nvgFillColor(vg, a(backgroundColor, alpha));
-        nvgRoundedRect(vg, x + (width - line.length) / 2 - borderH,
-                       y + height - borderV - fontSize - bottomSpace,
-                       line.length + borderH * 2, fontSize + borderV * 2,
-                       backgroundCornerRadius);
-        nvgFill(vg);
-
-        // 绘制字幕
-        nvgFillColor(vg, a(fontColor, alpha));
-        nvgText(vg, x + (width - line.length) / 2,
-                y + height - fontSize - bottomSpace, line.content.c_str(),
-                nullptr);
-
-        // 绘制AI标记
-        if (!currentSubtitle.data.genByAI) break;
-        nvgFontSize(vg, 8);
-        nvgFillColor(vg, a(nvgRGBA(255, 255, 255, 127), alpha));
-        nvgText(vg, x + (width + line.length) / 2 + 4,
-                y + height - borderV - fontSize - bottomSpace + 4, "AI",
-                nullptr);
-        break;
+    if (subtitleIndex >= body.size()) return;
+    auto& line = body[subtitleIndex];
+    // 当前还不能播放字幕
+    if (line.from >= playbackTime) return;
+    if (line.length < 0) measureSubtitle(vg, line);
+    if (line.rows.empty()) return;
+
+    // 绘制字幕背景
+    float rowsHeight = fontSize * line.rows.size();
+    float top        = y + height - bottomSpace - rowsHeight - borderV;
+    nvgBeginPath(vg);
+    nvgFillColor(vg, a(backgroundColor, alpha));
+    nvgRoundedRect(vg, x + (width - line.length) / 2 - borderH, top,
+                   line.length + borderH * 2, rowsHeight + borderV * 2,
+                   backgroundCornerRadius);
+    nvgFill(vg);
+
+    // 绘制字幕
+    nvgFillColor(vg, a(fontColor, alpha));
+    for (size_t i = 0; i < line.rows.size(); i++) {
+        auto& row = line.rows[i];
+        nvgText(vg, x + (width - row.length) / 2, top + borderV + fontSize * i,
+                row.content.c_str(), nullptr);
     }
+
+    // 绘制AI标记
+    if (!currentSubtitle.data.genByAI) return;
+    nvgFontSize(vg, 8);
+    nvgFillColor(vg, a(nvgRGBA(255, 255, 255, 127), alpha));
+    nvgText(vg, x + (width + line.length) / 2 + 4, top + 4, "AI", nullptr);
 }
 
 bilibili::VideoPageResult SubtitleCore::getSubtitleList() {
@@ -99,44 +139,68 @@ bilibili::VideoPageResult SubtitleCore::getSubtitleList() {
 
 void SubtitleCore::selectSubtitle(size_t index) {
     if (index < 0 || index >= videoPageData.subtitles.size()) return;
-    auto& page     = videoPageData.subtitles[index];
-    std::string id = page.id_str;
+    auto& page = videoPageData.subtitles[index];
     if (page.data.body.empty()) {
-        // 下载字幕
-        ASYNC_RETAIN
-        BILI::get_subtitle(
-            page.subtitle_url,
-            [ASYNC_TOKEN, id](const bilibili::SubtitleData& result) {
-                brls::sync([ASYNC_TOKEN, id, result]() {
-                    ASYNC_RELEASE
-                    for (auto& i : videoPageData.subtitles) {
-                        if (i.id_str == id) {
-                            i.data = result;
-                            onLoadSubtitle(i);
-                            return;
-                        }
+        // 字幕还未下载完成，完成后自动显示
+        pendingSubtitle = page.id_str;
+        this->requestSubtitle(page);
+    } else {
+        pendingSubtitle.clear();
+        onLoadSubtitle(page);
+    }
+}
+
+void SubtitleCore::requestSubtitle(const bilibili::VideoPageSubtitle& page) {
+    if (!page.data.body.empty()) return;
+    std::string id = page.id_str;
+    if (requestingSubtitles.count(id)) return;
+    requestingSubtitles.insert(id);
+
+    ASYNC_RETAIN
+    BILI::get_subtitle(
+        page.subtitle_url,
+        [ASYNC_TOKEN, id](const bilibili::SubtitleData& result) {
+            brls::sync([ASYNC_TOKEN, id,
+                        data = wiliwili::moveToShared(
+                            bilibili::SubtitleData(result))]() {
+                ASYNC_RELEASE
+                requestingSubtitles.erase(id);
+                for (auto& i : videoPageData.subtitles) {
+                    if (i.id_str != id) continue;
+                    i.data = std::move(*data);
+                    if (pendingSubtitle == id) {
+                        pendingSubtitle.clear();
+                        onLoadSubtitle(i);
                     }
-                });
-            },
-            [ASYNC_TOKEN](BILI_ERR) {
+                    return;
+                }
+            });
+        },
+        [ASYNC_TOKEN, id](BILI_ERR) {
+            brls::sync([ASYNC_TOKEN, id, error]() {
                 ASYNC_RELEASE
+                requestingSubtitles.erase(id);
+                if (pendingSubtitle == id) pendingSubtitle.clear();
                 brls::Logger::error("请求字幕失败: {}", error);
             });
-
-    } else {
-        onLoadSubtitle(page);
-    }
+        });
 }
 
 void SubtitleCore::onLoadSubtitle(const bilibili::VideoPageSubtitle& page) {
-    currentSubtitle = page;
+    currentSubtitle  = page;
+    measuredIndex    = 0;
+    lastPlaybackTime = MPVCore::instance().playback_time;
+    this->seekSubtitle(lastPlaybackTime);
     brls::Logger::info("select subtitle: {}", page.lan_doc);
 }
 
 void SubtitleCore::clearSubtitle() {
     currentSubtitle = bilibili::VideoPageSubtitle{};
+    subtitleIndex   = 0;
+    measuredIndex   = 0;
+    pendingSubtitle.clear();
 }
 
 [[nodiscard]] std::string SubtitleCore::getCurrentSubtitleId() const {
     return currentSubtitle.id_str;
-}
\ No newline at end of file
+}
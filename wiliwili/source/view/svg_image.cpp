@@ -2,14 +2,51 @@
 // Created by fang on 2022/9/17.
 //
 
+#include <algorithm>
+#include <fmt/format.h>
+
 #include "view/svg_image.hpp"
 #include "borealis/core/cache_helper.hpp"
+#include "borealis/core/thread.hpp"
+
+class SVGThreadPool : public cpr::ThreadPool,
+                      public brls::Singleton<SVGThreadPool> {
+public:
+    SVGThreadPool()
+        : cpr::ThreadPool(1, SVGImage::RENDER_THREADS,
+                          std::chrono::milliseconds(5000)) {
+        this->Start();
+    }
+
+    ~SVGThreadPool() override { this->Stop(); }
+};
+
+/// 渲染后的 RGBA 数据
+struct SVGBitmap {
+    std::vector<uint8_t> data;
+    int width  = 0;
+    int height = 0;
+};
+
+static std::unique_ptr<lunasvg::Document> loadSVG(const std::string& path) {
+#ifdef USE_LIBROMFS
+    if (path.rfind("@res/", 0) == 0) {
+        auto image = romfs::get(path.substr(5));
+        return lunasvg::Document::loadFromData(
+            (const char*)image.string().data(), image.size());
+    }
+#endif
+    return lunasvg::Document::loadFromFile(path);
+}
 
 SVGImage::SVGImage() {
     this->registerFilePathXMLAttribute("SVG", [this](const std::string& value) {
         this->setImageFromSVGFile(value);
     });
 
+    this->registerColorXMLAttribute(
+        "SVGTint", [this](NVGcolor value) { this->setSVGTint(value); });
+
     // 交给缓存自动处理纹理的删除
     this->setFreeTexture(false);
 
@@ -27,67 +64,139 @@ SVGImage::SVGImage() {
 
 void SVGImage::setImageFromSVGRes(const std::string& value) {
 #ifdef USE_LIBROMFS
-    filePath = "@res/" + value;
-    if (checkCache(filePath) > 0) return;
-    auto image     = romfs::get(value);
-    this->document = lunasvg::Document::loadFromData(
-        (const char*)image.string().data(), image.size());
-    if (this->document) {
-        this->updateBitmap();
-    } else {
-        brls::Logger::error("setImageFromSVGRes: cannot load svg image: {}",
-                            value);
-        return;
-    }
-
-    size_t tex = this->getTexture();
-    if (tex > 0) {
-        brls::Logger::verbose("cache svg: {} {}", value, tex);
-        brls::TextureCache::instance().addCache("@res/" + value, tex);
-    } else {
-        brls::Logger::error("svg got zero tex: {} {}", value, tex);
-    }
+    this->setImageFromSVGFile("@res/" + value);
 #else
     this->setImageFromSVGFile(std::string(BRLS_RESOURCES) + value);
 #endif
 }
 
 void SVGImage::setImageFromSVGFile(const std::string& value) {
-    filePath = value;
-#ifdef USE_LIBROMFS
-    if (value.rfind("@res/", 0) == 0)
-        return this->setImageFromSVGRes(value.substr(5));
-#endif
-    if (checkCache(value) > 0) return;
-
-    this->document = lunasvg::Document::loadFromFile(value);
-    if (this->document) {
-        this->updateBitmap();
-    } else {
-        brls::Logger::error("setImageFromSVGFile: cannot load svg image: {}",
-                            value);
+    filePath   = value;
+    int width  = (int)(this->getWidth() * brls::Application::windowScale);
+    int height = (int)(this->getHeight() * brls::Application::windowScale);
+    std::string key =
+        fmt::format("{}#{}x{}#{:08x}", value, width, height, tint);
+
+    requestKey = key;
+    if (key == currentKey) return;
+    int cached = this->cacheTexture;
+    int tex    = checkCache(key);
+    if (tex > 0) {
+        // checkCache 增加了新纹理的引用计数，释放之前使用的纹理
+        if (cached > 0) brls::TextureCache::instance().removeCache(cached);
+        this->cacheTexture = tex;
+        currentKey         = key;
         return;
     }
 
-    size_t tex = this->getTexture();
-    if (tex > 0) {
-        brls::Logger::verbose("cache svg: {} {}", value, tex);
-        brls::TextureCache::instance().addCache(value, tex);
-    } else {
-        brls::Logger::error("svg got zero tex: {} {}", value, tex);
+    // 已经有相同的渲染任务，等待其完成
+    auto pending = pendingViews.find(key);
+    if (pending != pendingViews.end()) {
+        auto& views = pending->second;
+        if (std::find(views.begin(), views.end(), this) != views.end()) return;
+        this->ptrLock();
+        views.emplace_back(this);
+        return;
     }
+    this->ptrLock();
+    pendingViews[key] = {this};
+
+    uint32_t color = tint;
+    SVGThreadPool::instance().Submit([key, value, width, height, color]() {
+        auto bitmap   = std::make_shared<SVGBitmap>();
+        auto document = loadSVG(value);
+        if (document) {
+            auto res = document->renderToBitmap(width, height);
+            res.convertToRGBA();
+            bitmap->width  = (int)res.width();
+            bitmap->height = (int)res.height();
+            bitmap->data.assign(res.data(),
+                                res.data() + res.width() * res.height() * 4);
+            if (color != 0) {
+                // 替换颜色，保留原本的透明度
+                uint8_t r = color >> 24, g = color >> 16, b = color >> 8,
+                        a = color;
+                for (size_t i = 0; i < bitmap->data.size(); i += 4) {
+                    bitmap->data[i]     = r;
+                    bitmap->data[i + 1] = g;
+                    bitmap->data[i + 2] = b;
+                    bitmap->data[i + 3] = bitmap->data[i + 3] * a / 255;
+                }
+            }
+        } else {
+            brls::Logger::error("SVGImage: cannot load svg image: {}", value);
+        }
+
+        brls::sync([key, bitmap]() {
+            int tex = 0;
+            if (!bitmap->data.empty()) {
+                NVGcontext* vg = brls::Application::getNVGContext();
+                tex = nvgCreateImageRGBA(vg, bitmap->width, bitmap->height, 0,
+                                         bitmap->data.data());
+            }
+            if (tex > 0) {
+                brls::Logger::verbose("cache svg: {} {}", key, tex);
+                brls::TextureCache::instance().addCache(key, tex);
+            } else if (!bitmap->data.empty()) {
+                brls::Logger::error("svg got zero tex: {}", key);
+            }
+
+            auto views = std::move(pendingViews[key]);
+            pendingViews.erase(key);
+            bool first = true;
+            for (auto* view : views) {
+                if (tex > 0 && view->requestKey == key) {
+                    // 第一个组件使用 addCache 的引用，其余组件各自增加引用计数
+                    if (!first) brls::TextureCache::instance().getCache(key);
+                    first = false;
+                    view->applyTexture(key, tex);
+                }
+                view->ptrUnlock();
+            }
+            // 没有组件使用时交由缓存回收
+            if (tex > 0 && first)
+                brls::TextureCache::instance().removeCache(tex);
+        });
+    });
+}
+
+void SVGImage::applyTexture(const std::string& key, int tex) {
+    this->releaseCache();
+    this->currentKey   = key;
+    this->cacheTexture = tex;
+    this->innerSetImage(tex);
+}
+
+void SVGImage::releaseCache() {
+    if (cacheTexture > 0)
+        brls::TextureCache::instance().removeCache(cacheTexture);
+    cacheTexture = 0;
 }
 
 void SVGImage::setImageFromSVGString(const std::string& value) {
+    filePath.clear();
+    currentKey.clear();
+    requestKey.clear();
     this->document = lunasvg::Document::loadFromData(value);
     if (this->document) {
         this->updateBitmap();
+        this->releaseCache();
     } else {
         brls::Logger::error("setImageFromSVGString: cannot load svg image: {}",
                             value);
     }
 }
 
+void SVGImage::setSVGTint(NVGcolor value) {
+    uint32_t color = ((uint32_t)(value.r * 255) << 24) |
+                     ((uint32_t)(value.g * 255) << 16) |
+                     ((uint32_t)(value.b * 255) << 8) |
+                     (uint32_t)(value.a * 255);
+    if (color == tint) return;
+    tint = color;
+    if (!filePath.empty()) this->setImageFromSVGFile(filePath);
+}
+
 void SVGImage::updateBitmap() {
     if (!this->document) return;
 
@@ -109,6 +218,7 @@ void SVGImage::rotate(float value) { this->angle = value; }
 
 SVGImage::~SVGImage() {
     brls::Application::getWindowSizeChangedEvent()->unsubscribe(subscription);
+    this->releaseCache();
 }
 
 brls::View* SVGImage::create() { return new SVGImage(); }
@@ -2,16 +2,69 @@
 // Created by fang on 2022/12/4.
 //
 
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-
+#include <list>
 #include <utility>
-#include <codecvt>
-#include <locale>
+#include <unordered_map>
 
 #include "view/text_box.hpp"
+#include "utils/opencc_helper.hpp"
 
 const char* TEXTBOX_MORE = "更多";
 
+/**
+ * 排版结果的缓存
+ * 以 (内容标识, 宽度, 字号, 行高) 为键，超出 LAYOUT_CACHE_SIZE 时淘汰最久未使用的结果
+ */
+class RichTextLayoutCache : public brls::Singleton<RichTextLayoutCache> {
+public:
+    struct Key {
+        uint64_t id;
+        float width, fontSize, lineHeight;
+
+        bool operator==(const Key& o) const {
+            return id == o.id && width == o.width && fontSize == o.fontSize &&
+                   lineHeight == o.lineHeight;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            size_t h = std::hash<uint64_t>()(k.id);
+            for (float f : {k.width, k.fontSize, k.lineHeight})
+                h = h * 31 + std::hash<float>()(f);
+            return h;
+        }
+    };
+
+    std::shared_ptr<const RichTextLayout> get(const Key& key) {
+        auto it = items.find(key);
+        if (it == items.end()) return nullptr;
+        lru.splice(lru.end(), lru, it->second);
+        return it->second->second;
+    }
+
+    void put(const Key& key, std::shared_ptr<const RichTextLayout> layout) {
+        if (TextBox::LAYOUT_CACHE_SIZE == 0) return;
+        auto it = items.find(key);
+        if (it != items.end()) {
+            it->second->second = std::move(layout);
+            lru.splice(lru.end(), lru, it->second);
+            return;
+        }
+        lru.emplace_back(key, std::move(layout));
+        items[key] = std::prev(lru.end());
+        while (lru.size() > TextBox::LAYOUT_CACHE_SIZE) {
+            items.erase(lru.front().first);
+            lru.pop_front();
+        }
+    }
+
+private:
+    using Item = std::pair<Key, std::shared_ptr<const RichTextLayout>>;
+    std::list<Item> lru;
+    std::unordered_map<Key, std::list<Item>::iterator, KeyHash> items;
+};
+
 // Modified from https://github.com/memononen/nanovg
 // Do not directly modify nanovg for easy upgrade in the future
 // Great thanks to nanovg!
@@ -19,51 +72,57 @@ const char* TEXTBOX_MORE = "更多";
 inline float minf(float a, float b) { return a < b ? a : b; }
 inline float maxf(float a, float b) { return a > b ? a : b; }
 
-inline static std::shared_ptr<RichTextComponent> genRichTextSpan(
-    const std::string& text, float x, float y, NVGcolor c) {
-    auto item = std::make_shared<RichTextSpan>(text, c);
-    item->setPosition(x, y);
-    return item;
+/// 字符串中的 UTF-8 字符数
+static size_t utf8Length(const char* start, const char* end) {
+    size_t count = 0;
+    for (const char* p = start; p < end; p++)
+        if ((*p & 0xC0) != 0x80) count++;
+    return count;
 }
 
-inline static std::shared_ptr<RichTextComponent> genRichTextImage(
-    const std::string& url, float width, float height, float x, float y) {
-    auto item = std::make_shared<RichTextImage>(url, width, height, true);
-    item->setPosition(x, y);
-    return item;
+/// 将文字追加到排版结果的字符串中，生成对应的片段
+static RichTextLayoutSpan genRichTextSpan(RichTextLayout& layout,
+                                          uint32_t source, const char* start,
+                                          const char* end, float x, float y) {
+    RichTextLayoutSpan span{RichTextType::Text, source};
+    span.offset = (uint32_t)layout.text.size();
+    span.length = (uint32_t)(end - start);
+    span.x      = x;
+    span.y      = y;
+    layout.text.append(start, end);
+    return span;
 }
 
-RichTextData richTextBreakLines(NVGcontext* ctx, float x, float y,
-                                float breakRowWidth, const std::string& text,
-                                NVGcolor c, float lineHeight, float sx,
-                                float* lx, float* ly) {
-    NVGtextRow rows[2];
+/// 分割后的各行保存在 rows 中
+void richTextBreakLines(NVGcontext* ctx, RichTextLayout& layout,
+                        std::vector<RichTextLayoutSpan>& rows, uint32_t source,
+                        float x, float y, float breakRowWidth,
+                        const std::string& text, float lineHeight, float sx,
+                        float* lx, float* ly) {
+    NVGtextRow textRows[2];
     int nrows   = 0, i;
     float lineh = 0;
     NVGtextRow* row;
-    RichTextData res;
-    const char* stringStart = text.c_str();
-    const char* string      = stringStart;
+    const char* string = text.c_str();
+    rows.clear();
 
     nvgTextMetrics(ctx, nullptr, nullptr, &lineh);
 
     // 第一行
-    nrows =
-        nvgTextBreakLines(ctx, string, nullptr, breakRowWidth - sx, rows, 1);
+    nrows = nvgTextBreakLines(ctx, string, nullptr, breakRowWidth - sx,
+                              textRows, 1);
     if (nrows > 0) {
-        row = &rows[0];
-        std::string currentText =
-            text.substr(row->start - stringStart, row->end - row->start);
-        auto firstLine =
-            std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>>().from_bytes(
-                currentText);
-        if (firstLine.length() == 1 && row->width / 2 + sx > breakRowWidth) {
+        row = &textRows[0];
+        if (utf8Length(row->start, row->end) == 1 &&
+            row->width / 2 + sx > breakRowWidth) {
             // 只有一个字符且宽度超出了范围
             // 这里使用 row->width / 2 来判断是因为 nanovg在这种情况下会错误的返回前两个字符的宽度
             // 添加空白的一行
-            res.emplace_back(genRichTextSpan("", x + sx, y, c));
+            rows.emplace_back(
+                genRichTextSpan(layout, source, string, string, x + sx, y));
         } else {
-            res.emplace_back(genRichTextSpan(currentText, x + sx, y, c));
+            rows.emplace_back(genRichTextSpan(layout, source, row->start,
+                                              row->end, x + sx, y));
             if (lx) *lx = sx + row->width;
             if (ly) *ly = y;
             string = row->next;
@@ -72,20 +131,18 @@ RichTextData richTextBreakLines(NVGcontext* ctx, float x, float y,
     }
 
     // 之后的若干行
-    while ((nrows = nvgTextBreakLines(ctx, string, nullptr, breakRowWidth, rows,
-                                      2))) {
+    while ((nrows = nvgTextBreakLines(ctx, string, nullptr, breakRowWidth,
+                                      textRows, 2))) {
         for (i = 0; i < nrows; i++) {
-            row = &rows[i];
-            res.emplace_back(genRichTextSpan(
-                text.substr(row->start - stringStart, row->end - row->start), x,
-                y, c));
+            row = &textRows[i];
+            rows.emplace_back(
+                genRichTextSpan(layout, source, row->start, row->end, x, y));
             if (lx) *lx = row->width;
             if (ly) *ly = y;
             y += lineh * lineHeight;
         }
-        string = rows[nrows - 1].next;
+        string = textRows[nrows - 1].next;
     }
-    return res;
 }
 
 // End of nanovg modification
@@ -126,50 +183,40 @@ TextBox::TextBox() {
     // todo 因为 nanovg 限制每个富文本结尾的\n和开头的空格不会被渲染
 }
 
-void TextBox::setRichText(const RichTextData& value) {
-#ifdef OPENCC
-    static bool trans =
-        brls::Application::getLocale() == brls::LOCALE_ZH_HANT ||
-        brls::Application::getLocale() == brls::LOCALE_ZH_TW;
-    if (trans && OPENCC_ON) {
+void TextBox::setRichText(const RichTextData& value, uint64_t id) {
+    // 列表项被复用时显示相同的内容
+    if (id != 0 && id == this->contentId) return;
+    this->contentId = id;
+    if (OpenCCHelper::isEnabled()) {
+        auto& converter = OpenCCHelper::instance();
         this->richContent.clear();
         for (auto& i : value) {
             if (i->type == RichTextType::Text) {
                 auto* t = (RichTextSpan*)i.get();
-                t->text = Label::STConverter(t->text);
+                t->text = converter.convert(t->text);
             }
             this->richContent.emplace_back(i);
         }
     } else {
         this->richContent = value;
     }
-#else
-    this->richContent = value;
-#endif
-    this->lineContent.clear();
+    this->layout.reset();
     this->setParsedDone(false);
     // 设置内容后调用 invalidate 会触发 textBoxMeasureFunc 重排布局
     this->invalidate();
 }
 
+uint64_t TextBox::getContentId() const { return this->contentId; }
+
 RichTextData& TextBox::getRichText() { return this->richContent; }
 
 void TextBox::setText(const std::string& value) {
-    std::string text;
-#ifdef OPENCC
-    static bool trans =
-        brls::Application::getLocale() == brls::LOCALE_ZH_HANT ||
-        brls::Application::getLocale() == brls::LOCALE_ZH_TW;
-    if (trans && OPENCC_ON) {
-        text = Label::STConverter(value);
-    } else {
-        text = value;
-    }
-#else
-    text              = value;
-#endif
+    std::string text = OpenCCHelper::instance().convert(value);
     this->richContent.clear();
+    this->layout.reset();
     this->setParsedDone(false);
+    // 纯文本使用内容的哈希作为标识，最高位用来与 setRichText 的标识区分
+    this->contentId = std::hash<std::string>()(text) | (1ULL << 63);
     this->richContent.emplace_back(
         std::make_shared<RichTextSpan>(text, this->textColor));
     this->invalidate();
@@ -183,10 +230,38 @@ void TextBox::onLayout() {
 }
 
 float TextBox::cutRichTextLines(float width) {
-    this->lineContent.clear();
+    this->layout.reset();
     if (this->richContent.empty()) return 0;
 
-    auto* vg = brls::Application::getNVGContext();
+    // 排版结果只引用图片的位置，图片本身由富文本数据持有
+    for (auto& i : richContent)
+        if (i->type == RichTextType::Image) ((RichTextImage*)i.get())->load();
+
+    RichTextLayoutCache::Key key{contentId, width, fontSize, lineHeight};
+    if (contentId != 0) this->layout = RichTextLayoutCache::instance().get(key);
+    if (!this->layout) {
+        auto result = this->layoutRichText(width);
+        if (contentId != 0) RichTextLayoutCache::instance().put(key, result);
+        this->layout = std::move(result);
+    }
+
+    size_t rows = maxRows;
+    if (isShowMoreText() && maxRows != SIZE_T_MAX) rows++;
+
+    if (maxRows == SIZE_T_MAX || rows >= layout->lines.size()) {
+        // 无限制最大行数 或 最大行数大于等于当前行数
+        return layout->height;
+    }
+
+    // 限制最大行数
+    return getLineY(maxRows) + fontSize;
+}
+
+std::shared_ptr<RichTextLayout> TextBox::layoutRichText(float width) {
+    auto res    = std::make_shared<RichTextLayout>();
+    auto& spans = res->spans;
+    auto& lines = res->lines;
+    auto* vg    = brls::Application::getNVGContext();
 
     nvgFontSize(vg, this->fontSize);
     nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
@@ -194,30 +269,33 @@ float TextBox::cutRichTextLines(float width) {
     nvgTextLineHeight(vg, this->lineHeight);
     nvgFillColor(vg, a(this->textColor));
 
+    // 提交从 lineStart 开始的片段作为新的一行
+    uint32_t lineStart = 0;
+    auto commitLine    = [&]() {
+        lines.push_back({lineStart, (uint32_t)spans.size() - lineStart});
+        lineStart = (uint32_t)spans.size();
+    };
+
     float lx = 0, ly = 0;
-    RichTextData tempData;
-    for (const auto& i : richContent) {
+    std::vector<RichTextLayoutSpan> rows;
+    for (uint32_t index = 0; index < richContent.size(); index++) {
+        auto& i = richContent[index];
         if (i->type == RichTextType::Text) {
             auto* t = (RichTextSpan*)i.get();
             if (t->text.empty()) continue;
-            auto rows = richTextBreakLines(vg, 0, ly, width, t->text, t->color,
-                                           this->lineHeight, lx + t->l_margin,
-                                           &lx, &ly);
+            richTextBreakLines(vg, *res, rows, index, 0, ly, width, t->text,
+                               this->lineHeight, lx + t->l_margin, &lx, &ly);
             lx += t->r_margin;
             if (rows.empty()) {
                 // 应该不会出现这种情况
                 brls::Logger::error("TextBox: got empty line: {}", t->text);
             } else if (rows.size() == 1) {
-                tempData.emplace_back(rows[0]);
+                spans.emplace_back(rows[0]);
             } else {
-                if (!((RichTextSpan*)rows[0].get())->text.empty()) {
-                    tempData.emplace_back(rows[0]);
-                }
+                if (rows[0].length > 0) spans.emplace_back(rows[0]);
                 for (auto it = rows.begin() + 1; it != rows.end(); it++) {
-                    if (!tempData.empty())
-                        this->lineContent.emplace_back(tempData);
-                    tempData.clear();
-                    tempData.emplace_back(*it);
+                    if (spans.size() > lineStart) commitLine();
+                    spans.emplace_back(*it);
                 }
             }
 
@@ -227,66 +305,52 @@ float TextBox::cutRichTextLines(float width) {
             if (lx + t->width + 2 + t->l_margin + t->r_margin - 2 > width) {
                 // 当前行长度不够，就换到下一行
                 // 提交之前的行
-                this->lineContent.emplace_back(tempData);
-                tempData.clear();
+                commitLine();
                 // 设置下一行的其实位置
                 lx = 0;
                 ly += fontSize * lineHeight;
             }
-            auto item =
-                genRichTextImage(t->url, t->width, t->height, lx + t->l_margin,
-                                 ly - t->height + fontSize + t->v_align);
-            item->t_margin = t->t_margin;
-            tempData.emplace_back(item);
+            RichTextLayoutSpan item{RichTextType::Image, index};
+            item.x = lx + t->l_margin;
+            item.y = ly - t->height + fontSize + t->v_align;
+            spans.emplace_back(item);
             lx += t->width + t->l_margin + t->r_margin;
         }
     }
-    if (!tempData.empty()) lineContent.emplace_back(tempData);
+    if (spans.size() > lineStart) commitLine();
 
     // 重新扫描一遍，根据图片高度调整行高
     float height = fontSize * lineHeight;
     float bias   = 0;
-    for (auto& i : lineContent) {
+    for (auto& line : lines) {
         // 获取最大行高
         float maxLineHeight = height;
-        for (auto& j : i) {
-            if (j->type == RichTextType::Image) {
-                auto* t       = (RichTextImage*)j.get();
-                maxLineHeight = maxf(maxLineHeight, t->height + t->t_margin);
-            }
+        for (uint32_t j = line.start; j < line.start + line.count; j++) {
+            if (spans[j].type != RichTextType::Image) continue;
+            auto* t = (RichTextImage*)richContent[spans[j].source].get();
+            maxLineHeight = maxf(maxLineHeight, t->height + t->t_margin);
         }
         bias += maxLineHeight - height;
-        for (auto& j : i) {
-            j->y += bias;
+        for (uint32_t j = line.start; j < line.start + line.count; j++) {
+            spans[j].y += bias;
+            line.top =
+                j == line.start ? spans[j].y : minf(line.top, spans[j].y);
         }
     }
 
     float pxBottomSpace = fontSize * (lineHeight - 1);
-    size_t rows         = maxRows;
-    if (isShowMoreText() && maxRows != SIZE_T_MAX) rows++;
-
-    if (maxRows == SIZE_T_MAX || rows >= lineContent.size()) {
-        // 无限制最大行数 或 最大行数大于等于当前行数
-        return height * (float)lineContent.size() + bias - pxBottomSpace;
-    }
-
-    // 限制最大行数
-    return getLineY(maxRows) + fontSize;
+    res->height = height * (float)lines.size() + bias - pxBottomSpace;
+    return res;
 }
 
 float TextBox::getLineY(size_t line) {
-    if (line >= lineContent.size()) return 0;
-    if (lineContent[line].empty()) return 0;
-    float y = lineContent[line][0]->y;
-    for (auto& i : lineContent[line]) {
-        y = minf(y, i->y);
-    }
-    return y;
+    if (!layout || line >= layout->lines.size()) return 0;
+    return layout->lines[line].top;
 }
 
 void TextBox::draw(NVGcontext* vg, float x, float y, float width, float height,
                    brls::Style style, brls::FrameContext* ctx) {
-    if (width == 0) return;
+    if (width == 0 || !layout) return;
 
     nvgFontSize(vg, this->fontSize);
     nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
@@ -300,30 +364,34 @@ void TextBox::draw(NVGcontext* vg, float x, float y, float width, float height,
         drawRow++;
     }
 
-    for (size_t line = 0; line < drawRow && line < lineContent.size(); line++) {
+    auto& lines = layout->lines;
+    for (size_t line = 0; line < drawRow && line < lines.size(); line++) {
         // 当最后一行给 "更多" 留出空闲区域时，跳出循环
-        if (showMoreText && line == drawRow - 1 &&
-            lineContent.size() != drawRow)
+        if (showMoreText && line == drawRow - 1 && lines.size() != drawRow)
             break;
 
         // 绘制第 line 行
-        for (auto& i : lineContent[line]) {
-            if (i->type == RichTextType::Text) {
-                auto* t = (RichTextSpan*)i.get();
-                if (t->text.empty()) continue;
-                nvgFillColor(vg, a(t->color));
-                nvgText(vg, x + t->x, y + t->y, t->text.c_str(), nullptr);
-            } else if (i->type == RichTextType::Image) {
-                auto* t = (RichTextImage*)i.get();
+        auto& l = lines[line];
+        for (uint32_t j = l.start; j < l.start + l.count; j++) {
+            auto& span = layout->spans[j];
+            if (span.source >= richContent.size()) continue;
+            auto* source = richContent[span.source].get();
+            if (span.type == RichTextType::Text) {
+                if (span.length == 0) continue;
+                const char* text = layout->text.c_str() + span.offset;
+                nvgFillColor(vg, a(((RichTextSpan*)source)->color));
+                nvgText(vg, x + span.x, y + span.y, text, text + span.length);
+            } else if (span.type == RichTextType::Image) {
+                auto* t = (RichTextImage*)source;
                 t->image->setAlpha(this->getAlpha());
-                t->image->draw(vg, x + t->x, y + t->y, t->width, t->height,
+                t->image->draw(vg, x + span.x, y + span.y, t->width, t->height,
                                style, ctx);
             }
         }
     }
 
     // 已经显示了全部文字
-    if (lineContent.size() <= drawRow) {
+    if (lines.size() <= drawRow) {
         return;
     }
 
@@ -367,7 +435,13 @@ RichTextImage::RichTextImage(std::string url, float width, float height,
     image->setCornerRadius(4);
     image->setScalingType(brls::ImageScalingType::FIT);
 
-    if (autoLoad) ImageHelper::with(image)->load(this->url);
+    if (autoLoad) this->load();
+}
+
+void RichTextImage::load() {
+    if (loaded) return;
+    loaded = true;
+    ImageHelper::with(image)->load(this->url);
 }
 
 RichTextImage::~RichTextImage() {
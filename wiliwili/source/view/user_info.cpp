@@ -8,10 +8,11 @@
 #include "view/user_info.hpp"
 #include "view/svg_image.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 
 UserInfoView::UserInfoView() {
-    this->inflateFromXMLRes("xml/views/user_info.xml");
+    XMLLayout::inflate(this, "xml/views/user_info.xml");
     this->registerColorXMLAttribute(
         "mainTextColor",
         [this](NVGcolor value) { this->setMainTextColor(value); });
@@ -7,6 +7,7 @@
 #include "view/text_box.hpp"
 #include "utils/number_helper.hpp"
 #include "utils/image_helper.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -25,7 +26,7 @@ void BaseVideoCard::cacheForReuse() {
 /// 普通视频封面
 
 RecyclingGridItemVideoCard::RecyclingGridItemVideoCard() {
-    this->inflateFromXMLRes("xml/views/video_card.xml");
+    XMLLayout::inflate(this, "xml/views/video_card.xml");
 }
 
 RecyclingGridItemVideoCard::~RecyclingGridItemVideoCard() {
@@ -104,7 +105,7 @@ void RecyclingGridItemVideoCard::setCard(std::string pic, std::string title,
 
 RecyclingGridItemRankVideoCard::RecyclingGridItemRankVideoCard(
     std::string res) {
-    this->inflateFromXMLRes(res);
+    XMLLayout::inflate(this, res);
 }
 
 RecyclingGridItemRankVideoCard::~RecyclingGridItemRankVideoCard() {
@@ -164,7 +165,7 @@ RecyclingGridItemRankVideoCard* RecyclingGridItemRankVideoCard::create(
 /// 直播视频封面
 
 RecyclingGridItemLiveVideoCard::RecyclingGridItemLiveVideoCard() {
-    this->inflateFromXMLRes("xml/views/video_card_live.xml");
+    XMLLayout::inflate(this, "xml/views/video_card_live.xml");
 }
 
 RecyclingGridItemLiveVideoCard::~RecyclingGridItemLiveVideoCard() {
@@ -201,7 +202,7 @@ RecyclingGridItemLiveVideoCard* RecyclingGridItemLiveVideoCard::create() {
 RecyclingGridItemPGCVideoCard::RecyclingGridItemPGCVideoCard(
     bool vertical_cover)
     : vertical_cover(vertical_cover) {
-    this->inflateFromXMLRes("xml/views/video_card_pgc.xml");
+    XMLLayout::inflate(this, "xml/views/video_card_pgc.xml");
     if (!vertical_cover) {
         this->boxPic->setHeightPercentage(70);
         this->boxBadgeBottom->setHeightPercentage(20);
@@ -251,7 +252,7 @@ RecyclingGridItemPGCVideoCard* RecyclingGridItemPGCVideoCard::create(
 
 /// 搜索 番剧 和 影视 卡片
 RecyclingGridItemSearchPGCVideoCard::RecyclingGridItemSearchPGCVideoCard() {
-    this->inflateFromXMLRes("xml/views/video_card_search_pgc.xml");
+    XMLLayout::inflate(this, "xml/views/video_card_search_pgc.xml");
 }
 
 RecyclingGridItemSearchPGCVideoCard::~RecyclingGridItemSearchPGCVideoCard() {
@@ -301,7 +302,7 @@ RecyclingGridItem* RecyclingGridItemSearchPGCVideoCard::create() {
 RecyclingGridItemViewMoreCard::RecyclingGridItemViewMoreCard(
     bool vertical_cover)
     : vertical_cover(vertical_cover) {
-    this->inflateFromXMLRes("xml/views/video_card_pgc_more.xml");
+    XMLLayout::inflate(this, "xml/views/video_card_pgc_more.xml");
 }
 
 RecyclingGridItemViewMoreCard::~RecyclingGridItemViewMoreCard() {}
@@ -321,7 +322,7 @@ RecyclingGridItem* RecyclingGridItemViewMoreCard::create(bool vertical_cover) {
 /// 历史记录 视频卡片
 
 RecyclingGridItemHistoryVideoCard::RecyclingGridItemHistoryVideoCard() {
-    this->inflateFromXMLRes("xml/views/video_card_history.xml");
+    XMLLayout::inflate(this, "xml/views/video_card_history.xml");
 }
 
 RecyclingGridItemHistoryVideoCard::~RecyclingGridItemHistoryVideoCard() {
@@ -401,7 +402,7 @@ void RecyclingGridItemHistoryVideoCard::setCard(
 /// 收藏夹 卡片
 
 RecyclingGridItemCollectionVideoCard::RecyclingGridItemCollectionVideoCard() {
-    this->inflateFromXMLRes("xml/views/video_card_collection.xml");
+    XMLLayout::inflate(this, "xml/views/video_card_collection.xml");
 }
 
 RecyclingGridItemCollectionVideoCard::~RecyclingGridItemCollectionVideoCard() {
@@ -430,7 +431,7 @@ void RecyclingGridItemCollectionVideoCard::setCard(
 /// 播放页推荐 卡片
 
 RecyclingGridItemRelatedVideoCard::RecyclingGridItemRelatedVideoCard() {
-    this->inflateFromXMLRes("xml/views/video_card_related.xml");
+    XMLLayout::inflate(this, "xml/views/video_card_related.xml");
 }
 
 RecyclingGridItemRelatedVideoCard::~RecyclingGridItemRelatedVideoCard() {
@@ -461,7 +462,7 @@ void RecyclingGridItemRelatedVideoCard::setCard(std::string pic,
 
 RecyclingGridItemSeasonSeriesVideoCard::
     RecyclingGridItemSeasonSeriesVideoCard() {
-    this->inflateFromXMLRes("xml/views/video_card_series.xml");
+    XMLLayout::inflate(this, "xml/views/video_card_series.xml");
 }
 
 RecyclingGridItemSeasonSeriesVideoCard::
@@ -8,6 +8,7 @@
 #include "utils/number_helper.hpp"
 #include "utils/string_helper.hpp"
 #include "bilibili.h"
+#include "utils/xml_layout.hpp"
 
 using namespace brls::literals;
 
@@ -84,7 +85,7 @@ typedef std::unordered_map<std::string, std::shared_ptr<CommentElement>> CEMap;
 
 VideoComment::VideoComment() {
     brls::Logger::verbose("View VideoComment: create");
-    this->inflateFromXMLRes("xml/views/video_comment.xml");
+    XMLLayout::inflate(this, "xml/views/video_comment.xml");
 
     this->registerColorXMLAttribute("mainTextColor", [this](NVGcolor value) {
         this->setMainTextColor(value);
@@ -109,25 +110,37 @@ void VideoComment::setMaxRows(size_t value) {
     this->commentContent->setMaxRows(value);
 }
 
-void VideoComment::setData(bilibili::VideoCommentResult data) {
-    this->comment_data = data;
+/// 文字片段
+static CommentContentPart textPart(
+    std::string text,
+    CommentContentPart::Color color = CommentContentPart::Color::TEXT) {
+    CommentContentPart part;
+    part.value = std::move(text);
+    part.color = color;
+    return part;
+}
 
-    std::string subtitle = wiliwili::sec2date(data.ctime);
-    if (!data.reply_control.location.empty()) {
-        subtitle += "  " + data.reply_control.location;
-    }
+/// 图片片段
+static CommentContentPart imagePart(std::string url, float width,
+                                    float height) {
+    CommentContentPart part;
+    part.image  = true;
+    part.value  = std::move(url);
+    part.width  = width;
+    part.height = height;
+    return part;
+}
 
+CommentContent VideoComment::parseContent(
+    const bilibili::VideoCommentResult& data) {
+    using Color = CommentContentPart::Color;
     // 结尾加个空格用来正确识别尾部的@
-    RichTextData d;
-    std::string msg    = data.content.message + " ";
-    auto theme         = brls::Application::getTheme();
-    NVGcolor textColor = theme.getColor("brls/text");
-    NVGcolor linkColor = theme.getColor("color/link");
-    NVGcolor biliColor = theme.getColor("color/bilibili");
+    CommentContent d;
+    std::string msg = data.content.message + " ";
 
     if (data.top) {
-        auto top      = std::make_shared<RichTextSpan>("置顶", biliColor);
-        top->r_margin = 10;
+        auto top     = textPart("置顶", Color::BILIBILI);
+        top.r_margin = 10;
         d.emplace_back(top);
     }
 
@@ -175,59 +188,54 @@ void VideoComment::setData(bilibili::VideoCommentResult data) {
         if (matchElement == nullptr) nextMatch = msg.length() - 1;
         if (start < nextMatch) {
             // 纯文本
-            auto item = std::make_shared<RichTextSpan>(
-                msg.substr(start, nextMatch - start) + "\r", textColor);
-            d.emplace_back(item);
+            d.emplace_back(
+                textPart(msg.substr(start, nextMatch - start) + "\r"));
         }
         if (matchElement == nullptr) break;
         // 根据 matchElement 类型判断
         switch (matchElement->type) {
             case CommentElementType::EMOTE: {
                 auto* t = (CommentElementEmote*)matchElement.get();
-                std::shared_ptr<RichTextImage> item;
+                CommentContentPart item;
                 if (t->size == 2) {
-                    item = std::make_shared<RichTextImage>(
-                        t->url + ImageHelper::emoji_size2_ext, 50, 50);
-                    item->t_margin = 4;
+                    item = imagePart(t->url + ImageHelper::emoji_size2_ext,
+                                     50, 50);
+                    item.t_margin = 4;
                 } else {
-                    item = std::make_shared<RichTextImage>(
-                        t->url + ImageHelper::emoji_size1_ext, 30, 30);
+                    item = imagePart(t->url + ImageHelper::emoji_size1_ext,
+                                     30, 30);
                 }
-                item->v_align  = 4;
-                item->l_margin = 2;
-                item->r_margin = 2;
+                item.v_align  = 4;
+                item.l_margin = 2;
+                item.r_margin = 2;
                 d.emplace_back(item);
                 break;
             }
             case CommentElementType::USER: {
-                auto* t   = (CommentElementUser*)matchElement.get();
-                auto item = std::make_shared<RichTextSpan>(t->title, linkColor);
-                item->l_margin = 8;
-                item->r_margin = 8;
+                auto* t       = (CommentElementUser*)matchElement.get();
+                auto item     = textPart(t->title, Color::LINK);
+                item.l_margin = 8;
+                item.r_margin = 8;
                 d.emplace_back(item);
                 break;
             }
             case CommentElementType::TOPIC: {
-                auto* t   = (CommentElementTopic*)matchElement.get();
-                auto item = std::make_shared<RichTextSpan>(t->title, linkColor);
-                d.emplace_back(item);
+                auto* t = (CommentElementTopic*)matchElement.get();
+                d.emplace_back(textPart(t->title, Color::LINK));
                 break;
             }
             case CommentElementType::JUMP: {
                 auto* t = (CommentElementJump*)matchElement.get();
                 if (!t->icon.empty() && t->position == 0) {
-                    auto item =
-                        std::make_shared<RichTextImage>(t->icon, 30, 30);
-                    item->v_align = 5;
+                    auto item    = imagePart(t->icon, 30, 30);
+                    item.v_align = 5;
                     d.emplace_back(item);
                 }
-                d.emplace_back(
-                    std::make_shared<RichTextSpan>(t->showTitle, linkColor));
+                d.emplace_back(textPart(t->showTitle, Color::LINK));
                 if (!t->icon.empty() && t->position == 1) {
-                    auto item =
-                        std::make_shared<RichTextImage>(t->icon, 16, 30);
-                    item->v_align  = 5;
-                    item->r_margin = 2;
+                    auto item     = imagePart(t->icon, 16, 30);
+                    item.v_align  = 5;
+                    item.r_margin = 2;
                     d.emplace_back(item);
                 }
                 // 关键字只匹配一次
@@ -244,7 +252,7 @@ void VideoComment::setData(bilibili::VideoCommentResult data) {
 
     // 笔记图片
     if (!data.content.pictures.empty())
-        d.emplace_back(std::make_shared<RichTextSpan>("\n\n", textColor));
+        d.emplace_back(textPart("\n\n"));
 
     static constexpr float size    = 108;
     static constexpr float maxSize = 324;
@@ -268,7 +276,7 @@ void VideoComment::setData(bilibili::VideoCommentResult data) {
             // gif 图片暂时按照 jpg 来解析
             custom_ext = custom_ext_jpg;
         }
-        auto item = std::make_shared<RichTextImage>(
+        auto item = imagePart(
             picture.img_src + wiliwili::format(custom_ext,
 #ifdef __PSV__
                                           (int)(w * 0.5), (int)(h * 0.5)),
@@ -276,21 +284,70 @@ void VideoComment::setData(bilibili::VideoCommentResult data) {
                                           (int)(w * 5), (int)(h * 5)),
 #endif
             w, h);
-        item->t_margin = 8;
+        item.t_margin = 8;
         d.emplace_back(item);
     } else {
         // 多张图片显示为正方形缩略图
         for (auto& picture : data.content.pictures) {
-            auto item = std::make_shared<RichTextImage>(
-                picture.img_src + ImageHelper::note_ext, size, size);
-            item->r_margin = 8;
-            item->t_margin = 8;
+            auto item =
+                imagePart(picture.img_src + ImageHelper::note_ext, size, size);
+            item.r_margin = 8;
+            item.t_margin = 8;
             d.emplace_back(item);
         }
     }
 
-    // 设置富文本
-    this->commentContent->setRichText(d);
+    return d;
+}
+
+RichTextData VideoComment::buildContent(const CommentContent& content) {
+    auto theme         = brls::Application::getTheme();
+    NVGcolor textColor = theme.getColor("brls/text");
+    NVGcolor linkColor = theme.getColor("color/link");
+    NVGcolor biliColor = theme.getColor("color/bilibili");
+
+    RichTextData d;
+    d.reserve(content.size());
+    for (auto& part : content) {
+        std::shared_ptr<RichTextComponent> item;
+        if (part.image) {
+            item = std::make_shared<RichTextImage>(part.value, part.width,
+                                                   part.height);
+        } else {
+            NVGcolor color = textColor;
+            if (part.color == CommentContentPart::Color::LINK)
+                color = linkColor;
+            else if (part.color == CommentContentPart::Color::BILIBILI)
+                color = biliColor;
+            item = std::make_shared<RichTextSpan>(part.value, color);
+        }
+        item->l_margin = part.l_margin;
+        item->r_margin = part.r_margin;
+        item->t_margin = part.t_margin;
+        item->v_align  = part.v_align;
+        d.emplace_back(item);
+    }
+    return d;
+}
+
+void VideoComment::setData(bilibili::VideoCommentResult data) {
+    this->comment_data = data;
+
+    std::string subtitle = wiliwili::sec2date(data.ctime);
+    if (!data.reply_control.location.empty()) {
+        subtitle += "  " + data.reply_control.location;
+    }
+
+    // 列表项被复用时显示的是同一条评论，无需重新解析与排版
+    uint64_t contentId = CommentCache::getContentId(data);
+    if (this->commentContent->getContentId() != contentId) {
+        // 优先使用在后台预先解析的内容
+        auto content = CommentCache::instance().getContent(data);
+        if (!content)
+            content =
+                std::make_shared<const CommentContent>(parseContent(data));
+        this->commentContent->setRichText(buildContent(*content), contentId);
+    }
 
     this->userInfo->setUserInfo(data.member.avatar + ImageHelper::face_ext,
                                 data.member.uname, subtitle);
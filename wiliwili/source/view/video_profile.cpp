@@ -4,9 +4,10 @@
 
 #include "view/video_profile.hpp"
 #include "view/mpv_core.hpp"
+#include "utils/xml_layout.hpp"
 
 VideoProfile::VideoProfile() {
-    this->inflateFromXMLRes("xml/views/video_profile.xml");
+    XMLLayout::inflate(this, "xml/views/video_profile.xml");
     brls::Logger::debug("View VideoProfile: create");
 }
 
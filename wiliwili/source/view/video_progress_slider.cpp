@@ -2,6 +2,7 @@
 // Created by fang on 2022/8/15.
 //
 
+#include <cmath>
 #include "view/video_progress_slider.hpp"
 #include "view/svg_image.hpp"
 
@@ -108,10 +109,16 @@ void VideoProgressSlider::setProgress(float progress) {
         Application::getAudioPlayer()->play(SOUND_SLIDER_TICK);
     }
 
+    // 进度条位置变化不足半个像素时不需要重新布局
+    float paddingWidth = getWidth() - pointer->getWidth();
+    if (fabs((this->progress - lastLayoutProgress) * paddingWidth) < 0.5f)
+        return;
+
     updateUI();
 }
 
 void VideoProgressSlider::updateUI() {
+    lastLayoutProgress = progress;
     float paddingWidth   = getWidth() - pointer->getWidth();
     float lineStart      = pointer->getWidth() / 2;
     float lineStartWidth = paddingWidth * progress;
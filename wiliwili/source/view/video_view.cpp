@@ -16,11 +16,16 @@
 #include "view/danmaku_core.hpp"
 #include "utils/number_helper.hpp"
 #include "utils/config_helper.hpp"
+#include "utils/frame_scheduler.hpp"
+#include "utils/trace_helper.hpp"
+#include "utils/media_proxy.hpp"
+#include "utils/download_manager.hpp"
 #include "utils/string_helper.hpp"
 #include "activity/player_activity.hpp"
 #include "fragment/player_danmaku_setting.hpp"
 #include "fragment/player_setting.hpp"
 #include "fragment/player_dlna_search.hpp"
+#include "utils/xml_layout.hpp"
 
 using namespace brls;
 
@@ -32,6 +37,12 @@ enum ClickState {
     CLICK_DOUBLE = 5
 };
 
+/// 文字不变时不修改 Label，避免重新计算布局
+static void updateLabel(brls::Label* label, const std::string& value) {
+    if (label->getFullText() == value) return;
+    label->setText(value);
+}
+
 static int64_t getSeekRange(int64_t current) {
     current = abs(current);
     if (current < 60) return 5;
@@ -43,8 +54,10 @@ static int64_t getSeekRange(int64_t current) {
 
 VideoView::VideoView() {
     mpvCore = &MPVCore::instance();
-    this->inflateFromXMLRes("xml/views/video_view.xml");
+    XMLLayout::inflate(this, "xml/views/video_view.xml");
     this->setHideHighlightBackground(true);
+    osdTopBox->setVisibility(brls::Visibility::INVISIBLE);
+    osdBottomBox->setVisibility(brls::Visibility::INVISIBLE);
     this->setHideClickAnimation(true);
 
     input = brls::Application::getPlatform()->getInputManager();
@@ -536,10 +549,14 @@ VideoView::~VideoView() {
 void VideoView::draw(NVGcontext* vg, float x, float y, float width,
                      float height, Style style, FrameContext* ctx) {
     if (!mpvCore->isValid()) return;
+    TRACE_SCOPE("video", "VideoView::draw");
     float alpha = this->getAlpha();
 
     // draw video
-    mpvCore->draw(brls::Rect(x, y, width, height), alpha);
+    {
+        TRACE_SCOPE("video", "MPVCore::draw");
+        mpvCore->draw(brls::Rect(x, y, width, height), alpha);
+    }
 
     // draw bottom bar
     if (BOTTOM_BAR && showBottomLineSetting) {
@@ -560,14 +577,18 @@ void VideoView::draw(NVGcontext* vg, float x, float y, float width,
     // draw osd
     time_t current = wiliwili::unix_time();
     if (current < this->osdLastShowTime) {
+        // 只在显示状态切换时修改可见性，setVisibility 会遍历整个 OSD 子树
         if (!is_osd_shown) {
             is_osd_shown = true;
+            osdTopBox->setVisibility(brls::Visibility::VISIBLE);
+            osdBottomBox->setVisibility(brls::Visibility::VISIBLE);
             this->onOSDStateChanged(true);
         }
-        osdTopBox->setVisibility(brls::Visibility::VISIBLE);
-        osdBottomBox->setVisibility(brls::Visibility::VISIBLE);
-        osdBottomBox->frame(ctx);
-        osdTopBox->frame(ctx);
+        {
+            TRACE_SCOPE("video", "VideoView::drawOSD");
+            osdBottomBox->frame(ctx);
+            osdTopBox->frame(ctx);
+        }
 
         // draw subtitle (upon osd)
         if (showSubtitleSetting)
@@ -576,10 +597,10 @@ void VideoView::draw(NVGcontext* vg, float x, float y, float width,
     } else {
         if (is_osd_shown) {
             is_osd_shown = false;
+            osdTopBox->setVisibility(brls::Visibility::INVISIBLE);
+            osdBottomBox->setVisibility(brls::Visibility::INVISIBLE);
             this->onOSDStateChanged(false);
         }
-        osdTopBox->setVisibility(brls::Visibility::INVISIBLE);
-        osdBottomBox->setVisibility(brls::Visibility::INVISIBLE);
 
         // draw subtitle (without osd)
         if (showSubtitleSetting)
@@ -621,6 +642,7 @@ void VideoView::draw(NVGcontext* vg, float x, float y, float width,
             nvgClosePath(vg);
             nvgFill(vg);
         }
+        FrameScheduler::instance().requestFrame();
     }
 
     // cache info
@@ -670,7 +692,16 @@ void VideoView::setUrl(const std::string& url, int progress,
 
 void VideoView::setUrl(const std::string& url, int progress,
                        const std::vector<std::string>& audios) {
-    mpvCore->setUrl(url, genExtraUrlParam(progress, audios));
+    // 离线缓存的文件直接播放
+    if (isLiveMode || MediaProxy::CACHE_SIZE <= 0 ||
+        DownloadManager::isLocalUrl(url)) {
+        mpvCore->setUrl(url, genExtraUrlParam(progress, audios));
+        return;
+    }
+    // 通过本地代理播放，已播放过的部分直接从磁盘缓存读取
+    proxyUrl = MediaProxy::instance().getProxyUrl(url);
+    mpvCore->setUrl(proxyUrl,
+                    genExtraUrlParam(progress, getProxyAudioUrl(audios)));
 }
 
 void VideoView::setBackupUrl(const std::string& url, int progress,
@@ -680,7 +711,28 @@ void VideoView::setBackupUrl(const std::string& url, int progress,
 
 void VideoView::setBackupUrl(const std::string& url, int progress,
                              const std::vector<std::string>& audios) {
-    mpvCore->setBackupUrl(url, genExtraUrlParam(progress, audios));
+    if (isLiveMode || MediaProxy::CACHE_SIZE <= 0) {
+        mpvCore->setBackupUrl(url, genExtraUrlParam(progress, audios));
+        return;
+    }
+    // 备用链接与主链接路径相同时，作为代理的镜像使用，无需再添加到播放列表
+    std::string backupUrl = MediaProxy::instance().getProxyUrl(url, false);
+    if (backupUrl == proxyUrl) return;
+    mpvCore->setBackupUrl(backupUrl,
+                          genExtraUrlParam(progress, getProxyAudioUrl(audios)));
+}
+
+std::vector<std::string> VideoView::getProxyAudioUrl(
+    const std::vector<std::string>& audios) {
+    // 同一音频的不同镜像只保留一个代理链接
+    std::vector<std::string> res;
+    for (size_t i = 0; i < audios.size(); i++) {
+        std::string proxyUrl =
+            MediaProxy::instance().getProxyUrl(audios[i], i == 0);
+        if (std::find(res.begin(), res.end(), proxyUrl) == res.end())
+            res.emplace_back(proxyUrl);
+    }
+    return res;
 }
 
 void VideoView::setUrl(const std::vector<EDLUrl>& edl_urls, int progress) {
@@ -693,14 +745,17 @@ void VideoView::setUrl(const std::vector<EDLUrl>& edl_urls, int progress) {
             break;
         }
     }
+    bool useProxy = !isLiveMode && MediaProxy::CACHE_SIZE > 0;
     for (auto& i : edl_urls) {
+        std::string segment =
+            useProxy ? MediaProxy::instance().getProxyUrl(i.url) : i.url;
         if (!delay_open) {
-            urls.emplace_back(fmt::format("%{}%{}", i.url.size(), i.url));
+            urls.emplace_back(fmt::format("%{}%{}", segment.size(), segment));
             continue;
         }
         urls.emplace_back(
             "!delay_open,media_type=video;!delay_open,media_type=audio;" +
-            fmt::format("%{}%{},length={}", i.url.size(), i.url, i.length));
+            fmt::format("%{}%{},length={}", segment.size(), segment, i.length));
     }
     url += pystring::join(";", urls);
     this->setUrl(url, progress);
@@ -828,11 +883,11 @@ void VideoView::setLiveMode() {
 }
 
 void VideoView::setStatusLabelLeft(const std::string& value) {
-    leftStatusLabel->setText(value);
+    updateLabel(leftStatusLabel, value);
 }
 
 void VideoView::setStatusLabelRight(const std::string& value) {
-    rightStatusLabel->setText(value);
+    updateLabel(rightStatusLabel, value);
 }
 
 void VideoView::disableCloseOnEndOfFile() { closeOnEndOfFile = false; }
@@ -870,13 +925,13 @@ std::string VideoView::getQuality() {
 }
 
 void VideoView::setDuration(const std::string& value) {
-    this->rightStatusLabel->setText(value);
+    updateLabel(this->rightStatusLabel, value);
 }
 
 void VideoView::setPlaybackTime(const std::string& value) {
     if (this->is_seeking) return;
     if (this->isLiveMode) return;
-    this->leftStatusLabel->setText(value);
+    updateLabel(this->leftStatusLabel, value);
 }
 
 void VideoView::setFullscreenIcon(bool fs) {
@@ -1216,7 +1271,7 @@ void VideoView::registerMpvEvent() {
                             brls::Visibility::VISIBLE)
                             this->centerLabel->setVisibility(
                                 brls::Visibility::VISIBLE);
-                        this->centerLabel->setText(mpvCore->getCacheSpeed());
+                        updateLabel(this->centerLabel, mpvCore->getCacheSpeed());
                     }
                     break;
                 case MpvEventEnum::VIDEO_MUTE: